@@ -0,0 +1,83 @@
+#.rst:
+# FindLZ4
+# -------
+#
+# Finds the LZ4 library
+#
+# This will define the following variables::
+#
+#   LZ4_FOUND - True if the system has the LZ4 library
+#
+# and the following imported targets::
+#
+#   lib::lz4  - The LZ4 library
+
+# ***************************************************************************
+# *   Copyright 2026 Robotics Erlangen e.V.                                 *
+# *   Robotics Erlangen e.V.                                                *
+# *   http://www.robotics-erlangen.de/                                      *
+# *   info@robotics-erlangen.de                                             *
+# *                                                                         *
+# *   This program is free software: you can redistribute it and/or modify  *
+# *   it under the terms of the GNU General Public License as published by  *
+# *   the Free Software Foundation, either version 3 of the License, or     *
+# *   any later version.                                                    *
+# *                                                                         *
+# *   This program is distributed in the hope that it will be useful,       *
+# *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+# *   GNU General Public License for more details.                          *
+# *                                                                         *
+# *   You should have received a copy of the GNU General Public License     *
+# *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+# ***************************************************************************
+
+find_path(LZ4_INCLUDE_DIR
+  NAMES lz4.h
+  HINTS $ENV{LZ4_DIR}
+  PATH_SUFFIXES include
+  PATHS
+    ~/Library/Frameworks
+    /Library/Frameworks
+    /usr/local
+    /usr
+    /sw # Fink
+    /opt/local # DarwinPorts
+    /opt/csw # Blastwave
+    /opt
+)
+
+find_library(LZ4_LIBRARY
+  NAMES lz4
+  HINTS $ENV{LZ4_DIR}
+  PATH_SUFFIXES lib64 lib
+  PATHS
+    ~/Library/Frameworks
+    /Library/Frameworks
+    /usr/local
+    /usr
+    /sw
+    /opt/local
+    /opt/csw
+    /opt
+)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(LZ4
+  FOUND_VAR LZ4_FOUND
+  REQUIRED_VARS
+    LZ4_LIBRARY
+    LZ4_INCLUDE_DIR
+)
+mark_as_advanced(
+  LZ4_INCLUDE_DIR
+  LZ4_LIBRARY
+)
+
+if(LZ4_FOUND)
+  add_library(lib::lz4 UNKNOWN IMPORTED)
+  set_target_properties(lib::lz4 PROPERTIES
+    IMPORTED_LOCATION "${LZ4_LIBRARY}"
+    INTERFACE_INCLUDE_DIRECTORIES "${LZ4_INCLUDE_DIR}"
+  )
+endif()
@@ -0,0 +1,83 @@
+#.rst:
+# FindZstd
+# -------
+#
+# Finds the Zstandard library
+#
+# This will define the following variables::
+#
+#   ZSTD_FOUND - True if the system has the Zstandard library
+#
+# and the following imported targets::
+#
+#   lib::zstd  - The Zstandard library
+
+# ***************************************************************************
+# *   Copyright 2026 Robotics Erlangen e.V.                                 *
+# *   Robotics Erlangen e.V.                                                *
+# *   http://www.robotics-erlangen.de/                                      *
+# *   info@robotics-erlangen.de                                             *
+# *                                                                         *
+# *   This program is free software: you can redistribute it and/or modify  *
+# *   it under the terms of the GNU General Public License as published by  *
+# *   the Free Software Foundation, either version 3 of the License, or     *
+# *   any later version.                                                    *
+# *                                                                         *
+# *   This program is distributed in the hope that it will be useful,       *
+# *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+# *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+# *   GNU General Public License for more details.                          *
+# *                                                                         *
+# *   You should have received a copy of the GNU General Public License     *
+# *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+# ***************************************************************************
+
+find_path(ZSTD_INCLUDE_DIR
+  NAMES zstd.h
+  HINTS $ENV{ZSTD_DIR}
+  PATH_SUFFIXES include
+  PATHS
+    ~/Library/Frameworks
+    /Library/Frameworks
+    /usr/local
+    /usr
+    /sw # Fink
+    /opt/local # DarwinPorts
+    /opt/csw # Blastwave
+    /opt
+)
+
+find_library(ZSTD_LIBRARY
+  NAMES zstd
+  HINTS $ENV{ZSTD_DIR}
+  PATH_SUFFIXES lib64 lib
+  PATHS
+    ~/Library/Frameworks
+    /Library/Frameworks
+    /usr/local
+    /usr
+    /sw
+    /opt/local
+    /opt/csw
+    /opt
+)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(Zstd
+  FOUND_VAR ZSTD_FOUND
+  REQUIRED_VARS
+    ZSTD_LIBRARY
+    ZSTD_INCLUDE_DIR
+)
+mark_as_advanced(
+  ZSTD_INCLUDE_DIR
+  ZSTD_LIBRARY
+)
+
+if(ZSTD_FOUND)
+  add_library(lib::zstd UNKNOWN IMPORTED)
+  set_target_properties(lib::zstd PROPERTIES
+    IMPORTED_LOCATION "${ZSTD_LIBRARY}"
+    INTERFACE_INCLUDE_DIRECTORIES "${ZSTD_INCLUDE_DIR}"
+  )
+endif()
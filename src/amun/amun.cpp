@@ -465,6 +465,9 @@ void Amun::handleCommandLocally(const Command &command)
 
         if (sim.has_simulator_setup()) {
             m_simulator->blockSignals(true);
+            // the radio commands are passed directly, the connection must be gone before the
+            // simulator thread deletes the simulator
+            m_commandConverter->disconnect(m_simulator);
             m_simulator->deleteLater();
             m_timer->reset();
             createSimulator(sim.simulator_setup());
@@ -674,8 +677,8 @@ void Amun::setSimulatorEnabled(bool enabled, bool useNetworkTransceiver)
     if (enabled || useNetworkTransceiver) {
         connect(m_processor, &Processor::sendRadioCommands, m_commandConverter, &CommandConverter::handleRadioCommands);
         if (enabled) {
-            // simulator setup
-            connect(m_commandConverter, &CommandConverter::sendSSLSim, m_simulator, &Simulator::handleRadioCommands);
+            // simulator setup, the commands are passed to the simulator thread without an event
+            connect(m_commandConverter, &CommandConverter::sendSSLSim, m_simulator, &Simulator::handleRadioCommands, Qt::DirectConnection);
         } else {
             // network transceiver setup
             connect(m_commandConverter, &CommandConverter::sendSSLSim, m_networkTransceiver, &NetworkTransceiver::handleSSLSimCommand);
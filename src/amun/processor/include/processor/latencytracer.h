@@ -0,0 +1,86 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef LATENCYTRACER_H
+#define LATENCYTRACER_H
+
+#include <QString>
+#include <QtGlobal>
+#include <deque>
+#include <vector>
+
+namespace amun { class Timing; }
+
+// Follows every vision frame from its arrival at the receiver until the
+// radio commands computed with it are sent.
+// All stage timestamps use a monotonic clock, in nanoseconds.
+class LatencyTracer
+{
+public:
+    struct Trace
+    {
+        quint64 id;
+        qint64 received;
+        qint64 queued;
+        qint64 processingStart;
+        qint64 tracked;
+        qint64 sent;
+    };
+
+    enum Stage
+    {
+        ReceiveToQueue,
+        QueueToProcessing,
+        Tracking,
+        Controller,
+        Total,
+        StageCount
+    };
+
+public:
+    explicit LatencyTracer(std::size_t historySize = 3000);
+
+    static qint64 monotonicTime();
+    static const char *stageName(Stage stage);
+    static qint64 stageDuration(const Trace &trace, Stage stage);
+    // converts a duration measured with a scaled Timer to wall clock time,
+    // the timer must have run with the given scaling during the whole duration
+    static qint64 wallClockDuration(qint64 timerDuration, double scaling);
+
+    // receiveDelay is the wall clock time elapsed since the receiver got the frame
+    void frameQueued(qint64 receiveDelay, qint64 now);
+    void processingStarted(qint64 now);
+    void trackingFinished(qint64 now);
+    void radioCommandsSent(qint64 now);
+
+    // adds p50, p99 and max of every stage over the trace history
+    void fillHistograms(amun::Timing *timing) const;
+    bool dump(const QString &filename) const;
+    const std::deque<Trace>& history() const { return m_history; }
+
+private:
+    const std::size_t m_historySize;
+    quint64 m_nextId = 0;
+    std::vector<Trace> m_queued;
+    std::vector<Trace> m_processing;
+    std::deque<Trace> m_history;
+};
+
+#endif // LATENCYTRACER_H
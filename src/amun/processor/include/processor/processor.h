@@ -21,6 +21,7 @@
 #ifndef PROCESSOR_H
 #define PROCESSOR_H
 
+#include "latencytracer.h"
 #include "protobuf/command.h"
 #include "protobuf/robotcommand.h"
 #include "protobuf/ssl_mixed_team.pb.h"
@@ -142,6 +143,11 @@ private:
 
     bool m_transceiverEnabled;
 
+    // only live vision data is traced, replays have no meaningful receive times
+    const bool m_latencyTracingEnabled;
+    LatencyTracer m_latencyTracer;
+    int m_latencyPublishCounter = 0;
+
     world::DivisionDimensions m_divisionDimensions;
 };
 
@@ -0,0 +1,176 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "latencytracer.h"
+#include "protobuf/status.pb.h"
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <chrono>
+
+/*!
+ * \class LatencyTracer
+ * \ingroup processor
+ * \brief Per frame latency tracing from vision receive to radio send
+ *
+ * Every queued vision frame gets a trace id. Frames queued before a processing
+ * step are completed together, once the radio commands of that step were sent.
+ * Only the last historySize traces are kept.
+ */
+
+LatencyTracer::LatencyTracer(std::size_t historySize) :
+    m_historySize(historySize)
+{ }
+
+qint64 LatencyTracer::monotonicTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char *LatencyTracer::stageName(Stage stage)
+{
+    switch (stage) {
+    case ReceiveToQueue:
+        return "receive to queue";
+    case QueueToProcessing:
+        return "queue to processing";
+    case Tracking:
+        return "tracking";
+    case Controller:
+        return "controller";
+    case Total:
+        return "total";
+    case StageCount:
+        break;
+    }
+    return "";
+}
+
+qint64 LatencyTracer::stageDuration(const Trace &trace, Stage stage)
+{
+    switch (stage) {
+    case ReceiveToQueue:
+        return trace.queued - trace.received;
+    case QueueToProcessing:
+        return trace.processingStart - trace.queued;
+    case Tracking:
+        return trace.tracked - trace.processingStart;
+    case Controller:
+        return trace.sent - trace.tracked;
+    case Total:
+        return trace.sent - trace.received;
+    case StageCount:
+        break;
+    }
+    return 0;
+}
+
+qint64 LatencyTracer::wallClockDuration(qint64 timerDuration, double scaling)
+{
+    // the time does not advance while paused, there is no meaningful wall clock duration
+    if (scaling <= 0) {
+        return 0;
+    }
+    return qint64(timerDuration / scaling);
+}
+
+void LatencyTracer::frameQueued(qint64 receiveDelay, qint64 now)
+{
+    // the receiver uses a different clock, thus only the elapsed time is transferred
+    const qint64 received = now - std::max(receiveDelay, qint64(0));
+    m_queued.push_back({m_nextId++, received, now, 0, 0, 0});
+}
+
+void LatencyTracer::processingStarted(qint64 now)
+{
+    // frames queued during processing are handled in the next step
+    m_processing.swap(m_queued);
+    m_queued.clear();
+    for (Trace &trace : m_processing) {
+        trace.processingStart = now;
+    }
+}
+
+void LatencyTracer::trackingFinished(qint64 now)
+{
+    for (Trace &trace : m_processing) {
+        trace.tracked = now;
+    }
+}
+
+void LatencyTracer::radioCommandsSent(qint64 now)
+{
+    for (Trace &trace : m_processing) {
+        trace.sent = now;
+        m_history.push_back(trace);
+    }
+    m_processing.clear();
+
+    while (m_history.size() > m_historySize) {
+        m_history.pop_front();
+    }
+}
+
+void LatencyTracer::fillHistograms(amun::Timing *timing) const
+{
+    if (m_history.empty()) {
+        return;
+    }
+
+    std::vector<qint64> durations(m_history.size());
+    for (int s = 0; s < StageCount; s++) {
+        const Stage stage = static_cast<Stage>(s);
+        std::transform(m_history.begin(), m_history.end(), durations.begin(),
+                       [stage](const Trace &trace) { return stageDuration(trace, stage); });
+
+        const std::size_t p50Index = durations.size() / 2;
+        const std::size_t p99Index = std::min(durations.size() - 1, durations.size() * 99 / 100);
+        std::nth_element(durations.begin(), durations.begin() + p50Index, durations.end());
+        const qint64 p50 = durations[p50Index];
+        // the elements after the p50 are all at least as large
+        std::nth_element(durations.begin() + p50Index, durations.begin() + p99Index, durations.end());
+        const qint64 p99 = durations[p99Index];
+        const qint64 max = *std::max_element(durations.begin() + p99Index, durations.end());
+
+        amun::LatencyHistogram *histogram = timing->add_vision_latency();
+        histogram->set_stage(stageName(stage));
+        histogram->set_samples(durations.size());
+        histogram->set_p50(p50 * 1E-9f);
+        histogram->set_p99(p99 * 1E-9f);
+        histogram->set_max(max * 1E-9f);
+    }
+}
+
+bool LatencyTracer::dump(const QString &filename) const
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+
+    QTextStream stream(&file);
+    stream << "id,received,queued,processing_start,tracked,sent\n";
+    for (const Trace &trace : m_history) {
+        stream << trace.id << ',' << trace.received << ',' << trace.queued << ',' << trace.processingStart
+               << ',' << trace.tracked << ',' << trace.sent << '\n';
+    }
+    stream.flush();
+    return stream.status() == QTextStream::Ok;
+}
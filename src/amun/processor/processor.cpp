@@ -133,7 +133,8 @@ Processor::Processor(const Timer *timer, bool isReplay) :
     m_refereeInternalActive(isReplay),
     m_lastFlipped(false),
     m_gameController(new InternalGameController(timer)),
-    m_transceiverEnabled(isReplay)
+    m_transceiverEnabled(isReplay),
+    m_latencyTracingEnabled(!isReplay)
 {
     connect(m_worldParameters.get(), &WorldParameters::cameraUpdated, m_tracker.get(), &Tracker::updateCamera);
     connect(m_worldParameters.get(), &WorldParameters::cameraUpdated, m_simpleTracker.get(), &Tracker::updateCamera);
@@ -303,6 +304,9 @@ static world::Geometry::Division tryInferDivision(const ::SSL_Referee_TeamInfo &
 void Processor::process(qint64 overwriteTime)
 {
     const qint64 tracker_start = Timer::systemTime();
+    if (m_latencyTracingEnabled) {
+        m_latencyTracer.processingStarted(LatencyTracer::monotonicTime());
+    }
 
     // the controller runs with 100 Hz -> 10ms ticks
     const qint64 tickDuration = 1000 * 1000 * 1000 / FREQUENCY;
@@ -322,6 +326,9 @@ void Processor::process(qint64 overwriteTime)
     m_tracker->process(currentTime);
     m_speedTracker->process(currentTime);
     m_simpleTracker->process(currentTime);
+    if (m_latencyTracingEnabled) {
+        m_latencyTracer.trackingFinished(LatencyTracer::monotonicTime());
+    }
 
     Status status = assembleStatus(currentTime, false);
     injectAndClearDebugValues(currentTime, status);
@@ -409,11 +416,20 @@ void Processor::process(qint64 overwriteTime)
 
     // publish world state and timing information
     status->mutable_timing()->set_controller((Timer::systemTime() - controller_start) * 1E-9f);
+    // the histograms are expensive to compute, thus only publish them once per second
+    if (m_latencyTracingEnabled && ++m_latencyPublishCounter >= FREQUENCY) {
+        m_latencyPublishCounter = 0;
+        m_latencyTracer.fillHistograms(status->mutable_timing());
+    }
     emit sendStatus(status);
 
     if (m_transceiverEnabled) {
         emit sendRadioCommands(radio_commands_prio, currentTime);
     }
+    // without transceiver the frames are complete once the processing is done
+    if (m_latencyTracingEnabled) {
+        m_latencyTracer.radioCommandsSent(LatencyTracer::monotonicTime());
+    }
 
     m_worldParameters->finishProcessing();
 }
@@ -565,6 +581,12 @@ void Processor::handleVisionPacket(const QByteArray &data, qint64 time, QString
     if (wrapper.has_detection()) {
         const auto& detection = wrapper.detection();
 
+        if (m_latencyTracingEnabled) {
+            // the receive time is given in the scaled time of the timer
+            const qint64 receiveDelay = LatencyTracer::wallClockDuration(m_timer->currentTime() - time, m_timer->scaling());
+            m_latencyTracer.frameQueued(receiveDelay, LatencyTracer::monotonicTime());
+        }
+
         m_tracker->queuePacket(detection, time);
         m_speedTracker->queuePacket(detection, time);
         m_simpleTracker->queuePacket(detection, time);
@@ -648,6 +670,19 @@ void Processor::handleCommand(const Command &command)
         m_speedTracker->handleCommand(command->tracking(), currentTime);
         m_simpleTracker->handleCommand(command->tracking(), currentTime);
 
+        if (command->tracking().has_dump_latency_trace()) {
+            const QString filename = QString::fromStdString(command->tracking().dump_latency_trace());
+            const QString message = m_latencyTracer.dump(filename) ? QString("Wrote latency trace to %1").arg(filename)
+                                                                   : QString("Could not write latency trace to %1").arg(filename);
+            Status status(new amun::Status);
+            amun::DebugValues *debug = status->add_debug();
+            debug->set_source(amun::Tracking);
+            amun::StatusLog *log = debug->add_log();
+            log->set_timestamp(currentTime);
+            log->set_text(message.toStdString());
+            emit sendStatus(status);
+        }
+
         if (command->tracking().has_radio_command_delay()) {
             m_trackingRadioCommandDelay = command->tracking().radio_command_delay();
         }
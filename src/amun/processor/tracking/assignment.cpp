@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "assignment.h"
+
+#include <cmath>
+#include <limits>
+
+std::vector<int> solveAssignment(const std::vector<float> &costs, int rows, int cols, float maxCost)
+{
+    std::vector<int> result(rows, -1);
+    if (rows == 0 || cols == 0) {
+        return result;
+    }
+
+    // every row gets an additional dummy column that represents leaving the row unassigned,
+    // thus there are always more columns than rows and each row has a feasible assignment
+    const int n = rows;
+    const int m = cols + rows;
+    const double INFEASIBLE = 1E9;
+    auto cost = [&](int row, int col) -> double {
+        if (col >= cols) {
+            return col - cols == row ? maxCost : INFEASIBLE;
+        }
+        const float c = costs[row * cols + col];
+        return (std::isfinite(c) && c <= maxCost) ? c : INFEASIBLE;
+    };
+
+    // hungarian method with potentials, indices are one based, index zero is a sentinel
+    std::vector<double> u(n + 1, 0), v(m + 1, 0);
+    std::vector<int> p(m + 1, 0), way(m + 1, 0);
+    for (int i = 1; i <= n; i++) {
+        p[0] = i;
+        int j0 = 0;
+        std::vector<double> minv(m + 1, std::numeric_limits<double>::max());
+        std::vector<bool> used(m + 1, false);
+        do {
+            used[j0] = true;
+            const int i0 = p[j0];
+            double delta = std::numeric_limits<double>::max();
+            int j1 = 0;
+            for (int j = 1; j <= m; j++) {
+                if (used[j]) {
+                    continue;
+                }
+                const double cur = cost(i0 - 1, j - 1) - u[i0] - v[j];
+                if (cur < minv[j]) {
+                    minv[j] = cur;
+                    way[j] = j0;
+                }
+                if (minv[j] < delta) {
+                    delta = minv[j];
+                    j1 = j;
+                }
+            }
+            for (int j = 0; j <= m; j++) {
+                if (used[j]) {
+                    u[p[j]] += delta;
+                    v[j] -= delta;
+                } else {
+                    minv[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+
+        // augment along the found path
+        do {
+            const int j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    for (int j = 1; j <= cols; j++) {
+        if (p[j] != 0 && cost(p[j] - 1, j - 1) < INFEASIBLE) {
+            result[p[j] - 1] = j - 1;
+        }
+    }
+    return result;
+}
@@ -19,7 +19,9 @@
  ***************************************************************************/
 
 #include "ballflyfilter.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <numeric>
 #include <iostream>
 #include <Eigen/Core>
@@ -131,6 +133,8 @@ auto FlyFilter::calcPinv() -> std::optional<BallFlight>
         m_D_detailed(baseIndex + 1, 4) = 1;
         m_D_detailed(baseIndex + 1, 5) = t_i;
         m_d_detailed(baseIndex + 1) = 0.5*GRAVITY*beta*t_i*t_i + y;
+        m_pinvEquations.addRow(m_D_detailed.row(baseIndex), m_d_detailed(baseIndex));
+        m_pinvEquations.addRow(m_D_detailed.row(baseIndex + 1), m_d_detailed(baseIndex + 1));
         m_pinvDataInserted = i;
     }
 
@@ -143,8 +147,12 @@ auto FlyFilter::calcPinv() -> std::optional<BallFlight>
         m_D_detailed(1, 4) = m_biasStrength;
         m_d_detailed(1) = firstInTheAir.ballPos.y() * m_biasStrength;
 
-        const int filledEntries = (m_kickFrames.size() + ADDITIONAL_DATA_INSERTION) * 2;
-        pi = m_D_detailed.block(0, 0, filledEntries, 6).colPivHouseholderQr().solve(m_d_detailed.block(0, 0, filledEntries, 1));
+        // only the bias rows change between the iterations, thus solve the accumulated
+        // normal equations instead of decomposing all rows again
+        LeastSquares<6> equations = m_pinvEquations;
+        equations.addRow(m_D_detailed.row(0), m_d_detailed(0));
+        equations.addRow(m_D_detailed.row(1), m_d_detailed(1));
+        pi = equations.solve().cast<float>();
 
         const Eigen::Vector2f startPos = Eigen::Vector2f(pi(2), pi(4));
         const Eigen::Vector2f trueStart = firstInTheAir.ballPos;
@@ -159,7 +167,10 @@ auto FlyFilter::calcPinv() -> std::optional<BallFlight>
     } while (startDistance > MAX_DISTANCE);
 
 
-    const float piError = (m_D_detailed * pi - m_d_detailed).lpNorm<1>();
+    // the L1 error depends on the current solution and can not be accumulated like the
+    // normal equations, it stays linear in the number of frames (at most MAX_FRAMES_PER_FLIGHT)
+    const int filledEntries = (m_kickFrames.size() + ADDITIONAL_DATA_INSERTION) * 2;
+    const float piError = (m_D_detailed.topRows(filledEntries) * pi - m_d_detailed.head(filledEntries)).lpNorm<1>();
 
     const float z0 = pi(0);
     const float vz = pi(1);
@@ -202,15 +213,22 @@ auto FlyFilter::calcPinv() -> std::optional<BallFlight>
 }
 
 auto FlyFilter::constrainedReconstruction(Eigen::Vector2f shotStartPos, Eigen::Vector2f groundSpeed,
-                                          float startTime, int startFrame) const -> BallFlight
+                                          float startTime, int startFrame,
+                                          ConstrainedReconstructionCache &cache) const -> BallFlight
 {
     groundSpeed = groundSpeed.normalized();
 
-    const int MAX_ENTRIES = 2*(m_kickFrames.size() - startFrame + 1);
-    Eigen::MatrixXf solver = Eigen::MatrixXf::Zero(MAX_ENTRIES, 3);
-    Eigen::VectorXf positions = Eigen::VectorXf::Zero(MAX_ENTRIES);
+    if (cache.startFrame != startFrame || cache.startTime != startTime
+            || cache.shotStartPos != shotStartPos || !cache.groundDirection.isApprox(groundSpeed, 1E-6f)) {
+        cache.startFrame = startFrame;
+        cache.startTime = startTime;
+        cache.shotStartPos = shotStartPos;
+        cache.groundDirection = groundSpeed;
+        cache.framesInserted = startFrame;
+        cache.equations.clear();
+    }
 
-    for (int i=startFrame; i < m_kickFrames.size(); i++) {
+    for (int i = cache.framesInserted; i < m_kickFrames.size(); i++) {
         const Eigen::Vector3f cam = m_cameraInfo->cameraPosition.value(m_kickFrames.at(i).cameraId);
         const float t_i = m_kickFrames.at(i).time - startTime;
         const float x = m_kickFrames.at(i).ballPos(0);
@@ -218,21 +236,17 @@ auto FlyFilter::constrainedReconstruction(Eigen::Vector2f shotStartPos, Eigen::V
         const float alpha = (cam(0) - x) / cam(2);
         const float beta = (cam(1) - y) / cam(2);
 
-        const int baseIndex = (i - startFrame) * 2;
-        solver(baseIndex, 0) = alpha*t_i;
-        solver(baseIndex, 1) = -groundSpeed.x() * t_i;
-        solver(baseIndex, 2) = alpha;
-        positions(baseIndex) = 0.5*GRAVITY*alpha*t_i*t_i + shotStartPos.x() - x;
-
-        solver(baseIndex + 1, 0) = beta*t_i;
-        solver(baseIndex + 1, 1) = -groundSpeed.y() * t_i;
-        solver(baseIndex + 1, 2) = beta;
-        positions(baseIndex + 1) = 0.5*GRAVITY*beta*t_i*t_i + shotStartPos.y() - y;
+        cache.equations.addRow(Eigen::Vector3f(alpha*t_i, -groundSpeed.x() * t_i, alpha),
+                               0.5*GRAVITY*alpha*t_i*t_i + shotStartPos.x() - x);
+        cache.equations.addRow(Eigen::Vector3f(beta*t_i, -groundSpeed.y() * t_i, beta),
+                               0.5*GRAVITY*beta*t_i*t_i + shotStartPos.y() - y);
     }
+    cache.framesInserted = m_kickFrames.size();
 
-    const Eigen::VectorXf values = solver.colPivHouseholderQr().solve(positions);
+    const Eigen::Vector3d solution = cache.equations.solve();
+    const Eigen::Vector3f values = solution.cast<float>();
 
-    const float error = (solver * values - positions).norm() / (m_kickFrames.size() - startFrame);
+    const float error = std::sqrt(cache.equations.squaredError(solution)) / (m_kickFrames.size() - startFrame);
     plot("constrained error", error);
 
     // ignore the z0 component here, since it should be rather small
@@ -257,7 +271,7 @@ auto FlyFilter::approachShotDirectionApply() const -> BallFlight
 {
     const ChipDetection firstInTheAir = m_kickFrames.at(m_shotStartFrame);
     BallFlight reconstruction = constrainedReconstruction(firstInTheAir.ballPos, approxGroundDirection(),
-                                                          firstInTheAir.time, m_shotStartFrame);
+                                                          firstInTheAir.time, m_shotStartFrame, m_shotDirectionCache);
     reconstruction.flightStartTime -= 0.01f; // -10ms, actual kick was before
     reconstruction.captureFlightStartTime -= 0.01f; // -10ms, actual kick was before
     return reconstruction;
@@ -275,6 +289,8 @@ static double innerAngle(Eigen::Vector2f center, Eigen::Vector2f A, Eigen::Vecto
     return acos( (dx21*dx31 + dy21*dy31) / (m12 * m13) );
 }
 
+// The projection through the camera is not linear in the flight parameters, which change with
+// every frame. Thus the error is recomputed over all frames of the flight (at most MAX_FRAMES_PER_FLIGHT).
 float FlyFilter::chipShotError(const BallFlight &pinvRes) const
 {
     const int startFrame = m_shotStartFrame+2;
@@ -763,7 +779,7 @@ void FlyFilter::updateBouncing(qint64 time)
         // if the shot is sufficiently curved, reconstruct the flight with constrained least squares fitting
         if (maxShotLineDist - minShotLineDist > 0.05f && framesSinceBounce > 4) {
             const BallFlight reconstruction = constrainedReconstruction(currentFlight.flightStartPos, currentFlight.groundSpeed,
-                                                               currentFlight.flightStartTime, currentFlight.startFrame);
+                                                               currentFlight.flightStartTime, currentFlight.startFrame, m_bounceCache);
             const BallFlight &previousFlight = m_flightReconstructions.at(m_flightReconstructions.size() - 2);
             if (reconstruction.groundSpeed.norm() < previousFlight.groundSpeed.norm()
                     && reconstruction.zSpeed > 0 && reconstruction.zSpeed < previousFlight.zSpeed) {
@@ -800,15 +816,15 @@ FlyFilter::Prediction FlyFilter::predictTrajectory(float time) const
     return Prediction(groundPos, zPos, flight.groundSpeed, zSpeed, flight.touchdownPos());
 }
 
-int FlyFilter::chooseDetection(const std::vector<VisionFrame> &frames) const
+std::vector<float> FlyFilter::detectionDistances(const std::vector<VisionFrame> &frames) const
 {
     const float ACCEPT_DIST = 0.35;
 
     // acceptance depends on prediction which makes no sense when not active
     // for activation of the filter the acceptance is not necessary
     // as the ground filter will accept a ball lying at the ground
-    if (m_flightReconstructions.isEmpty()) {
-        return -1;
+    if (m_flightReconstructions.isEmpty() || frames.empty()) {
+        return std::vector<float>(frames.size(), std::numeric_limits<float>::infinity());
     }
     // all frames will have the same time and camera id
     const auto pred = predictTrajectory(toLocalTime(frames.at(0).time));
@@ -818,20 +834,30 @@ int FlyFilter::chooseDetection(const std::vector<VisionFrame> &frames) const
 
     debugCircle("predicted ground pos", predGround.x(), predGround.y(), 0.02f);
 
-    int bestDetection = -1;
-    float bestDistance = ACCEPT_DIST;
-    for (std::size_t i = 0;i<frames.size();i++) {
-        const VisionFrame &frame = frames[i];
+    std::vector<float> distances;
+    distances.reserve(frames.size());
+    for (const VisionFrame &frame : frames) {
         const Eigen::Vector3f ball(frame.x, frame.y, 0);
         const float dist = (ball - predGround).norm();
-        if (dist < bestDistance) {
-            bestDetection = i;
-            bestDistance = dist;
-        }
+        distances.push_back(dist < ACCEPT_DIST ? dist : std::numeric_limits<float>::infinity());
+    }
+    return distances;
+}
+
+int FlyFilter::chooseDetection(const std::vector<VisionFrame> &frames) const
+{
+    if (m_flightReconstructions.isEmpty()) {
+        return -1;
+    }
+
+    const std::vector<float> distances = detectionDistances(frames);
+    const auto best = std::min_element(distances.begin(), distances.end());
+    if (best == distances.end() || std::isinf(*best)) {
+        return -1;
     }
 
-    debug("accept dist", bestDistance);
-    return bestDetection;
+    debug("accept dist", *best);
+    return best - distances.begin();
 }
 
 void FlyFilter::writeBallState(world::Ball *ball, qint64 predictionTime, const QVector<RobotInfo> &, qint64)
@@ -861,5 +887,8 @@ void FlyFilter::resetFlightReconstruction()
     const int matchEntries = MAX_FRAMES_PER_FLIGHT + ADDITIONAL_DATA_INSERTION;
     m_d_detailed = Eigen::VectorXf::Zero(2*matchEntries);
     m_D_detailed = Eigen::MatrixXf::Zero(2*matchEntries, 6);
+    m_pinvEquations.clear();
+    m_shotDirectionCache.startFrame = -1;
+    m_bounceCache.startFrame = -1;
 }
 
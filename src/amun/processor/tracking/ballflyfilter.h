@@ -22,6 +22,7 @@
 #define BALLFLYFILTER_H
 
 #include "abstractballfilter.h"
+#include "leastsquares.h"
 #include "protobuf/ssl_detection.pb.h"
 #include "protobuf/world.pb.h"
 
@@ -35,6 +36,8 @@ public:
 
     void processVisionFrame(const VisionFrame& frame) override;
     int chooseDetection(const std::vector<VisionFrame>& frames) const override;
+    // distance of every frame to the predicted ground position, infinity for frames the filter would not accept
+    std::vector<float> detectionDistances(const std::vector<VisionFrame>& frames) const;
     void writeBallState(world::Ball *ball, qint64 predictionTime, const QVector<RobotInfo> &robots, qint64 lastCameraFrameTime) override;
     float distToStartPos() { return m_distToStartPos; }
 
@@ -97,7 +100,9 @@ private:
     std::optional<BallFlight> calcPinv();
 
     Eigen::Vector2f approxGroundDirection() const;
-    BallFlight constrainedReconstruction(Eigen::Vector2f shotStartPos, Eigen::Vector2f groundSpeed, float startTime, int startFrame) const;
+    struct ConstrainedReconstructionCache;
+    BallFlight constrainedReconstruction(Eigen::Vector2f shotStartPos, Eigen::Vector2f groundSpeed, float startTime, int startFrame,
+                                         ConstrainedReconstructionCache &cache) const;
 
     BallFlight approachShotDirectionApply() const;
 
@@ -145,6 +150,21 @@ private:
     int m_pinvDataInserted;
     Eigen::VectorXf m_d_detailed;
     Eigen::MatrixXf m_D_detailed;
+    // normal equations of the rows in m_D_detailed, without the position bias
+    LeastSquares<6> m_pinvEquations;
+
+    // the constrained reconstruction is repeated with the same parameters for every new frame,
+    // each caller keeps its own cache since they use different parameters
+    struct ConstrainedReconstructionCache {
+        int startFrame;
+        float startTime;
+        Eigen::Vector2f shotStartPos;
+        Eigen::Vector2f groundDirection;
+        int framesInserted;
+        LeastSquares<3> equations;
+    };
+    mutable ConstrainedReconstructionCache m_shotDirectionCache;
+    ConstrainedReconstructionCache m_bounceCache;
 };
 
 #endif // BALLFLYFILTER_H
@@ -19,6 +19,8 @@
  ***************************************************************************/
 #include "ballgroundcollisionfilter.h"
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <QDebug>
 
 const float DRIBBLER_WIDTH = 0.07f;
@@ -119,24 +121,30 @@ void BallGroundCollisionFilter::updateDribbleAndRotate(const VisionFrame &frame)
     m_rotateAndDribbleOffset = BallOffsetInfo(framePos, frame.robot, true, true);
 }
 
-int BallGroundCollisionFilter::chooseDetection(const std::vector<VisionFrame> &frames) const
+std::vector<float> BallGroundCollisionFilter::detectionDistances(const std::vector<VisionFrame> &frames) const
 {
     const float ACCEPT_BALL_DIST = 0.45f;
-    float minDistance = ACCEPT_BALL_DIST;
-    int bestFrame = -1;
-    for (std::size_t i = 0;i<frames.size();i++) {
-        const VisionFrame &frame = frames[i];
+    std::vector<float> distances;
+    distances.reserve(frames.size());
+    for (const VisionFrame &frame : frames) {
         const Eigen::Vector2f framePos(frame.x, frame.y);
         const float reportedBallDist = m_dribbleOffset.has_value() ? (m_lastReportedBallPos - framePos).norm() : std::numeric_limits<float>::max();
         const float groundFilterDist = m_groundFilter.distanceTo(framePos);
 
         const float dist = std::min(reportedBallDist, groundFilterDist);
-        if (dist < minDistance) {
-            minDistance = dist;
-            bestFrame = i;
-        }
+        distances.push_back(dist < ACCEPT_BALL_DIST ? dist : std::numeric_limits<float>::infinity());
+    }
+    return distances;
+}
+
+int BallGroundCollisionFilter::chooseDetection(const std::vector<VisionFrame> &frames) const
+{
+    const std::vector<float> distances = detectionDistances(frames);
+    const auto best = std::min_element(distances.begin(), distances.end());
+    if (best == distances.end() || std::isinf(*best)) {
+        return -1;
     }
-    return bestFrame;
+    return best - distances.begin();
 }
 
 static auto intersectLineCircle(Eigen::Vector2f offset, Eigen::Vector2f dir, Eigen::Vector2f center, float radius)
@@ -38,6 +38,8 @@ public:
     void processVisionFrame(const VisionFrame& frame) override;
     void writeBallState(world::Ball *ball, qint64 time, const QVector<RobotInfo> &robots, qint64 lastCameraFrameTime) override;
     int chooseDetection(const std::vector<VisionFrame> &frames) const override;
+    // distance of every frame to the filter prediction, infinity for frames the filter would not accept
+    std::vector<float> detectionDistances(const std::vector<VisionFrame> &frames) const;
 
     bool isFeasiblyInvisible() const { return m_feasiblyInvisible; };
     float getMaxSpeed() const { return m_maxSpeed; }
@@ -21,10 +21,14 @@
 #include "balltracker.h"
 #include "ballflyfilter.h"
 #include "ballgroundcollisionfilter.h"
+#include <algorithm>
+#include <cmath>
 
 BallTracker::BallTracker(const VisionFrame &frame, CameraInfo *cameraInfo, const FieldTransform &transform, const world::BallModel &ballModel) :
     Filter(frame.time),
     m_lastUpdateTime(frame.time),
+    m_groundFilter(frame, cameraInfo, transform, ballModel),
+    m_flyFilter(frame, cameraInfo, transform, ballModel),
     m_cameraInfo(cameraInfo),
     m_initTime(frame.time),
     m_lastFrameTime(0),
@@ -33,13 +37,13 @@ BallTracker::BallTracker(const VisionFrame &frame, CameraInfo *cameraInfo, const
     m_cachedDistToCamera(0)
 {
     m_primaryCamera = frame.cameraId;
-    m_groundFilter = new BallGroundCollisionFilter(frame, cameraInfo, transform, ballModel);
-    m_flyFilter = new FlyFilter(frame, cameraInfo, transform, ballModel);
 }
 
 BallTracker::BallTracker(const BallTracker& previousFilter, qint32 primaryCamera) :
     Filter(previousFilter.lastUpdate()),
     m_lastUpdateTime(previousFilter.m_lastUpdateTime),
+    m_groundFilter(previousFilter.m_groundFilter, primaryCamera),
+    m_flyFilter(previousFilter.m_flyFilter),
     m_cameraInfo(previousFilter.m_cameraInfo),
     m_initTime(previousFilter.m_initTime),
     m_lastBallPos(previousFilter.m_lastBallPos),
@@ -50,22 +54,16 @@ BallTracker::BallTracker(const BallTracker& previousFilter, qint32 primaryCamera
 {
     m_primaryCamera = primaryCamera;
 
-    m_flyFilter = new FlyFilter(*previousFilter.m_flyFilter);
-    m_flyFilter->moveToCamera(primaryCamera);
-    m_groundFilter = new BallGroundCollisionFilter(*previousFilter.m_groundFilter, primaryCamera);
-    m_groundFilter->moveToCamera(primaryCamera);
+    m_flyFilter.moveToCamera(primaryCamera);
+    m_groundFilter.moveToCamera(primaryCamera);
 }
 
-BallTracker::~BallTracker()
-{
-    delete m_flyFilter;
-    delete m_groundFilter;
-}
+BallTracker::~BallTracker() = default;
 
 int BallTracker::chooseDetection(const std::vector<VisionFrame> &possibleFrames)
 {
-    const int flyFilterChoice = m_flyFilter->chooseDetection(possibleFrames);
-    const int groundFilterChoice = m_groundFilter->chooseDetection(possibleFrames);
+    const int flyFilterChoice = m_flyFilter.chooseDetection(possibleFrames);
+    const int groundFilterChoice = m_groundFilter.chooseDetection(possibleFrames);
     debug("accept", flyFilterChoice >= 0 || groundFilterChoice >= 0);
     debug("acceptId", possibleFrames.at(0).cameraId);
     debug("age", std::to_string(initTime()).c_str());
@@ -73,12 +71,22 @@ int BallTracker::chooseDetection(const std::vector<VisionFrame> &possibleFrames)
     return flyFilterChoice < 0 ? groundFilterChoice : flyFilterChoice;
 }
 
+std::vector<float> BallTracker::detectionDistances(const std::vector<VisionFrame> &possibleFrames) const
+{
+    // the fly filter has precedence if it accepts any detection
+    std::vector<float> distances = m_flyFilter.detectionDistances(possibleFrames);
+    if (std::any_of(distances.begin(), distances.end(), [](float d) { return !std::isinf(d); })) {
+        return distances;
+    }
+    return m_groundFilter.detectionDistances(possibleFrames);
+}
+
 void BallTracker::calcDistToCamera(bool flying)
 {
     Eigen::Vector3f cam = m_cameraInfo->cameraPosition.value(m_primaryCamera);
     float dist = (m_lastBallPos - Eigen::Vector2f(cam(0), cam(1))).norm();
-    if (flying && m_flyFilter->isActive()) {
-        dist = m_flyFilter->distToStartPos();
+    if (flying && m_flyFilter.isActive()) {
+        dist = m_flyFilter.distToStartPos();
     }
 
     debug("dist", dist);
@@ -92,7 +100,7 @@ float BallTracker::cachedDistToCamera()
 
 bool BallTracker::isFlying() const
 {
-    return m_flyFilter->isActive();
+    return m_flyFilter.isActive();
 }
 
 void BallTracker::updateConfidence()
@@ -110,8 +118,8 @@ void BallTracker::update(qint64 time)
             break; // try again later
         }
 
-        m_flyFilter->processVisionFrame(frame);
-        m_groundFilter->processVisionFrame(frame);
+        m_flyFilter.processVisionFrame(frame);
+        m_groundFilter.processVisionFrame(frame);
         m_rawMeasurements.append(frame);
 
         m_lastFrameTime = frame.time;
@@ -123,10 +131,10 @@ void BallTracker::update(qint64 time)
     }
     m_lastUpdateTime = time;
 #ifdef ENABLE_TRACKING_DEBUG
-    m_debug.MergeFrom(m_groundFilter->debugValues());
-    m_groundFilter->clearDebugValues();
-    m_debug.MergeFrom(m_flyFilter->debugValues());
-    m_flyFilter->clearDebugValues();
+    m_debug.MergeFrom(m_groundFilter.debugValues());
+    m_groundFilter.clearDebugValues();
+    m_debug.MergeFrom(m_flyFilter.debugValues());
+    m_flyFilter.clearDebugValues();
 #endif
 }
 
@@ -134,15 +142,15 @@ void BallTracker::get(world::Ball *ball, const FieldTransform &transform, bool r
 {
     ball->set_is_bouncing(false); // fly filter overwrites if appropriate
 
-    if (m_flyFilter->isActive()) {
+    if (m_flyFilter.isActive()) {
         debug("active", "fly filter");
-        m_flyFilter->writeBallState(ball, m_lastUpdateTime, robots, lastCameraFrameTime);
+        m_flyFilter.writeBallState(ball, m_lastUpdateTime, robots, lastCameraFrameTime);
     } else {
         debug("active", "ground filter");
-        m_groundFilter->writeBallState(ball, m_lastUpdateTime, robots, lastCameraFrameTime);
+        m_groundFilter.writeBallState(ball, m_lastUpdateTime, robots, lastCameraFrameTime);
     }
     // the flight tracker does not have a max speed, therefore, the ground tracker max speed is always used
-    ball->set_max_speed(m_groundFilter->getMaxSpeed());
+    ball->set_max_speed(m_groundFilter.getMaxSpeed());
 
     float transformedPX = transform.applyPosX(ball->p_x(), ball->p_y());
     float transformedPY = transform.applyPosY(ball->p_x(), ball->p_y());
@@ -184,9 +192,9 @@ void BallTracker::addVisionFrame(const VisionFrame &frame)
 
 bool BallTracker::isFeasiblyInvisible() const
 {
-    if (m_flyFilter->isActive()) {
+    if (m_flyFilter.isActive()) {
         return false;
     } else {
-        return m_groundFilter->isFeasiblyInvisible();
+        return m_groundFilter.isFeasiblyInvisible();
     }
 }
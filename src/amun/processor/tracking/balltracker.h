@@ -25,11 +25,11 @@
 #include "core/fieldtransform.h"
 #include "kalmanfilter.h"
 #include "abstractballfilter.h"
+#include "ballflyfilter.h"
+#include "ballgroundcollisionfilter.h"
 #include "protobuf/debug.pb.h"
 #include "protobuf/world.pb.h"
 
-class FlyFilter;
-class BallGroundCollisionFilter;
 class DribbleFilter;
 
 class BallTracker : public Filter
@@ -48,6 +48,8 @@ public:
     void addVisionFrame(const VisionFrame &frame);
     // returns a negative number to accept no frame
     int chooseDetection(const std::vector<VisionFrame> &possibleFrames);
+    // consistent with chooseDetection, infinity for frames that would not be accepted
+    std::vector<float> detectionDistances(const std::vector<VisionFrame> &possibleFrames) const;
     void calcDistToCamera(bool flying);
     float cachedDistToCamera();
     bool isFlying() const;
@@ -67,8 +69,9 @@ public:
 
 private:  
     qint64 m_lastUpdateTime;
-    BallGroundCollisionFilter* m_groundFilter;
-    FlyFilter *m_flyFilter;
+    // stored inline, ball trackers are created for every unexplained detection
+    BallGroundCollisionFilter m_groundFilter;
+    FlyFilter m_flyFilter;
     QList<VisionFrame> m_visionFrames;
     QList<VisionFrame> m_rawMeasurements;
     CameraInfo* m_cameraInfo;
@@ -0,0 +1,39 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef ASSIGNMENT_H
+#define ASSIGNMENT_H
+
+#include <vector>
+
+/*!
+ * \brief Solves the linear assignment problem with the hungarian method
+ *
+ * Assigns every row to at most one column and every column to at most one row,
+ * so that the sum of the costs of all assigned pairs is minimal. Leaving a row
+ * unassigned costs maxCost, therefore pairs with a cost above maxCost
+ * (or infinite cost) are never assigned.
+ *
+ * \param costs row major cost matrix with rows * cols entries
+ * \return the assigned column for every row, or -1 if the row is unassigned
+ */
+std::vector<int> solveAssignment(const std::vector<float> &costs, int rows, int cols, float maxCost);
+
+#endif // ASSIGNMENT_H
@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef LEASTSQUARES_H
+#define LEASTSQUARES_H
+
+#include <Eigen/Core>
+#include <Eigen/QR>
+#include <algorithm>
+
+// Running normal equations of a linear least squares problem with N unknowns.
+// Rows can be added one at a time, solving is independent of the number of rows.
+// The sums are accumulated in double precision, as forming the normal
+// equations squares the condition of the problem.
+template<int N>
+class LeastSquares
+{
+public:
+    typedef Eigen::Matrix<double, N, 1> Vector;
+
+    LeastSquares() { clear(); }
+
+    void clear()
+    {
+        m_ata.setZero();
+        m_atb.setZero();
+        m_btb = 0;
+        m_rows = 0;
+    }
+
+    template<typename Derived>
+    void addRow(const Eigen::MatrixBase<Derived> &row, double value)
+    {
+        const Vector r = row.transpose().template cast<double>();
+        m_ata.noalias() += r * r.transpose();
+        m_atb += r * value;
+        m_btb += value * value;
+        m_rows++;
+    }
+
+    Vector solve() const
+    {
+        return m_ata.colPivHouseholderQr().solve(m_atb);
+    }
+
+    // sum of the squared residuals for the given solution
+    double squaredError(const Vector &x) const
+    {
+        return std::max(0.0, x.dot(m_ata * x) - 2 * x.dot(m_atb) + m_btb);
+    }
+
+    int rows() const { return m_rows; }
+
+private:
+    Eigen::Matrix<double, N, N> m_ata;
+    Vector m_atb;
+    double m_btb;
+    int m_rows;
+};
+
+#endif // LEASTSQUARES_H
@@ -0,0 +1,101 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Preallocated storage for a bounded number of objects of type T.
+// Objects are constructed in place, thus creating and destroying them does
+// not touch the heap as long as the pool has free slots. If all slots are in
+// use, further objects are allocated on the heap.
+template<typename T>
+class ObjectPool
+{
+public:
+    explicit ObjectPool(std::size_t capacity) :
+        m_storage(new Slot[capacity]),
+        m_capacity(capacity)
+    {
+        m_freeSlots.reserve(capacity);
+        for (std::size_t i = capacity; i > 0; i--) {
+            m_freeSlots.push_back(&m_storage[i - 1]);
+        }
+    }
+    // all objects must be destroyed before the pool
+    ~ObjectPool() = default;
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template<typename... Args>
+    T *create(Args&&... args)
+    {
+        if (m_freeSlots.empty()) {
+            return new T(std::forward<Args>(args)...);
+        }
+        Slot *slot = m_freeSlots.back();
+        T *object = new (slot->data) T(std::forward<Args>(args)...);
+        // only claim the slot once the constructor succeeded
+        m_freeSlots.pop_back();
+        return object;
+    }
+
+    void destroy(T *object)
+    {
+        if (!object) {
+            return;
+        }
+        if (!owns(object)) {
+            delete object;
+            return;
+        }
+        object->~T();
+        m_freeSlots.push_back(reinterpret_cast<Slot*>(object));
+    }
+
+    std::size_t capacity() const { return m_capacity; }
+    std::size_t freeSlots() const { return m_freeSlots.size(); }
+
+private:
+    struct Slot
+    {
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    bool owns(const T *object) const
+    {
+        const auto *slot = reinterpret_cast<const Slot*>(object);
+        return std::less_equal<const Slot*>()(m_storage.get(), slot)
+                && std::less<const Slot*>()(slot, m_storage.get() + m_capacity);
+    }
+
+private:
+    std::unique_ptr<Slot[]> m_storage;
+    const std::size_t m_capacity;
+    std::vector<Slot*> m_freeSlots;
+};
+
+#endif // OBJECTPOOL_H
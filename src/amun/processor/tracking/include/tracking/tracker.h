@@ -30,7 +30,12 @@
 #include <QPair>
 #include <QByteArray>
 #include <QObject>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
 
+template<typename T> class ObjectPool;
 class BallTracker;
 class RobotFilter;
 class SSL_DetectionBall;
@@ -47,8 +52,18 @@ class Tracker : public QObject
 {
     Q_OBJECT
 
+public:
+    struct FilterStatistics {
+        int ballFiltersSpawned = 0;
+        int ballFiltersInvalidated = 0;
+        int robotFiltersSpawned = 0;
+        int robotFiltersInvalidated = 0;
+    };
+
 private:
     typedef QMap<uint, QList<RobotFilter*> > RobotMap;
+    // nearest filter with distance for every primary camera
+    typedef std::map<qint32, std::pair<float, RobotFilter*>> FilterByCamera;
     struct Packet {
         Packet(const SSL_DetectionFrame &detection, qint64 time) : detection(detection), time(time) {}
         SSL_DetectionFrame detection;
@@ -73,6 +88,13 @@ public:
     void reset();
     void updateTeam(const robot::Team &team, bool isBlue);
 
+    int ballFilterCount() const { return m_ballFilter.size(); }
+    int robotFilterCount() const;
+    // counts since construction of the tracker
+    const FilterStatistics &filterStatistics() const { return m_filterStatistics; }
+    // counts of the last full minute
+    const FilterStatistics &lastMinuteFilterStatistics() const { return m_lastMinuteStatistics; }
+
 public slots:
     void setBallModel(const world::BallModel &ballModel) { m_ballModel.CopyFrom(ballModel); }
     void updateCamera(const SSL_GeometryCameraCalibration &c, const QString &sender);
@@ -80,12 +102,25 @@ public slots:
 private:
     void invalidateRobotFilter(QList<RobotFilter*> &filters, const qint64 maxTime, const qint64 maxTimeLast, qint64 currentTime);
     void invalidateBall(qint64 currentTime);
+    void limitBallFilters();
+    void deleteBallFilter(BallTracker *filter);
     void invalidateRobots(RobotMap &map, qint64 currentTime);
 
     QList<RobotFilter*> getBestRobots(qint64 currentTime, int desiredCamera);
     void trackBallDetections(const SSL_DetectionFrame &frame, qint64 sourceTime, qint64 visionProcessingDelay);
+    void trackRobots(RobotMap& robotMap, const google::protobuf::RepeatedPtrField<SSL_DetectionRobot> &robots, qint64 sourceTime,
+                     qint32 cameraId, qint64 visionProcessingDelay, bool teamIsYellow);
     void trackRobot(RobotMap& robotMap, const SSL_DetectionRobot &robot, qint64 sourceTime, qint32 cameraId, qint64 visionProcessingDelay,
                     bool teamIsYellow);
+    void assignRobotDetections(QList<RobotFilter*> &filters, const std::vector<const SSL_DetectionRobot*> &detections, qint64 sourceTime,
+                               qint32 cameraId, qint64 visionProcessingDelay, bool teamIsYellow);
+    void addRobotDetection(QList<RobotFilter*> &filters, FilterByCamera &nearestFilterByCamera, const SSL_DetectionRobot &robot,
+                           qint64 sourceTime, qint32 cameraId, qint64 visionProcessingDelay, bool teamIsYellow);
+    void updateFilterStatistics(qint64 currentTime);
+    void countFilterEvent(int FilterStatistics::*counter) {
+        m_filterStatistics.*counter += 1;
+        m_currentMinuteStatistics.*counter += 1;
+    }
 
     BallTracker* bestBallFilter();
     void prioritizeBallFilters();
@@ -111,6 +146,9 @@ private:
 
     QList<BallTracker*> m_ballFilter;
     BallTracker* m_currentBallFilter;
+    // false ball detections can spawn lots of filters, keep their number bounded
+    int m_maxBallFilters;
+    std::unique_ptr<ObjectPool<BallTracker>> m_ballFilterPool;
 
     RobotMap m_robotFilterYellow;
     RobotMap m_robotFilterBlue;
@@ -124,6 +162,14 @@ private:
     // if possible, select robots from this camera
     int m_desiredRobotCamera = -1;
 
+    // assign the detections of a camera frame jointly instead of greedily per filter
+    bool m_globalAssignment = false;
+
+    FilterStatistics m_filterStatistics;
+    FilterStatistics m_currentMinuteStatistics;
+    FilterStatistics m_lastMinuteStatistics;
+    qint64 m_filterStatisticsStart = 0;
+
     // differences between tracker and speedtracker
     const bool m_robotsOnly;
     const qint64 m_resetTimeout;
@@ -19,7 +19,9 @@
  ***************************************************************************/
 
 #include "tracker.h"
+#include "assignment.h"
 #include "balltracker.h"
+#include "objectpool.h"
 #include "protobuf/ssl_detection.pb.h"
 #include "protobuf/ssl_geometry.pb.h"
 #include "robotfilter.h"
@@ -29,8 +31,20 @@
 #include "core/fieldtransform.h"
 #include "worldparameters.h"
 #include <QDebug>
+#include <cmath>
 #include <limits>
 
+// Maximum distance for a robot detection to be associated with a filter
+static const float MAX_ROBOT_DISTANCE = 0.5;
+// Time after which a filter may be fed by detections from other cameras than its primary one
+static const qint64 PRIMARY_TIMEOUT = 42*1000*1000;
+// Cost of leaving a ball filter without detection, larger than the acceptance distances of the ball filters
+static const float MAX_BALL_ASSIGNMENT_COST = 1.0f;
+// Upper bound for the number of ball filters, the least confident filters are removed first
+static const int DEFAULT_MAX_BALL_FILTERS = 30;
+// Additional preallocated ball filters, as the limit is only enforced after all detections of a frame were handled
+static const int BALL_FILTER_POOL_RESERVE = 10;
+
 Tracker::Tracker(bool robotsOnly, bool isSpeedTracker, WorldParameters *m_worldParameters) :
     m_cameraInfo(new CameraInfo),
     m_visionTransmissionDelay(0),
@@ -38,6 +52,8 @@ Tracker::Tracker(bool robotsOnly, bool isSpeedTracker, WorldParameters *m_worldP
     m_lastSlowVisionFrame(0),
     m_numSlowVisionFrames(0),
     m_currentBallFilter(nullptr),
+    m_maxBallFilters(DEFAULT_MAX_BALL_FILTERS),
+    m_ballFilterPool(new ObjectPool<BallTracker>(robotsOnly ? 0 : DEFAULT_MAX_BALL_FILTERS + BALL_FILTER_POOL_RESERVE)),
     m_aoiEnabled(false),
     m_worldParameters(m_worldParameters),
     m_robotsOnly(robotsOnly),
@@ -64,8 +80,11 @@ void Tracker::reset()
     }
     m_robotFilterBlue.clear();
 
-    qDeleteAll(m_ballFilter);
+    for (BallTracker *filter : m_ballFilter) {
+        m_ballFilterPool->destroy(filter);
+    }
     m_ballFilter.clear();
+    m_currentBallFilter = nullptr;
 
     m_timeSinceLastReset = 0;
     m_lastUpdateTime.clear();
@@ -74,6 +93,18 @@ void Tracker::reset()
     m_cameraInfo->focalLength.clear();
 }
 
+int Tracker::robotFilterCount() const
+{
+    int count = 0;
+    for (const QList<RobotFilter*>& list : m_robotFilterYellow) {
+        count += list.size();
+    }
+    for (const QList<RobotFilter*>& list : m_robotFilterBlue) {
+        count += list.size();
+    }
+    return count;
+}
+
 void Tracker::process(qint64 currentTime)
 {
     // reset time is used to immediatelly show robots after reset
@@ -81,6 +112,8 @@ void Tracker::process(qint64 currentTime)
         m_timeSinceLastReset = currentTime;
     }
 
+    updateFilterStatistics(currentTime);
+
     // remove outdated ball and robot filters
     invalidateBall(currentTime);
     invalidateRobots(m_robotFilterYellow, currentTime);
@@ -140,13 +173,8 @@ void Tracker::process(qint64 currentTime)
             continue;
         }
 
-        for (int i = 0; i < detection.robots_yellow_size(); i++) {
-            trackRobot(m_robotFilterYellow, detection.robots_yellow(i), sourceTime, detection.camera_id(), visionProcessingTime, true);
-        }
-
-        for (int i = 0; i < detection.robots_blue_size(); i++) {
-            trackRobot(m_robotFilterBlue, detection.robots_blue(i), sourceTime, detection.camera_id(), visionProcessingTime, false);
-        }
+        trackRobots(m_robotFilterYellow, detection.robots_yellow(), sourceTime, detection.camera_id(), visionProcessingTime, true);
+        trackRobots(m_robotFilterBlue, detection.robots_blue(), sourceTime, detection.camera_id(), visionProcessingTime, false);
 
         if (!m_robotsOnly) {
             trackBallDetections(detection, sourceTime, visionProcessingTime);
@@ -311,10 +339,22 @@ bool Tracker::injectDebugValues(qint64 currentTime, amun::DebugValues *debug)
         log->set_text(message.toStdString());
     }
 
+    if (m_globalAssignment) {
+        auto addValue = [debug](const char *key, int value) {
+            amun::DebugValue *debugValue = debug->add_value();
+            debugValue->set_key(key);
+            debugValue->set_float_value(value);
+        };
+        addValue("filters per minute/ball spawned", m_lastMinuteStatistics.ballFiltersSpawned);
+        addValue("filters per minute/ball invalidated", m_lastMinuteStatistics.ballFiltersInvalidated);
+        addValue("filters per minute/robot spawned", m_lastMinuteStatistics.robotFiltersSpawned);
+        addValue("filters per minute/robot invalidated", m_lastMinuteStatistics.robotFiltersInvalidated);
+    }
+
 #ifdef ENABLE_TRACKING_DEBUG
     return true;
 #else
-    return m_errorMessages.size() > 0;
+    return m_errorMessages.size() > 0 || m_globalAssignment;
 #endif
 }
 
@@ -358,6 +398,7 @@ void Tracker::invalidateRobotFilter(QList<RobotFilter*> &filters, const qint64 m
         if (filter->lastUpdate() + timeLimit < currentTime) {
             delete filter;
             it.remove();
+            countFilterEvent(&FilterStatistics::robotFiltersInvalidated);
         }
     }
 }
@@ -396,7 +437,7 @@ void Tracker::invalidateBall(qint64 currentTime)
         }
         if (filter->lastUpdate() + timeLimit < currentTime) {
             if (filter->frameCounter() < 3) {
-                delete filter;
+                deleteBallFilter(filter);
             } else {
                 possibleRemovals.append(filter);
             }
@@ -414,16 +455,48 @@ void Tracker::invalidateBall(qint64 currentTime)
         while (possibleRemovals.size() > 5) {
             BallTracker* toRemove = possibleRemovals.back();
             possibleRemovals.pop_back();
-            delete toRemove;
+            deleteBallFilter(toRemove);
         }
         // always remove at least one
         BallTracker* toRemove = possibleRemovals.back();
         possibleRemovals.pop_back();
-        delete toRemove;
+        deleteBallFilter(toRemove);
         m_ballFilter.append(possibleRemovals);
     }
 }
 
+void Tracker::limitBallFilters()
+{
+    while (m_ballFilter.size() > m_maxBallFilters) {
+        // evict the least confident filter, on ties the one that was updated the longest time ago
+        auto worst = m_ballFilter.end();
+        for (auto it = m_ballFilter.begin(); it != m_ballFilter.end(); ++it) {
+            if (*it == m_currentBallFilter) {
+                continue;
+            }
+            if (worst == m_ballFilter.end() || (*it)->confidence() < (*worst)->confidence()
+                    || ((*it)->confidence() == (*worst)->confidence() && (*it)->lastUpdate() < (*worst)->lastUpdate())) {
+                worst = it;
+            }
+        }
+        if (worst == m_ballFilter.end()) {
+            break;
+        }
+        BallTracker *filter = *worst;
+        m_ballFilter.erase(worst);
+        deleteBallFilter(filter);
+    }
+}
+
+void Tracker::deleteBallFilter(BallTracker *filter)
+{
+    if (filter == m_currentBallFilter) {
+        m_currentBallFilter = nullptr;
+    }
+    m_ballFilterPool->destroy(filter);
+    countFilterEvent(&FilterStatistics::ballFiltersInvalidated);
+}
+
 void Tracker::invalidateRobots(RobotMap &map, qint64 currentTime)
 {
     // Maximum tracking time if multiple robots with same id are visible
@@ -523,9 +596,19 @@ void Tracker::trackBallDetections(const SSL_DetectionFrame &frame, qint64 source
     bool detectionWasAccepted = false;
     std::vector<bool> acceptingFilterWithCamId(ballFrames.size(), false);
     std::vector<BallTracker*> acceptingFilterWithOtherCamId(ballFrames.size(), nullptr);
+    std::vector<BallTracker*> assignedFilters;
+    std::vector<float> assignmentCosts;
     for (BallTracker *filter : m_ballFilter) {
         filter->update(sourceTime);
 
+        if (m_globalAssignment && filter->primaryCamera() == cameraId) {
+            // the detections are distributed among all filters of this camera at once below
+            const std::vector<float> distances = filter->detectionDistances(ballFrames);
+            assignmentCosts.insert(assignmentCosts.end(), distances.begin(), distances.end());
+            assignedFilters.push_back(filter);
+            continue;
+        }
+
         // from a given vision packet, each filter can only accept one detection,
         // since it is not possible to see the true ball multiple times
         const int choice = filter->chooseDetection(ballFrames);
@@ -543,20 +626,34 @@ void Tracker::trackBallDetections(const SSL_DetectionFrame &frame, qint64 source
         }
     }
 
+    if (!assignedFilters.empty()) {
+        // every detection is used by at most one filter, which avoids duplicate filters following the same ball
+        const std::vector<int> assignment = solveAssignment(assignmentCosts, assignedFilters.size(), ballFrames.size(), MAX_BALL_ASSIGNMENT_COST);
+        for (std::size_t i = 0; i < assignedFilters.size(); i++) {
+            if (assignment[i] >= 0) {
+                assignedFilters[i]->addVisionFrame(ballFrames.at(assignment[i]));
+                acceptingFilterWithCamId[assignment[i]] = true;
+                detectionWasAccepted = true;
+            }
+        }
+    }
+
     for (std::size_t i = 0;i<ballFrames.size();i++) {
         if (!acceptingFilterWithCamId[i]) {
             BallTracker* bt;
             if (acceptingFilterWithOtherCamId[i] != nullptr) {
                 // copy filter from old camera
-                bt = new BallTracker(*acceptingFilterWithOtherCamId[i], cameraId);
+                bt = m_ballFilterPool->create(*acceptingFilterWithOtherCamId[i], cameraId);
             } else {
                 // create new Ball Filter without initial movement
-                bt = new BallTracker(ballFrames[i], m_cameraInfo, m_worldParameters->fieldTransform(), m_ballModel);
+                bt = m_ballFilterPool->create(ballFrames[i], m_cameraInfo, m_worldParameters->fieldTransform(), m_ballModel);
             }
             m_ballFilter.append(bt);
             bt->addVisionFrame(ballFrames[i]);
+            countFilterEvent(&FilterStatistics::ballFiltersSpawned);
         }
     }
+    limitBallFilters();
 
     if (detectionWasAccepted) {
         // only prioritize when at least one detection was accepted
@@ -564,6 +661,87 @@ void Tracker::trackBallDetections(const SSL_DetectionFrame &frame, qint64 source
     }
 }
 
+// distance of the detection to the filter, infinity if the filter must not use the detection
+static float robotDetectionDistance(const RobotFilter *filter, const SSL_DetectionRobot &robot, qint64 sourceTime, qint32 cameraId)
+{
+    const float dist = filter->distanceTo(robot);
+    if (dist > MAX_ROBOT_DISTANCE) {
+        return std::numeric_limits<float>::infinity();
+    }
+    const bool isYoung = sourceTime - filter->lastPrimaryTime() > PRIMARY_TIMEOUT;
+    if (static_cast<qint32>(filter->primaryCamera()) != cameraId && isYoung) {
+        return std::numeric_limits<float>::infinity();
+    }
+    return dist;
+}
+
+void Tracker::trackRobots(RobotMap &robotMap, const google::protobuf::RepeatedPtrField<SSL_DetectionRobot> &robots, qint64 sourceTime,
+                          qint32 cameraId, qint64 visionProcessingDelay, bool teamIsYellow)
+{
+    if (!m_globalAssignment) {
+        for (const SSL_DetectionRobot &robot : robots) {
+            trackRobot(robotMap, robot, sourceTime, cameraId, visionProcessingDelay, teamIsYellow);
+        }
+        return;
+    }
+
+    std::map<uint, std::vector<const SSL_DetectionRobot*>> detectionsById;
+    for (const SSL_DetectionRobot &robot : robots) {
+        if (!robot.has_robot_id()) {
+            continue;
+        }
+        if (m_aoiEnabled && !m_aoi.containsVision({ robot.x(), robot.y() }, m_worldParameters->fieldTransform())) {
+            continue;
+        }
+        detectionsById[robot.robot_id()].push_back(&robot);
+    }
+
+    for (const auto &[id, detections] : detectionsById) {
+        if (detections.size() == 1) {
+            trackRobot(robotMap, *detections.front(), sourceTime, cameraId, visionProcessingDelay, teamIsYellow);
+        } else {
+            // multiple detections of the same id, e.g. due to overlapping cameras or misdetections
+            assignRobotDetections(robotMap[id], detections, sourceTime, cameraId, visionProcessingDelay, teamIsYellow);
+        }
+    }
+}
+
+void Tracker::assignRobotDetections(QList<RobotFilter*> &filters, const std::vector<const SSL_DetectionRobot*> &detections, qint64 sourceTime,
+                                    qint32 cameraId, qint64 visionProcessingDelay, bool teamIsYellow)
+{
+    // there is one filter per camera in which a robot is visible, thus the detections are
+    // assigned separately to the filters of every primary camera
+    std::map<qint32, std::vector<RobotFilter*>> filtersByCamera;
+    for (RobotFilter *filter : filters) {
+        filter->update(sourceTime);
+        filtersByCamera[filter->primaryCamera()].push_back(filter);
+    }
+
+    // all distances have to be computed before any detection is added to a filter
+    std::vector<FilterByCamera> nearestFilterByCamera(detections.size());
+    for (const auto &[camera, cameraFilters] : filtersByCamera) {
+        std::vector<float> costs;
+        costs.reserve(detections.size() * cameraFilters.size());
+        for (const SSL_DetectionRobot *robot : detections) {
+            for (const RobotFilter *filter : cameraFilters) {
+                costs.push_back(robotDetectionDistance(filter, *robot, sourceTime, cameraId));
+            }
+        }
+
+        const std::vector<int> assignment = solveAssignment(costs, detections.size(), cameraFilters.size(), MAX_ROBOT_DISTANCE);
+        for (std::size_t i = 0; i < detections.size(); i++) {
+            if (assignment[i] >= 0) {
+                const float dist = costs[i * cameraFilters.size() + assignment[i]];
+                nearestFilterByCamera[i][camera] = {dist, cameraFilters[assignment[i]]};
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < detections.size(); i++) {
+        addRobotDetection(filters, nearestFilterByCamera[i], *detections[i], sourceTime, cameraId, visionProcessingDelay, teamIsYellow);
+    }
+}
+
 void Tracker::trackRobot(RobotMap &robotMap, const SSL_DetectionRobot &robot, qint64 sourceTime, qint32 cameraId,
                          qint64 visionProcessingDelay, bool teamIsYellow)
 {
@@ -579,48 +757,51 @@ void Tracker::trackRobot(RobotMap &robotMap, const SSL_DetectionRobot &robot, qi
     // Every filter gets the data from every camera (if the position matches),
     // but the primary camera for each filter is still important if the camera calibration is bad
 
-    const float MAX_DISTANCE = 0.5;
-    const qint64 PRIMARY_TIMEOUT = 42*1000*1000;
-
-    std::map<qint32, std::pair<float, RobotFilter*>> nearestFilterByCamera;
-    RobotFilter *totalClosest = nullptr;
-    float totalClosestDist = MAX_DISTANCE;
+    FilterByCamera nearestFilterByCamera;
 
     QList<RobotFilter*>& list = robotMap[robot.robot_id()];
     for (RobotFilter *filter : list) {
         filter->update(sourceTime);
-        const float dist = filter->distanceTo(robot);
-        if (dist > MAX_DISTANCE) {
-            continue;
-        }
-        const bool isYoung = sourceTime - filter->lastPrimaryTime() > PRIMARY_TIMEOUT;
-        if (static_cast<qint32>(filter->primaryCamera()) != cameraId && isYoung) {
+        const float dist = robotDetectionDistance(filter, robot, sourceTime, cameraId);
+        if (std::isinf(dist)) {
             continue;
         }
 
-        if (dist < totalClosestDist) {
-            totalClosestDist = dist;
-            totalClosest = filter;
-        }
-
         const auto f = nearestFilterByCamera.find(filter->primaryCamera());
-        if (f == nearestFilterByCamera.end() || dist < f->first) {
+        if (f == nearestFilterByCamera.end() || dist < f->second.first) {
             nearestFilterByCamera[filter->primaryCamera()] = {dist, filter};
         }
     }
 
+    addRobotDetection(list, nearestFilterByCamera, robot, sourceTime, cameraId, visionProcessingDelay, teamIsYellow);
+}
+
+void Tracker::addRobotDetection(QList<RobotFilter*> &filters, FilterByCamera &nearestFilterByCamera, const SSL_DetectionRobot &robot,
+                                qint64 sourceTime, qint32 cameraId, qint64 visionProcessingDelay, bool teamIsYellow)
+{
+    RobotFilter *totalClosest = nullptr;
+    float totalClosestDist = MAX_ROBOT_DISTANCE;
+    for (const auto &[id, data] : nearestFilterByCamera) {
+        if (data.first < totalClosestDist) {
+            totalClosestDist = data.first;
+            totalClosest = data.second;
+        }
+    }
+
     if (!totalClosest) {
         totalClosest = new RobotFilter(robot, sourceTime, teamIsYellow);
-        list.append(totalClosest);
+        filters.append(totalClosest);
         nearestFilterByCamera[cameraId] = {totalClosestDist, totalClosest};
+        countFilterEvent(&FilterStatistics::robotFiltersSpawned);
     }
 
     const auto ownCamera = nearestFilterByCamera.find(cameraId);
     const bool createOwnCameraFilter = ownCamera == nearestFilterByCamera.end();
     if (createOwnCameraFilter) {
         RobotFilter *filter = new RobotFilter(*totalClosest);
-        list.append(filter);
+        filters.append(filter);
         nearestFilterByCamera[cameraId] = {totalClosestDist, filter};
+        countFilterEvent(&FilterStatistics::robotFiltersSpawned);
     }
 
     for (const auto &[id, data] : nearestFilterByCamera) {
@@ -629,6 +810,18 @@ void Tracker::trackRobot(RobotMap &robotMap, const SSL_DetectionRobot &robot, qi
     }
 }
 
+void Tracker::updateFilterStatistics(qint64 currentTime)
+{
+    const qint64 STATISTICS_INTERVAL = 60E9; // 1 minute
+    if (m_filterStatisticsStart == 0 || currentTime < m_filterStatisticsStart) {
+        m_filterStatisticsStart = currentTime;
+    } else if (currentTime - m_filterStatisticsStart >= STATISTICS_INTERVAL) {
+        m_lastMinuteStatistics = m_currentMinuteStatistics;
+        m_currentMinuteStatistics = FilterStatistics();
+        m_filterStatisticsStart = currentTime;
+    }
+}
+
 void Tracker::queuePacket(const SSL_DetectionFrame &detection, qint64 time)
 {
     m_visionPackets.append(Packet(detection, time));
@@ -670,6 +863,16 @@ void Tracker::handleCommand(const amun::CommandTracking &command, qint64 time)
         m_visionTransmissionDelay = command.vision_transmission_delay();
     }
 
+    if (command.has_global_assignment()) {
+        m_globalAssignment = command.global_assignment();
+    }
+
+    if (command.has_max_ball_filters()) {
+        // the current ball filter is always kept
+        m_maxBallFilters = std::max(1, int(command.max_ball_filters()));
+        limitBallFilters();
+    }
+
     // allows resetting by the strategy
     if (command.reset()) {
         m_timeToReset = time;
@@ -20,13 +20,49 @@
 
 #include "backlogwriter.h"
 #include "logfilewriter.h"
+#include "loggroupcopier.h"
 #include "longlivingstatuscache.h"
 #include <QString>
 #include <QByteArray>
 #include <QCoreApplication>
+#include <QDataStream>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
 
-BacklogStatusSource::BacklogStatusSource(const QContiguousCache<QByteArray> &backlog, const QContiguousCache<qint64> &timings)
-    : m_packets(backlog)
+static const int GROUP_SIZE = LogGroupCopier::GROUPED_PACKAGES;
+
+// appends the offset table, the unused packet slots are empty
+static void appendOffsets(QByteArray &groupData, std::vector<qint32> offsets)
+{
+    offsets.resize(GROUP_SIZE, groupData.size());
+    QDataStream ds(&groupData, QIODevice::WriteOnly | QIODevice::Append);
+    ds.setVersion(QDataStream::Qt_4_6);
+    for (qint32 offset : offsets) {
+        ds << offset;
+    }
+}
+
+// returns a null status for invalid packets
+static Status parsePacket(const QByteArray &groupData, int index)
+{
+    const int packetDataSize = groupData.size() - int(sizeof(qint32)) * GROUP_SIZE;
+    if (index < 0 || index >= GROUP_SIZE || packetDataSize < 0) {
+        return Status();
+    }
+    const uchar *offsets = reinterpret_cast<const uchar*>(groupData.constData()) + packetDataSize;
+    const qint32 start = qFromBigEndian<qint32>(offsets + sizeof(qint32) * index);
+    const qint32 end = index + 1 < GROUP_SIZE ? qFromBigEndian<qint32>(offsets + sizeof(qint32) * (index + 1)) : packetDataSize;
+    if (start < 0 || end < start || end > packetDataSize) {
+        return Status();
+    }
+    Status status = Status::createArena();
+    status->ParseFromArray(groupData.constData() + start, end - start);
+    return status;
+}
+
+BacklogStatusSource::BacklogStatusSource(std::vector<QByteArray> &&groups, const QContiguousCache<qint64> &timings, LogCodec::Codec codec)
+    : m_groups(std::move(groups)), m_codec(codec)
 {
     m_timings.reserve(timings.size());
     for (int i = timings.firstIndex();i<=timings.lastIndex();i++) {
@@ -39,10 +75,12 @@ Status BacklogStatusSource::readStatus(int packet)
     if (packet < 0 || packet >= m_timings.size()) {
         return Status();
     }
-    QByteArray uncompressed = qUncompress(m_packets.at(packet + m_packets.firstIndex()));
-    Status status = Status::createArena();
-    status->ParseFromArray(uncompressed.data(), uncompressed.size());
-    return status;
+    const int group = packet / GROUP_SIZE;
+    if (group != m_group) {
+        m_groupData = m_codec.uncompress(m_groups[group]);
+        m_group = group;
+    }
+    return parsePacket(m_groupData, packet % GROUP_SIZE);
 }
 
 void BacklogStatusSource::readPackets(int startPacket, int count)
@@ -53,60 +91,192 @@ void BacklogStatusSource::readPackets(int startPacket, int count)
 }
 
 
-BacklogWriter::BacklogWriter(unsigned seconds) : m_packets(BACKLOG_SIZE_PER_SECOND * seconds), m_timings(BACKLOG_SIZE_PER_SECOND * seconds), m_cache(new LongLivingStatusCache(this))
+BacklogWriter::BacklogWriter(unsigned seconds) :
+    m_arenaSize(BACKLOG_BYTES_PER_SECOND * int(std::max(seconds, 1u))),
+    m_groups(std::max(BACKLOG_SIZE_PER_SECOND * int(seconds), GROUP_SIZE) / GROUP_SIZE + 1),
+    m_timings(std::max(BACKLOG_SIZE_PER_SECOND * int(seconds), GROUP_SIZE)),
+    m_cache(new LongLivingStatusCache(this)),
+    m_codec(LogCodec::defaultBacklogCodec(), QByteArray(), 1)
 {
+    // a reserved capacity is kept when the buffer is resized to zero
+    m_packageBuffer.reserve(256 * 1024);
+    m_packageBufferOffsets.reserve(GROUP_SIZE);
     connect(this, SIGNAL(clearData()), this, SLOT(clear()), Qt::QueuedConnection);
 }
 
+QByteArray BacklogWriter::groupAt(int index) const
+{
+    const Group &group = m_groups.at(m_groups.firstIndex() + index);
+    return QByteArray(m_arena.constData() + group.offset, group.size);
+}
+
+int BacklogWriter::usedBytes() const
+{
+    int bytes = 0;
+    for (int i = m_groups.firstIndex(); i <= m_groups.lastIndex(); i++) {
+        bytes += m_groups.at(i).size;
+    }
+    return bytes;
+}
+
 std::shared_ptr<StatusSource> BacklogWriter::makeStatusSource()
 {
-    return std::shared_ptr<StatusSource>(new BacklogStatusSource(m_packets, m_timings));
+    std::vector<QByteArray> groups;
+    groups.reserve(m_groups.size() + 1);
+    for (int i = 0; i < m_groups.size(); i++) {
+        groups.push_back(groupAt(i));
+    }
+    if (!m_packageBufferOffsets.empty()) {
+        QByteArray current = m_packageBuffer;
+        appendOffsets(current, m_packageBufferOffsets);
+        groups.push_back(m_codec.compress(current));
+    }
+    return std::shared_ptr<StatusSource>(new BacklogStatusSource(std::move(groups), m_timings, m_codec.codec()));
 }
 
 void BacklogWriter::handleStatus(const Status &status)
 {
-    QByteArray packetData;
-    packetData.resize(status->ByteSize());
-    if (status->IsInitialized() && status->SerializeToArray(packetData.data(), packetData.size())) {
-        if (m_packets.isFull()) {
-            Status discarded = packetFromByteArray(m_packets.first());
-            m_cache->handleStatus(discarded);
+    if (!status->IsInitialized()) {
+        return;
+    }
+    if (m_timings.isFull()) {
+        dropFirstGroup();
+    }
+
+    // serialize directly into the group
+    const int offset = m_packageBuffer.size();
+    const int size = status->ByteSize();
+    m_packageBuffer.resize(offset + size);
+    if (!status->SerializeToArray(m_packageBuffer.data() + offset, size)) {
+        m_packageBuffer.resize(offset);
+        return;
+    }
+    m_packageBufferOffsets.push_back(offset);
+    m_timings.append(status->time());
+
+    if (m_packageBufferOffsets.size() == std::size_t(GROUP_SIZE)) {
+        finishGroup();
+    }
+}
+
+void BacklogWriter::finishGroup()
+{
+    appendOffsets(m_packageBuffer, m_packageBufferOffsets);
+    // the packets are uncompressed before writing to a logfile
+    storeGroup(m_codec.compress(m_packageBuffer));
+    m_packageBuffer.resize(0);
+    m_packageBufferOffsets.clear();
+}
+
+void BacklogWriter::storeGroup(const QByteArray &compressed)
+{
+    const int size = compressed.size();
+    if (compressed.isEmpty() || size > m_arenaSize) {
+        // the group can not be stored, thus its statuses are dropped immediately
+        for (int i = 0; i < GROUP_SIZE && !m_timings.isEmpty(); i++) {
+            m_timings.removeLast();
+        }
+        dropPackets(m_packageBuffer, GROUP_SIZE);
+        return;
+    }
+    // allocated once, when it is actually used
+    if (m_arena.isEmpty()) {
+        m_arena.resize(m_arenaSize);
+    }
+
+    int position = m_arenaEnd;
+    if (position + size > m_arenaSize) {
+        // the end of the arena stays unused, the groups behind the newest one are the oldest ones
+        while (!m_groups.isEmpty() && m_groups.first().offset >= position) {
+            dropFirstGroup();
         }
-        // compress the status to save a lot of memory, but be quick
-        // the packets are uncompressed before writing to a logfile
-        m_packets.append(qCompress(packetData, 1));
-        m_timings.append(status->time());
+        position = 0;
     }
+    while (!m_groups.isEmpty() && m_groups.first().offset >= position && m_groups.first().offset < position + size) {
+        dropFirstGroup();
+    }
+    if (m_groups.isFull()) {
+        dropFirstGroup();
+    }
+
+    std::memcpy(m_arena.data() + position, compressed.constData(), size);
+    m_groups.append(Group{position, size});
+    m_arenaEnd = position + size;
 }
 
-Status BacklogWriter::packetFromByteArray(QByteArray packetData)
+void BacklogWriter::dropFirstGroup()
 {
-    QByteArray uncompressed = qUncompress(packetData);
-    Status status = Status::createArena();
-    status->ParseFromArray(uncompressed.data(), uncompressed.size());
-    return status;
+    if (m_groups.isEmpty()) {
+        return;
+    }
+    const Group group = m_groups.takeFirst();
+    for (int i = 0; i < GROUP_SIZE && !m_timings.isEmpty(); i++) {
+        m_timings.removeFirst();
+    }
+    const QByteArray compressed = QByteArray::fromRawData(m_arena.constData() + group.offset, group.size);
+    dropPackets(m_codec.uncompress(compressed), GROUP_SIZE);
+}
+
+void BacklogWriter::dropPackets(const QByteArray &groupData, int packetCount)
+{
+    // keep the long living information of the dropped statuses
+    for (int i = 0; i < packetCount; i++) {
+        const Status status = parsePacket(groupData, i);
+        if (!status.isNull()) {
+            m_cache->handleStatus(status);
+        }
+    }
 }
 
 void BacklogWriter::saveBacklog(QString filename/*, Status teamStatus*/, bool processEvents)
 {
-    if (m_packets.size() == 0) {
+    if (m_timings.size() == 0) {
         return;
     }
     emit enableBacklogSave(false);
+
+    // the arena is implicitly shared, statuses which are handled while saving do not modify this copy
+    const QByteArray arena = m_arena;
+    QList<Group> groups;
+    for (int i = m_groups.firstIndex(); i <= m_groups.lastIndex(); i++) {
+        groups.append(m_groups.at(i));
+    }
+    std::vector<qint64> timings;
+    timings.reserve(m_timings.size());
+    for (int i = m_timings.firstIndex(); i <= m_timings.lastIndex(); i++) {
+        timings.push_back(m_timings.at(i));
+    }
+    // the group which is not compressed yet
+    QByteArray current;
+    if (!m_packageBufferOffsets.empty()) {
+        current = m_packageBuffer;
+        appendOffsets(current, m_packageBufferOffsets);
+    }
+
+    // The backlog codec is only used in memory. The saved log is reencoded by the LogFileWriter,
+    // thus it uses the default log format and only the last group is partially filled.
     LogFileWriter writer;
     if (writer.open(filename)) {
         connect(m_cache, &LongLivingStatusCache::sendStatus, &writer, &LogFileWriter::writeStatus);
         m_cache->publish();
         disconnect(m_cache, &LongLivingStatusCache::sendStatus, &writer, &LogFileWriter::writeStatus);
 
-        QContiguousCache<QByteArray> packetCopy = m_packets;
-        packetCopy.normalizeIndexes();
-        for (int i = 0;i<packetCopy.size();i++) {
-            Status status = packetFromByteArray(packetCopy.at(packetCopy.firstIndex() + i));
-            writer.writeStatus(status);
+        for (int i = 0; i <= groups.size(); i++) {
+            const int count = std::min<int>(GROUP_SIZE, int(timings.size()) - i * GROUP_SIZE);
+            if (count <= 0) {
+                break;
+            }
+            const QByteArray groupData = i < groups.size()
+                    ? m_codec.uncompress(QByteArray::fromRawData(arena.constData() + groups[i].offset, groups[i].size)) : current;
+            for (int p = 0; p < count; p++) {
+                const Status status = parsePacket(groupData, p);
+                if (!status.isNull()) {
+                    writer.writeStatus(status);
+                }
+            }
 
             // process incoming status packages to avoid building up memory
-            if (i % 100 == 0 && processEvents) {
+            if (processEvents) {
                 QCoreApplication::processEvents();
             }
         }
@@ -119,6 +289,9 @@ void BacklogWriter::saveBacklog(QString filename/*, Status teamStatus*/, bool pr
 
 void BacklogWriter::clear()
 {
-    m_packets.clear();
+    m_groups.clear();
     m_timings.clear();
+    m_packageBuffer.resize(0);
+    m_packageBufferOffsets.clear();
+    m_arenaEnd = 0;
 }
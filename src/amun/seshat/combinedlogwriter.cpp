@@ -23,6 +23,7 @@
 #include "logfilewriter.h"
 #include "statussource.h"
 #include "longlivingstatuscache.h"
+#include "worldstatelog.h"
 
 #include <QThread>
 #include <QDateTime>
@@ -89,6 +90,10 @@ CombinedLogWriter::CombinedLogWriter(bool replay, int backlogLength) :
 
 CombinedLogWriter::~CombinedLogWriter()
 {
+    if (m_worldStateLog) {
+        // deleted before m_logFile, which stops the thread
+        m_worldStateLog->deleteLater();
+    }
     if (m_logFile) {
         connect(m_logFile, &LogFileWriter::destroyed, m_logFileThread, &QThread::quit, Qt::DirectConnection);
         m_logFile->deleteLater();
@@ -142,6 +147,14 @@ void CombinedLogWriter::handleCommand(Command comm) {
     if (recordCommand.has_use_logfile_location()) {
         useLogfileLocation(recordCommand.use_logfile_location());
     }
+    if (recordCommand.has_world_state_log()) {
+        // applies to the next recording
+        m_writeWorldStateLog = recordCommand.world_state_log();
+    }
+    if (recordCommand.has_log_summary()) {
+        // applies to the next recording
+        m_writeLogSummary = recordCommand.log_summary();
+    }
     if (recordCommand.has_run_logging() && recordCommand.for_replay() == m_isReplay) {
         QString overwriteFilename;
         if (recordCommand.has_overwrite_record_filename()) {
@@ -336,6 +349,7 @@ void CombinedLogWriter::recordButtonToggled(bool enabled, QString overwriteFilen
 
         // create log file and forward status
         m_logFile = new LogFileWriter();
+        m_logFile->setWriteSummary(m_writeLogSummary);
         if (!m_logFile->open(filename)) {
             delete m_logFile;
             m_logFile = nullptr;
@@ -353,9 +367,25 @@ void CombinedLogWriter::recordButtonToggled(bool enabled, QString overwriteFilen
             m_logFileThread->start();
         }
         m_logFile->moveToThread(m_logFileThread);
+
+        if (m_writeWorldStateLog) {
+            m_worldStateLog = new WorldStateLogWriter();
+            if (m_worldStateLog->open(WorldStateLogWriter::filenameForLog(filename))) {
+                connect(m_signalSource, SIGNAL(gotStatusForRecording(Status)), m_worldStateLog, SLOT(writeStatus(Status)));
+                m_worldStateLog->moveToThread(m_logFileThread);
+            } else {
+                // the log itself is still useful
+                delete m_worldStateLog;
+                m_worldStateLog = nullptr;
+            }
+        }
         m_logState = LogState::PENDING;
     } else {
         // defer log file deletion to happen in its thread
+        if (m_worldStateLog != nullptr) {
+            m_worldStateLog->deleteLater();
+            m_worldStateLog = nullptr;
+        }
         if (m_logFile != nullptr) {
             m_logFile->deleteLater();
             m_logFile = nullptr;
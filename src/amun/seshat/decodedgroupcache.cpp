@@ -0,0 +1,171 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "decodedgroupcache.h"
+
+DecodedGroupCache::DecodedGroupCache(const MappedLogFileReader &reader, std::size_t maxBytes, int prefetchGroups) :
+    m_reader(reader),
+    m_maxBytes(maxBytes),
+    m_prefetchGroups(prefetchGroups),
+    m_decoder(reader)
+{
+    m_prefetchThread = std::thread(&DecodedGroupCache::prefetch, this);
+}
+
+DecodedGroupCache::~DecodedGroupCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopPrefetch = true;
+    }
+    m_prefetchCondition.notify_all();
+    m_prefetchThread.join();
+}
+
+Status DecodedGroupCache::readStatus(int packet)
+{
+    const int group = m_reader.groupOfPacket(packet);
+    if (group < 0) {
+        return Status();
+    }
+
+    const QByteArray data = loadGroup(group);
+    if (data.isEmpty()) {
+        return Status();
+    }
+
+    requestPrefetch(group);
+    return m_reader.parsePacket(data, packet - m_reader.firstPacketOfGroup(group));
+}
+
+QByteArray DecodedGroupCache::loadGroup(int group)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_decodedCondition.wait(lock, [this, group] { return m_decoding.count(group) == 0; });
+    const auto it = m_groups.find(group);
+    if (it != m_groups.end()) {
+        m_statistics.hits++;
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+        return it->second.data;
+    }
+    m_statistics.misses++;
+    m_decoding.insert(group);
+    lock.unlock();
+
+    QByteArray data;
+    {
+        std::lock_guard<std::mutex> decoderLock(m_decoderMutex);
+        data = m_decoder.decompressGroup(group);
+    }
+
+    lock.lock();
+    m_decoding.erase(group);
+    if (!data.isEmpty()) {
+        insertGroup(group, data);
+    }
+    lock.unlock();
+    m_decodedCondition.notify_all();
+    return data;
+}
+
+void DecodedGroupCache::insertGroup(int group, const QByteArray &data)
+{
+    m_lru.push_front(group);
+    m_groups[group] = Entry{data, m_lru.begin()};
+    m_bytes += data.size();
+
+    // always keep the new group, even if it is larger than the limit
+    while (m_bytes > m_maxBytes && m_lru.size() > 1) {
+        const int evicted = m_lru.back();
+        m_lru.pop_back();
+        m_bytes -= m_groups[evicted].data.size();
+        m_groups.erase(evicted);
+    }
+}
+
+void DecodedGroupCache::requestPrefetch(int group)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (group == m_lastGroup) {
+            return;
+        }
+        if (m_lastGroup != -1) {
+            m_direction = group > m_lastGroup ? 1 : -1;
+        }
+        m_lastGroup = group;
+
+        // older requests are obsolete, the user has already moved on
+        m_prefetchRequests.clear();
+        for (int i = 1;i<=m_prefetchGroups;i++) {
+            const int next = group + i * m_direction;
+            if (next >= 0 && next < m_reader.groupCount() && m_groups.count(next) == 0 && m_decoding.count(next) == 0) {
+                m_prefetchRequests.push_back(next);
+            }
+        }
+    }
+    m_prefetchCondition.notify_one();
+}
+
+void DecodedGroupCache::prefetch()
+{
+    MappedLogFileReader::Decoder decoder(m_reader);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_prefetchCondition.wait(lock, [this] { return m_stopPrefetch || !m_prefetchRequests.empty(); });
+        if (m_stopPrefetch) {
+            return;
+        }
+        const int group = m_prefetchRequests.front();
+        m_prefetchRequests.erase(m_prefetchRequests.begin());
+        if (m_groups.count(group) > 0 || m_decoding.count(group) > 0) {
+            continue;
+        }
+        m_decoding.insert(group);
+
+        lock.unlock();
+        const QByteArray data = decoder.decompressGroup(group);
+        lock.lock();
+        m_decoding.erase(group);
+        if (!data.isEmpty()) {
+            insertGroup(group, data);
+            m_statistics.prefetched++;
+        }
+        m_decodedCondition.notify_all();
+    }
+}
+
+int DecodedGroupCache::cachedGroups() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return int(m_groups.size());
+}
+
+std::size_t DecodedGroupCache::cachedBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+DecodedGroupCache::Statistics DecodedGroupCache::statistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
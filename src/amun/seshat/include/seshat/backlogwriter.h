@@ -22,19 +22,22 @@
 #define BACKLOGWRITER_H
 
 #include "protobuf/status.h"
+#include "logcodec.h"
 #include "statussource.h"
+#include <QByteArray>
 #include <QContiguousCache>
 #include <QObject>
+#include <vector>
 
 class QString;
-class QByteArray;
 class LongLivingStatusCache;
 
 class BacklogStatusSource : public StatusSource
 {
     Q_OBJECT
 public:
-    BacklogStatusSource(const QContiguousCache<QByteArray> &backlog, const QContiguousCache<qint64> &timings);
+    // every group except the last one contains LogGroupCopier::GROUPED_PACKAGES packets, in the layout of the groups of a log
+    BacklogStatusSource(std::vector<QByteArray> &&groups, const QContiguousCache<qint64> &timings, LogCodec::Codec codec);
     ~BacklogStatusSource() override {}
     bool isOpen() const override { return true; }
 
@@ -48,11 +51,18 @@ public slots:
     void readPackets(int startPacket, int count) override;
 
 private:
-    QContiguousCache<QByteArray> m_packets;
+    std::vector<QByteArray> m_groups;
     QList<qint64> m_timings;
+    LogCodec m_codec;
+    // the last decompressed group, as the packets are usually read in order
+    int m_group = -1;
+    QByteArray m_groupData;
 };
 
 
+// The backlog is stored in groups of compressed statuses, like in a log.
+// The compressed groups are kept in a circular buffer of a fixed size,
+// the oldest groups are dropped once either the buffer or the maximum number of statuses is full.
 class BacklogWriter : public QObject
 {
     Q_OBJECT
@@ -60,6 +70,10 @@ public:
     BacklogWriter(unsigned seconds);
     std::shared_ptr<StatusSource> makeStatusSource();
 
+    // the used part of the buffer for the compressed groups, which is allocated with the first status
+    int usedBytes() const;
+    int packetCount() const { return m_timings.size(); }
+
 signals:
     void enableBacklogSave(bool enabled);
     void clearData();
@@ -72,15 +86,39 @@ public slots:
     void saveBacklog(QString filename/*, Status teamStatus*/, bool processEvents);
 
 private:
-    Status packetFromByteArray(QByteArray packetData);
+    struct Group
+    {
+        int offset;
+        int size;
+    };
+
+    void finishGroup();
+    void storeGroup(const QByteArray &compressed);
+    void dropFirstGroup();
+    void dropPackets(const QByteArray &groupData, int packetCount);
+    QByteArray groupAt(int index) const;
 
 private:
     // approximately, with both strategys running
     const int BACKLOG_SIZE_PER_SECOND = 570;
-
-    QContiguousCache<QByteArray> m_packets;
+    // compressed size of the statuses, also approximately
+    const int BACKLOG_BYTES_PER_SECOND = 1024 * 1024;
+
+    const int m_arenaSize;
+    QByteArray m_arena;
+    // end of the newest group in the arena
+    int m_arenaEnd = 0;
+    QContiguousCache<Group> m_groups;
+    // includes the packets of the group which is not compressed yet
     QContiguousCache<qint64> m_timings;
+
+    // statuses of the current group, the memory is reused for the following groups
+    QByteArray m_packageBuffer;
+    std::vector<qint32> m_packageBufferOffsets;
+
     LongLivingStatusCache *m_cache;
+    // compress the status to save a lot of memory, but be quick
+    LogCodec m_codec;
 
 };
 
@@ -0,0 +1,110 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// Blocking queue with a fixed capacity to pass work between threads.
+// The producer is slowed down once the consumer can not keep up.
+template<typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(std::size_t capacity) : m_capacity(capacity) {}
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // returns true if the queue was full and the call had to wait
+    bool push(T &&value)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        const bool wasFull = m_queue.size() >= m_capacity;
+        m_notFull.wait(lock, [this] { return m_queue.size() < m_capacity; });
+        m_queue.push_back(std::move(value));
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return wasFull;
+    }
+
+    // never waits, returns false and leaves the value untouched if the queue is full
+    bool tryPush(T &value)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_queue.size() >= m_capacity) {
+            return false;
+        }
+        m_queue.push_back(std::move(value));
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    // waits for the next value, returns false once the queue is closed and empty
+    bool pop(T &value)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this] { return !m_queue.empty() || m_closed; });
+        if (m_queue.empty()) {
+            return false;
+        }
+        value = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    // the remaining values can still be popped
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notEmpty.notify_all();
+    }
+
+    void reopen()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = false;
+    }
+
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_queue.size();
+    }
+
+private:
+    const std::size_t m_capacity;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<T> m_queue;
+    bool m_closed = false;
+};
+
+#endif // BOUNDEDQUEUE_H
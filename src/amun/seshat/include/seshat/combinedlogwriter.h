@@ -31,6 +31,7 @@
 #include <QMap>
 
 class LogFileWriter;
+class WorldStateLogWriter;
 class BacklogWriter;
 class QThread;
 class QDateTime;
@@ -84,6 +85,11 @@ private:
     QThread *m_backlogThread;
     LogFileWriter *m_logFile;
     QThread *m_logFileThread;
+    // lives in the log file thread as well
+    WorldStateLogWriter *m_worldStateLog = nullptr;
+    bool m_writeWorldStateLog = false;
+    // nothing reads the summaries yet, thus they have to be requested explicitly
+    bool m_writeLogSummary = false;
 
     QString m_yellowTeamName;
     QString m_blueTeamName;
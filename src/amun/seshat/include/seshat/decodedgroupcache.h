@@ -0,0 +1,103 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef DECODEDGROUPCACHE_H
+#define DECODEDGROUPCACHE_H
+
+#include "mappedlogfilereader.h"
+#include "protobuf/status.h"
+#include <QByteArray>
+#include <condition_variable>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Keeps the most recently used groups of a log decompressed, bounded by their decompressed size.
+// After each access the following groups in the direction of the access are decompressed on a background thread,
+// thus scrubbing back and forth around a position does not decompress any group twice.
+// Only the decompressed data is shared, every read parses a new status which may be modified by the caller.
+// readStatus may be called by multiple threads. Every group is decompressed only once, a read of a group
+// which is currently decompressed, e.g. by the prefetch, waits for that decompression.
+class DecodedGroupCache
+{
+public:
+    struct Statistics
+    {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 prefetched = 0;
+    };
+
+    // the reader has to outlive the cache
+    DecodedGroupCache(const MappedLogFileReader &reader, std::size_t maxBytes, int prefetchGroups = 2);
+    ~DecodedGroupCache();
+    DecodedGroupCache(const DecodedGroupCache&) = delete;
+    DecodedGroupCache& operator=(const DecodedGroupCache&) = delete;
+
+    Status readStatus(int packet);
+
+    int cachedGroups() const;
+    std::size_t cachedBytes() const;
+    Statistics statistics() const;
+
+private:
+    struct Entry
+    {
+        QByteArray data;
+        std::list<int>::iterator lruPosition;
+    };
+
+    // returns the cached group or decompresses it, returns an empty array if the group is corrupt
+    QByteArray loadGroup(int group);
+    // m_mutex must be locked
+    void insertGroup(int group, const QByteArray &data);
+    // updates the access direction and requests the following groups
+    void requestPrefetch(int group);
+    void prefetch();
+
+    const MappedLogFileReader &m_reader;
+    const std::size_t m_maxBytes;
+    const int m_prefetchGroups;
+    std::mutex m_decoderMutex;
+    MappedLogFileReader::Decoder m_decoder;
+
+    mutable std::mutex m_mutex;
+    int m_lastGroup = -1;
+    int m_direction = 1;
+    // front is the most recently used group
+    std::list<int> m_lru;
+    std::unordered_map<int, Entry> m_groups;
+    // groups which are currently decompressed
+    std::unordered_set<int> m_decoding;
+    std::condition_variable m_decodedCondition;
+    std::size_t m_bytes = 0;
+    Statistics m_statistics;
+
+    std::vector<int> m_prefetchRequests;
+    bool m_stopPrefetch = false;
+    std::condition_variable m_prefetchCondition;
+    std::thread m_prefetchThread;
+};
+
+#endif // DECODEDGROUPCACHE_H
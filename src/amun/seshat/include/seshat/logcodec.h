@@ -0,0 +1,74 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef LOGCODEC_H
+#define LOGCODEC_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <memory>
+
+// Compression of the package groups in a log file and of the backlog packets.
+// The codec of a log is stored in its header (log version 3), version 2 logs always use zlib.
+// An instance keeps the compression contexts between calls and must only be used by one thread at a time.
+class LogCodec
+{
+public:
+    // the values are stored in the log header, do not change them
+    enum Codec : qint32 {
+        Zlib = 0,
+        Zstd = 1,
+        Lz4 = 2
+    };
+
+    // level -1 uses the default level of the codec
+    explicit LogCodec(Codec codec = Zlib, const QByteArray &dictionary = QByteArray(), int level = -1);
+    ~LogCodec();
+    LogCodec(const LogCodec&) = delete;
+    LogCodec& operator=(const LogCodec&) = delete;
+
+    Codec codec() const { return m_codec; }
+    // only used by zstd, ignored by the other codecs
+    const QByteArray &dictionary() const { return m_dictionary; }
+
+    QByteArray compress(const QByteArray &data);
+    // returns an empty array if the data is corrupt
+    QByteArray uncompress(const QByteArray &data);
+
+    static bool isSupported(Codec codec);
+    static QString name(Codec codec);
+    // zstd if this build supports it, zlib otherwise. Log files use zlib unless LogFileWriter::setCompression is called
+    static Codec defaultLogCodec();
+    // prefers decompression speed, as the backlog is decompressed completely when it is saved
+    static Codec defaultBacklogCodec();
+    // trains a zstd dictionary from serialized statuses, returns an empty array on failure
+    static QByteArray trainDictionary(const QList<QByteArray> &samples, int maxSize = 64 * 1024);
+
+private:
+    struct Contexts;
+
+    const Codec m_codec;
+    const QByteArray m_dictionary;
+    const int m_level;
+    std::unique_ptr<Contexts> m_contexts;
+};
+
+#endif // LOGCODEC_H
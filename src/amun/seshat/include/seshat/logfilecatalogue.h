@@ -0,0 +1,69 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef LOGFILECATALOGUE_H
+#define LOGFILECATALOGUE_H
+
+#include "protobuf/logfile.pb.h"
+#include <QList>
+#include <QString>
+#include <QThread>
+
+// Persistent catalogue of the log ids of all logs in a directory, stored in a cache directory of the user.
+// Only logs which are new or whose size or modification time changed since the last scan are opened again,
+// these are read in parallel.
+class LogFileCatalogue
+{
+public:
+    struct Entry
+    {
+        enum State : qint32 {
+            Unreadable = 0,
+            // the first status has no log id
+            NoLogId = 1,
+            HasLogId = 2
+        };
+
+        QString filename;
+        qint64 size = -1;
+        // msecs since epoch
+        qint64 modified = 0;
+        State state = Unreadable;
+        logfile::Uid uid;
+        // why an unreadable log could not be opened
+        QString error;
+    };
+
+    // empty if the system provides no cache location
+    static QString defaultCacheDirectory();
+    // one catalogue per scanned directory, returns an empty string if cacheDirectory is empty
+    static QString catalogueFilename(const QString &directory, const QString &cacheDirectory = defaultCacheDirectory());
+    // returns the entries of all readable files with the ending .log, the file names are absolute paths.
+    // Passing an empty cacheDirectory disables the catalogue, thus all logs are read.
+    static QList<Entry> scanDirectory(const QString &directory, int threadCount = QThread::idealThreadCount(),
+                                      const QString &cacheDirectory = defaultCacheDirectory());
+
+private:
+    static Entry readEntry(const QString &filename);
+    static bool read(const QString &catalogue, QList<Entry> &entries);
+    static bool write(const QString &catalogue, const QList<Entry> &entries);
+};
+
+#endif // LOGFILECATALOGUE_H
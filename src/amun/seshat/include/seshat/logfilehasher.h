@@ -24,6 +24,7 @@
 #include <QString>
 #include "protobuf/status.h"
 
+class MappedLogFileReader;
 class SeqLogFileReader;
 
 class LogFileHasher
@@ -33,6 +34,8 @@ public:
     //although it has to call modifieing calls to reader, it restores the
     //original state by using a memento before returning
     static std::string hash(SeqLogFileReader& reader);
+    // hashes the start of the log, can be used concurrently with other readers of the mapped log
+    static std::string hash(const MappedLogFileReader& reader);
     static QString replace(QString logfile, QString output);
     const static qint32 HASHED_PACKAGES = 100;
 
@@ -0,0 +1,56 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef LOGFILEINDEX_H
+#define LOGFILEINDEX_H
+
+#include "seqlogfilereader.h"
+#include <QList>
+#include <QString>
+
+// Cached position of every packet of a log, which avoids scanning the whole log when opening it.
+// The index is stored in the user cache directory, logs and their directories are never modified.
+// It is only used if the size, modification time and fingerprint of the log still match
+// and a sample of the groups is at the indexed positions. Logs without groups (version 0 and 1) are not indexed.
+class LogFileIndex
+{
+public:
+    static QString defaultCacheDirectory();
+    // returns an empty string if there is no cache directory
+    static QString indexFilename(const QString &logFilename, const QString &cacheDirectory = defaultCacheDirectory());
+
+    // returns false if the log has no valid index
+    static bool read(const QString &logFilename, QList<SeqLogFileReader::Memento> &packets, QList<qint64> &timings,
+                     const QString &cacheDirectory = defaultCacheDirectory());
+    // the log file must be complete, i.e. closed by its writer
+    static bool write(const QString &logFilename, const QList<SeqLogFileReader::Memento> &packets, const QList<qint64> &timings,
+                      const QString &cacheDirectory = defaultCacheDirectory());
+    static void remove(const QString &logFilename, const QString &cacheDirectory = defaultCacheDirectory());
+
+    // same conditions as LogFileReader applies when scanning the log
+    static bool isValidTimeline(const QList<qint64> &timings);
+
+private:
+    static QByteArray fingerprint(const QString &logFilename, qint64 &size, qint64 &modified);
+    static bool checkGroups(const QString &logFilename, const QList<SeqLogFileReader::Memento> &packets,
+                            const QList<qint64> &timings, qint32 &groupCount);
+};
+
+#endif // LOGFILEINDEX_H
@@ -29,10 +29,14 @@
 #include <QDataStream>
 #include <QFile>
 #include <QList>
+#include <QMutex>
 
+#include <cstddef>
+#include <memory>
 #include <optional>
 
-class QMutex;
+class DecodedGroupCache;
+class MappedLogFileReader;
 
 class LogFileReader : public StatusSource
 {
@@ -61,6 +65,10 @@ public:
     Status readStatus(int packet) override;
 
     qint32 groupSize() const { return m_reader.groupSize(); }
+    // Keeps up to the given amount of decompressed groups and prefetches the following groups,
+    // which is only worth its memory and thread if the same groups are read repeatedly, e.g. by the playback.
+    // Disabled by default, a size of 0 disables the cache again.
+    void setGroupCacheSize(std::size_t bytes);
 
     QString logUID() override;
 
@@ -70,6 +78,8 @@ public slots:
 private:
     bool indexFile();
     void close();
+    // returns null for logs without groups
+    DecodedGroupCache *groupCache();
 
     QString m_errorMsg;
 
@@ -78,6 +88,13 @@ private:
     QList<qint64> m_timings;
     bool m_headerCorrect;
     SeqLogFileReader m_reader;
+
+    // created on the first read from the known packet index, the cache must be destroyed before the mapped reader
+    QMutex m_groupCacheMutex;
+    std::size_t m_groupCacheSize = 0;
+    bool m_groupCacheChecked = false;
+    std::unique_ptr<MappedLogFileReader> m_mappedReader;
+    std::unique_ptr<DecodedGroupCache> m_groupCache;
 };
 
 #endif // LOGFILEREADER_H
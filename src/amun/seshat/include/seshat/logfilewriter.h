@@ -22,25 +22,51 @@
 #define LOGFILEWRITER_H
 
 #include "protobuf/status.h"
+#include "boundedqueue.h"
+#include "logcodec.h"
 #include "logfilehasher.h"
+#include "logsummary.h"
 #include "statussource.h"
 #include <QObject>
 #include <QString>
 #include <QDataStream>
 #include <QFile>
 #include <QList>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 class QMutex;
 
+// The statuses are serialized by the calling thread, while the compression and
+// the file writes each run on a separate thread. The stages are connected by bounded queues,
+// thus the next group is filled while the previous ones are compressed and written.
+// writeStatus never waits for the compression, groups which do not fit into the queue are kept in memory.
 class LogFileWriter : public QObject
 {
     Q_OBJECT
 public:
+    struct Statistics
+    {
+        qint64 writtenStatuses = 0;
+        // statuses that could not be serialized or written to the file, or exceeded the memory limit
+        qint64 droppedStatuses = 0;
+        // statuses which were kept in memory as the compression did not catch up
+        qint64 backpressuredStatuses = 0;
+    };
+
     explicit LogFileWriter();
     ~LogFileWriter() override;
     LogFileWriter(const LogFileWriter &) = delete;
     LogFileWriter& operator=(const LogFileWriter &) = delete;
 
+    // applies to files opened afterwards, the dictionary is only used by zstd and stored in the log header.
+    // Logs are zlib compressed by default, as other codecs require a reader which supports log version 3.
+    void setCompression(LogCodec::Codec codec, const QByteArray &dictionary = QByteArray());
+    // applies to files opened afterwards, the summary is written next to the log when it is closed
+    void setWriteSummary(bool writeSummary) { m_writeSummary = writeSummary; }
     bool open(const QString &filename, bool ignoreHashing = false);
     void close();
     bool isOpen() const { return m_file.isOpen(); }
@@ -50,22 +76,56 @@ public:
 
     bool hasHash() const { return m_hashState == HashingState::HAS_HASHING; }
     logfile::Uid getHash() const { return m_hashStatus->log_id(); }
+    Statistics statistics() const;
 
 public slots:
     bool writeStatus(const Status &status);
 
 private:
+    struct PendingGroup
+    {
+        std::vector<qint64> timeStamps;
+        // serialized statuses followed by their offsets, compressed by the compression thread
+        QByteArray data;
+        // without the padding of the last group
+        int statusCount;
+    };
+
     void writePackageEntry(qint64 time, QByteArray &&data);
     void addFirstPackage(qint64 time, QByteArray &&data);
+    void finishGroup();
+    void queueSpilledGroups();
+    void compressGroups();
+    void writeGroups();
+    void writeIndex();
 
     mutable QMutex *m_mutex;
     QFile m_file;
+    // only used by the write thread while the file is open
     QDataStream m_stream;
     QByteArray m_packageBuffer;
+    LogCodec::Codec m_codecType;
+    QByteArray m_dictionary;
+    // only used by the compression thread while the file is open
+    std::unique_ptr<LogCodec> m_codec;
     int m_packageBufferCount;
     QList<qint64> m_timeStamps;
+
+    BoundedQueue<PendingGroup> m_compressionQueue;
+    // finished groups waiting for space in the compression queue, oldest first
+    std::deque<PendingGroup> m_spilledGroups;
+    BoundedQueue<PendingGroup> m_writeQueue;
+    std::thread m_compressionThread;
+    std::thread m_writeThread;
+
+    // written by the write thread
+    mutable std::mutex m_writtenMutex;
     QList<qint64> m_packetOffsets;
     qint64 m_writtenPackages;
+
+    std::atomic<qint64> m_writtenStatuses;
+    std::atomic<qint64> m_droppedStatuses;
+    std::atomic<qint64> m_backpressuredStatuses;
     LogFileHasher m_hasher;
     enum class HashingState {
         UNINITIALIZED, NEEDS_HASHING, HAS_HASHING
@@ -73,12 +133,21 @@ private:
     HashingState m_hashState = HashingState::UNINITIALIZED;
     Status m_hashStatus = Status(new amun::Status);
 
+    bool m_writeSummary = false;
+    bool m_summaryEnabled = false;
+    LogSummaryBuilder m_summaryBuilder;
+
     const static qint32 GROUPED_PACKAGES = 100;
     static_assert(GROUPED_PACKAGES >= LogFileHasher::HASHED_PACKAGES, "Grouped Packages have to be larger than hashed packages to make sure that the hash is produced before the first group is written to the disc");
     static_assert(LogFileHasher::HASHED_PACKAGES > 2, "Hashing way too few packages can result in unwanted collisions");
 
+    // groups which may be queued per stage before they are kept in memory
+    const static std::size_t MAX_QUEUED_GROUPS = 2;
+    // groups which are kept in memory before new groups are dropped
+    const static std::size_t MAX_SPILLED_GROUPS = 50;
+
     qint32 m_packageBufferOffsets[GROUPED_PACKAGES];
-    qint64 m_packageTimeStamps[LogFileHasher::HASHED_PACKAGES-2]; //Only to be used while HashingState::NEEDS_HASHING
+    qint64 m_packageTimeStamps[GROUPED_PACKAGES];
 };
 
 #endif // LOGFILEWRITER_H
@@ -0,0 +1,107 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef LOGGROUPCOPIER_H
+#define LOGGROUPCOPIER_H
+
+#include "logcodec.h"
+#include "protobuf/status.h"
+#include <QByteArray>
+#include <QDataStream>
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <memory>
+#include <vector>
+
+class MappedLogFileReader;
+
+// Writes packet ranges of existing grouped logs into a new log.
+// Groups which are copied completely and use the same compression as the output
+// are written verbatim, without decompressing them. Only the groups at the boundaries
+// of a range are decompressed and compressed again, the statuses are never parsed.
+// Thus a boundary group may be only partially filled, even in the middle of the log.
+// Such logs are marked as version 4, which is rejected by older readers. Otherwise zlib compressed logs
+// are written as version 2, which older readers can open, and logs using other codecs as version 3.
+// The statuses are not modified, i.e. their timestamps are retained.
+class LogGroupCopier
+{
+public:
+    const static qint32 GROUPED_PACKAGES = 100;
+
+    struct Statistics
+    {
+        int copiedGroups = 0;
+        int reencodedGroups = 0;
+        qint64 packets = 0;
+    };
+
+    LogGroupCopier();
+    ~LogGroupCopier();
+    LogGroupCopier(const LogGroupCopier&) = delete;
+    LogGroupCopier& operator=(const LogGroupCopier&) = delete;
+
+    // logs with a different compression can be copied as well, but their groups have to be reencoded
+    bool open(const QString &filename, LogCodec::Codec codec, const QByteArray &dictionary = QByteArray());
+    // writes the last group and the index, returns false if writing the log failed
+    bool close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorMsg() const { return m_errorMsg; }
+
+    // the packets have to be appended in chronological order
+    bool writeStatus(const Status &status);
+    // copies the packets [firstPacket, endPacket) of the log
+    bool append(const MappedLogFileReader &reader, int firstPacket, int endPacket);
+
+    Statistics statistics() const { return m_statistics; }
+
+private:
+    bool checkTime(qint64 time);
+    bool canCopyGroup(const MappedLogFileReader &reader) const;
+    void addPacket(qint64 time, const QByteArray &data);
+    void finishGroup();
+    void writeGroup(const std::vector<qint64> &timeStamps, const QByteArray &data);
+    bool insertCodecHeader();
+
+    QFile m_file;
+    QDataStream m_stream;
+    // position of the log version in the header
+    qint64 m_versionOffset = 0;
+    // a version 2 header ends here, the codec fields of later versions follow
+    qint64 m_groupSizeEnd = 0;
+    int m_version = 3;
+    bool m_lastGroupPartial = false;
+    bool m_hasPartialGroups = false;
+    std::unique_ptr<LogCodec> m_codec;
+    QString m_errorMsg;
+    Statistics m_statistics;
+    qint64 m_lastTime = 0;
+
+    // packets of the group which is reencoded
+    QByteArray m_packageBuffer;
+    std::vector<qint32> m_packageBufferOffsets;
+    std::vector<qint64> m_packageTimeStamps;
+
+    // one entry per packet slot, including the unused ones
+    QList<qint64> m_timeStamps;
+    QList<qint64> m_packetOffsets;
+};
+
+#endif // LOGGROUPCOPIER_H
@@ -0,0 +1,91 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef LOGSUMMARY_H
+#define LOGSUMMARY_H
+
+#include "protobuf/status.h"
+#include <QList>
+#include <QMap>
+#include <QString>
+
+// Low rate overview of a log, which is stored in a file next to the log.
+// It allows rendering a game overview and jumping to events without reading the log itself.
+struct LogSummary
+{
+    enum class EventType : qint32 {
+        // value is the SSL_Referee::Stage
+        Stage = 0,
+        // value is the amun::GameState::State
+        GameState = 1,
+        // value is the score of the yellow team, detail the one of the blue team
+        Score = 2,
+        // value is the amun::StatusStrategyWrapper::StrategyType
+        StrategyFailed = 3
+    };
+
+    struct Event
+    {
+        qint64 time;
+        EventType type;
+        qint32 value;
+        qint32 detail;
+    };
+
+    struct BallSample
+    {
+        qint64 time;
+        float x;
+        float y;
+    };
+
+    QList<Event> events;
+    // one position per BALL_SAMPLE_INTERVAL while the ball is visible
+    QList<BallSample> ball;
+
+    static const qint64 BALL_SAMPLE_INTERVAL = 1000000000LL;
+
+    static QString filenameForLog(const QString &logFilename);
+    static bool read(const QString &logFilename, LogSummary &summary);
+    static bool write(const QString &logFilename, const LogSummary &summary);
+    static void remove(const QString &logFilename);
+    // creates the summary for a log that was written without it
+    static bool create(const QString &logFilename);
+};
+
+// Extracts the summary from the statuses of a log, which must be passed in order.
+class LogSummaryBuilder
+{
+public:
+    void addStatus(const Status &status);
+    const LogSummary &summary() const { return m_summary; }
+    void clear();
+
+private:
+    LogSummary m_summary;
+    qint32 m_stage = -1;
+    qint32 m_state = -1;
+    qint32 m_yellowScore = -1;
+    qint32 m_blueScore = -1;
+    QMap<qint32, qint32> m_strategyStates;
+    qint64 m_lastBallSample = 0;
+};
+
+#endif // LOGSUMMARY_H
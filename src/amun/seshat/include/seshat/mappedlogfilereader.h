@@ -0,0 +1,121 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef MAPPEDLOGFILEREADER_H
+#define MAPPEDLOGFILEREADER_H
+
+#include "logcodec.h"
+#include "protobuf/status.h"
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <vector>
+
+// Random access reader for grouped logs (version 2 and 3), which maps the whole file into memory.
+// After open() the reader is immutable, thus any number of threads can read from it without locking.
+// Each thread decompresses the groups with its own Decoder.
+class MappedLogFileReader
+{
+public:
+    class Decoder
+    {
+    public:
+        explicit Decoder(const MappedLogFileReader &reader);
+        Decoder(const Decoder&) = delete;
+        Decoder& operator=(const Decoder&) = delete;
+
+        // returns a null status for invalid packets
+        Status readStatus(int packet);
+        // decompresses the group and parses all its packets, returns false if the group is corrupt
+        bool readGroup(int group, QList<Status> &statuses);
+        // returns the decompressed packets and offsets of a group, which can be passed to parsePacket
+        QByteArray decompressGroup(int group);
+
+    private:
+        bool loadGroup(int group);
+
+        const MappedLogFileReader &m_reader;
+        LogCodec m_codec;
+        int m_group = -1;
+        QByteArray m_groupData;
+    };
+
+    MappedLogFileReader() = default;
+    ~MappedLogFileReader();
+    MappedLogFileReader(const MappedLogFileReader&) = delete;
+    MappedLogFileReader& operator=(const MappedLogFileReader&) = delete;
+
+    // must not be called while decoders are in use
+    bool open(const QString &filename);
+    // uses the known packet index of the log instead of reading every group header.
+    // groupStarts contains the offset of the compressed data size of each group and the number of its first packet.
+    bool open(const QString &filename, const QList<qint64> &timings, const QList<QPair<qint64, int>> &groupStarts);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    QString fileName() const { return m_file.fileName(); }
+    QString errorMsg() const { return m_errorMsg; }
+    LogCodec::Codec codec() const { return m_codec; }
+    const QByteArray &dictionary() const { return m_dictionary; }
+
+    const QList<qint64> &timings() const { return m_timings; }
+    int packetCount() const { return m_timings.size(); }
+    int groupCount() const { return int(m_groups.size()); }
+    qint32 groupSize() const { return m_groupSize; }
+    int groupOfPacket(int packet) const;
+    int firstPacketOfGroup(int group) const { return m_groups[group].firstPacket; }
+    int packetCountOfGroup(int group) const { return m_groups[group].packetCount; }
+    // the compressed data as stored in the file, only valid as long as the reader is open
+    QByteArray compressedGroup(int group) const;
+    // parses a packet of a decompressed group, returns a null status for invalid packets
+    Status parsePacket(const QByteArray &groupData, int index) const;
+    // returns the serialized packet of a decompressed group without parsing it, empty for invalid packets
+    QByteArray packetData(const QByteArray &groupData, int index) const;
+
+private:
+    struct Group
+    {
+        // position of the compressed data in the file, the timestamps precede its length
+        qint64 dataOffset;
+        quint32 dataSize;
+        int firstPacket;
+        int packetCount;
+    };
+
+    bool mapFile(const QString &filename, qint64 &groupsOffset);
+    bool readHeader(qint64 &groupsOffset);
+    bool packetRange(const QByteArray &groupData, int index, qint32 &start, qint32 &end) const;
+    void indexGroups(qint64 offset);
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    QString m_errorMsg;
+
+    LogCodec::Codec m_codec = LogCodec::Zlib;
+    QByteArray m_dictionary;
+    qint32 m_groupSize = 0;
+    std::vector<Group> m_groups;
+    QList<qint64> m_timings;
+};
+
+#endif // MAPPEDLOGFILEREADER_H
@@ -27,7 +27,9 @@
 #include <QDataStream>
 #include <QFile>
 #include <QList>
+#include <memory>
 
+class LogCodec;
 class QMutex;
 
 // This class reads logfiles _sequentially_.
@@ -44,6 +46,8 @@ public:
         qint64 baseOffset;
         int groupIndex;
         friend class SeqLogFileReader;
+        friend class LogFileIndex;
+        friend class LogFileReader;
     };
     SeqLogFileReader();
     ~SeqLogFileReader();
@@ -71,6 +75,8 @@ public:
     static QList<Memento> createMementos(const QList<qint64>& offsets, qint32 groupedPackages);
 
     qint32 groupSize() const { return m_packageGroupSize; }
+    // version 4 logs may contain partially filled groups in the middle of the log
+    bool hasPartialGroups() const { return m_partialGroups; }
 
 private:
     bool readVersion();
@@ -90,8 +96,11 @@ private:
     std::unique_ptr<QFile> m_file;
     std::unique_ptr<QDataStream> m_stream;
 
+    // version 3 and 4 files are read as Version2, they only add the codec to the header
     enum Version { Version0, Version1, Version2 };
     Version m_version;
+    // decompresses the groups of version 2 and 3 files
+    std::unique_ptr<LogCodec> m_codec;
     // a group of Status packages and an array of offsets
     QByteArray m_currentGroup;
     QList<qint32> m_currentGroupOffsets;
@@ -101,6 +110,7 @@ private:
     int m_currentGroupMaxIndex;
     // how many packets are one group
     qint32 m_packageGroupSize;
+    bool m_partialGroups = false;
     qint64 m_baseOffset;
     bool m_readingTimstamps;
     // m_baseOffset for the first group
@@ -0,0 +1,129 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef WORLDSTATELOG_H
+#define WORLDSTATELOG_H
+
+#include "logcodec.h"
+#include "protobuf/status.h"
+#include "protobuf/world.pb.h"
+#include <QDataStream>
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <memory>
+#include <vector>
+
+// Positions and speeds of the world states of a log, stored as one array per field.
+// The robots of frame i are firstRobot[i] to firstRobot[i] + robotCount[i] - 1.
+struct WorldStateColumns
+{
+    struct Ball
+    {
+        // the other fields are zero for frames without ball
+        std::vector<quint8> valid;
+        std::vector<float> p_x, p_y, p_z;
+        std::vector<float> v_x, v_y, v_z;
+    };
+
+    struct Robots
+    {
+        std::vector<qint32> firstRobot;
+        std::vector<quint8> robotCount;
+        std::vector<quint32> id;
+        std::vector<float> p_x, p_y, phi;
+        std::vector<float> v_x, v_y, omega;
+    };
+
+    std::vector<qint64> time;
+    Ball ball;
+    Robots yellow;
+    Robots blue;
+
+    int frameCount() const { return int(time.size()); }
+    void addState(const world::State &state);
+    void clear();
+};
+
+// Companion file of a log which only contains the tracked world states.
+// The frames are written in compressed chunks, thus analysis tools can scan a whole game
+// without parsing any status.
+class WorldStateLogWriter : public QObject
+{
+    Q_OBJECT
+public:
+    WorldStateLogWriter();
+    ~WorldStateLogWriter() override;
+    WorldStateLogWriter(const WorldStateLogWriter&) = delete;
+    WorldStateLogWriter& operator=(const WorldStateLogWriter&) = delete;
+
+    static QString filenameForLog(const QString &logFilename);
+
+    bool open(const QString &filename);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+public slots:
+    void writeStatus(const Status &status);
+
+private:
+    void writeChunk();
+
+    QFile m_file;
+    QDataStream m_stream;
+    std::unique_ptr<LogCodec> m_codec;
+    WorldStateColumns m_chunk;
+};
+
+class WorldStateLogReader
+{
+public:
+    WorldStateLogReader();
+    WorldStateLogReader(const WorldStateLogReader&) = delete;
+    WorldStateLogReader& operator=(const WorldStateLogReader&) = delete;
+
+    bool open(const QString &filename);
+    QString errorMsg() const { return m_errorMsg; }
+
+    int chunkCount() const { return int(m_chunks.size()); }
+    qint64 chunkStartTime(int chunk) const { return m_chunks[chunk].startTime; }
+    qint64 chunkEndTime(int chunk) const { return m_chunks[chunk].endTime; }
+
+    // appends the frames of the chunk to the columns
+    bool readChunk(int chunk, WorldStateColumns &columns);
+    bool readAll(WorldStateColumns &columns);
+
+private:
+    struct Chunk
+    {
+        qint64 startTime;
+        qint64 endTime;
+        // position of the compressed columns
+        qint64 offset;
+    };
+
+    QFile m_file;
+    QDataStream m_stream;
+    std::unique_ptr<LogCodec> m_codec;
+    std::vector<Chunk> m_chunks;
+    QString m_errorMsg;
+};
+
+#endif // WORLDSTATELOG_H
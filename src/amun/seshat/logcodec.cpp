@@ -0,0 +1,246 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "logcodec.h"
+#include <QtEndian>
+#include <vector>
+
+#ifdef ZSTD_FOUND
+#include <zdict.h>
+#include <zstd.h>
+#endif
+#ifdef LZ4_FOUND
+#include <lz4.h>
+#endif
+
+// zstd and lz4 data is prefixed with the uncompressed size in big endian, just like qCompress does it
+static const int SIZE_PREFIX = sizeof(quint32);
+// the size prefix is read from the file and must not be trusted, a group of statuses never gets this large
+static const quint32 MAX_UNCOMPRESSED_SIZE = 256 * 1024 * 1024;
+// lz4 can not compress data by more than this factor
+static const qint64 LZ4_MAX_RATIO = 255;
+
+struct LogCodec::Contexts
+{
+#ifdef ZSTD_FOUND
+    ~Contexts()
+    {
+        // all free functions accept null pointers
+        ZSTD_freeCCtx(zstdCompress);
+        ZSTD_freeDCtx(zstdDecompress);
+        ZSTD_freeCDict(zstdCompressDictionary);
+        ZSTD_freeDDict(zstdDecompressDictionary);
+    }
+
+    ZSTD_CCtx *zstdCompress = nullptr;
+    ZSTD_DCtx *zstdDecompress = nullptr;
+    ZSTD_CDict *zstdCompressDictionary = nullptr;
+    ZSTD_DDict *zstdDecompressDictionary = nullptr;
+#endif
+};
+
+LogCodec::LogCodec(Codec codec, const QByteArray &dictionary, int level) :
+    m_codec(codec),
+    m_dictionary(codec == Zstd ? dictionary : QByteArray()),
+    m_level(level),
+    m_contexts(new Contexts)
+{
+}
+
+LogCodec::~LogCodec() = default;
+
+QByteArray LogCodec::compress(const QByteArray &data)
+{
+    if (m_codec == Zlib) {
+        return qCompress(data, m_level);
+    }
+
+    QByteArray result;
+#ifdef ZSTD_FOUND
+    if (m_codec == Zstd) {
+        const int level = m_level == -1 ? ZSTD_CLEVEL_DEFAULT : m_level;
+        // the contexts are only created on demand, most instances either compress or decompress
+        if (!m_contexts->zstdCompress) {
+            m_contexts->zstdCompress = ZSTD_createCCtx();
+            if (!m_dictionary.isEmpty()) {
+                m_contexts->zstdCompressDictionary = ZSTD_createCDict(m_dictionary.constData(), m_dictionary.size(), level);
+            }
+        }
+
+        result.resize(SIZE_PREFIX + int(ZSTD_compressBound(data.size())));
+        char *out = result.data() + SIZE_PREFIX;
+        const std::size_t capacity = result.size() - SIZE_PREFIX;
+        const std::size_t size = m_contexts->zstdCompressDictionary
+                ? ZSTD_compress_usingCDict(m_contexts->zstdCompress, out, capacity, data.constData(), data.size(), m_contexts->zstdCompressDictionary)
+                : ZSTD_compressCCtx(m_contexts->zstdCompress, out, capacity, data.constData(), data.size(), level);
+        if (ZSTD_isError(size)) {
+            return QByteArray();
+        }
+        result.resize(SIZE_PREFIX + int(size));
+    }
+#endif
+#ifdef LZ4_FOUND
+    if (m_codec == Lz4) {
+        result.resize(SIZE_PREFIX + LZ4_compressBound(data.size()));
+        const int size = LZ4_compress_default(data.constData(), result.data() + SIZE_PREFIX, data.size(), result.size() - SIZE_PREFIX);
+        if (size <= 0) {
+            return QByteArray();
+        }
+        result.resize(SIZE_PREFIX + size);
+    }
+#endif
+    if (result.isEmpty()) {
+        // codec is not supported by this build
+        return QByteArray();
+    }
+    qToBigEndian<quint32>(data.size(), result.data());
+    return result;
+}
+
+QByteArray LogCodec::uncompress(const QByteArray &data)
+{
+    if (m_codec == Zlib) {
+        return qUncompress(data);
+    }
+
+    if (data.size() < SIZE_PREFIX) {
+        return QByteArray();
+    }
+    const quint32 size = qFromBigEndian<quint32>(data.constData());
+    if (size > MAX_UNCOMPRESSED_SIZE) {
+        return QByteArray();
+    }
+    const char *in = data.constData() + SIZE_PREFIX;
+    const int inSize = data.size() - SIZE_PREFIX;
+    // reject inconsistent sizes before allocating the output
+    if (m_codec == Lz4 && qint64(size) > LZ4_MAX_RATIO * inSize + 16) {
+        return QByteArray();
+    }
+#ifdef ZSTD_FOUND
+    if (m_codec == Zstd) {
+        const unsigned long long frameSize = ZSTD_getFrameContentSize(in, inSize);
+        if (frameSize == ZSTD_CONTENTSIZE_ERROR || (frameSize != ZSTD_CONTENTSIZE_UNKNOWN && frameSize != size)) {
+            return QByteArray();
+        }
+    }
+#endif
+    QByteArray result(int(size), Qt::Uninitialized);
+
+#ifdef ZSTD_FOUND
+    if (m_codec == Zstd) {
+        if (!m_contexts->zstdDecompress) {
+            m_contexts->zstdDecompress = ZSTD_createDCtx();
+            if (!m_dictionary.isEmpty()) {
+                m_contexts->zstdDecompressDictionary = ZSTD_createDDict(m_dictionary.constData(), m_dictionary.size());
+            }
+        }
+
+        const std::size_t written = m_contexts->zstdDecompressDictionary
+                ? ZSTD_decompress_usingDDict(m_contexts->zstdDecompress, result.data(), size, in, inSize, m_contexts->zstdDecompressDictionary)
+                : ZSTD_decompressDCtx(m_contexts->zstdDecompress, result.data(), size, in, inSize);
+        if (ZSTD_isError(written) || written != size) {
+            return QByteArray();
+        }
+        return result;
+    }
+#endif
+#ifdef LZ4_FOUND
+    if (m_codec == Lz4) {
+        const int written = LZ4_decompress_safe(in, result.data(), inSize, int(size));
+        if (written < 0 || quint32(written) != size) {
+            return QByteArray();
+        }
+        return result;
+    }
+#endif
+    Q_UNUSED(in);
+    Q_UNUSED(inSize);
+    return QByteArray();
+}
+
+bool LogCodec::isSupported(Codec codec)
+{
+    switch (codec) {
+    case Zlib:
+        return true;
+    case Zstd:
+#ifdef ZSTD_FOUND
+        return true;
+#else
+        return false;
+#endif
+    case Lz4:
+#ifdef LZ4_FOUND
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+QString LogCodec::name(Codec codec)
+{
+    switch (codec) {
+    case Zlib:
+        return "zlib";
+    case Zstd:
+        return "zstd";
+    case Lz4:
+        return "lz4";
+    }
+    return QString("unknown codec %1").arg(qint32(codec));
+}
+
+LogCodec::Codec LogCodec::defaultLogCodec()
+{
+    return isSupported(Zstd) ? Zstd : Zlib;
+}
+
+LogCodec::Codec LogCodec::defaultBacklogCodec()
+{
+    return isSupported(Lz4) ? Lz4 : Zlib;
+}
+
+QByteArray LogCodec::trainDictionary(const QList<QByteArray> &samples, int maxSize)
+{
+#ifdef ZSTD_FOUND
+    QByteArray sampleBuffer;
+    std::vector<std::size_t> sampleSizes;
+    sampleSizes.reserve(samples.size());
+    for (const QByteArray &sample : samples) {
+        sampleBuffer.append(sample);
+        sampleSizes.push_back(sample.size());
+    }
+
+    QByteArray dictionary(maxSize, Qt::Uninitialized);
+    const std::size_t size = ZDICT_trainFromBuffer(dictionary.data(), maxSize, sampleBuffer.constData(),
+                                                   sampleSizes.data(), unsigned(sampleSizes.size()));
+    if (ZDICT_isError(size)) {
+        return QByteArray();
+    }
+    dictionary.resize(int(size));
+    return dictionary;
+#else
+    Q_UNUSED(samples);
+    Q_UNUSED(maxSize);
+    return QByteArray();
+#endif
+}
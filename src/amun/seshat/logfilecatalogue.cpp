@@ -0,0 +1,205 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "logfilecatalogue.h"
+#include "seqlogfilereader.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static const QString CATALOGUE_HEADER = "AMUN-RA LOG CATALOGUE";
+static const qint32 CATALOGUE_VERSION = 2;
+
+QString LogFileCatalogue::defaultCacheDirectory()
+{
+    const QString cache = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return cache.isEmpty() ? QString() : QDir(cache).filePath("logcatalogue");
+}
+
+QString LogFileCatalogue::catalogueFilename(const QString &directory, const QString &cacheDirectory)
+{
+    if (cacheDirectory.isEmpty()) {
+        return QString();
+    }
+    // the scanned directories must not be modified, thus the catalogue is named after the directory
+    const QByteArray path = QDir(directory).absolutePath().toUtf8();
+    const QString name = QCryptographicHash::hash(path, QCryptographicHash::Sha1).toHex();
+    return QDir(cacheDirectory).filePath(name + ".catalogue");
+}
+
+LogFileCatalogue::Entry LogFileCatalogue::readEntry(const QString &filename)
+{
+    Entry entry;
+    entry.filename = filename;
+
+    SeqLogFileReader reader;
+    if (!reader.open(filename)) {
+        entry.error = reader.errorMsg();
+        return entry;
+    }
+    const Status status = reader.readStatus();
+    if (status.isNull()) {
+        entry.error = "Reading the first status failed";
+        return entry;
+    }
+    if (status->has_log_id()) {
+        entry.state = Entry::HasLogId;
+        entry.uid = status->log_id();
+    } else {
+        entry.state = Entry::NoLogId;
+    }
+    return entry;
+}
+
+QList<LogFileCatalogue::Entry> LogFileCatalogue::scanDirectory(const QString &directory, int threadCount, const QString &cacheDirectory)
+{
+    const QString catalogue = catalogueFilename(directory, cacheDirectory);
+    QList<Entry> known;
+    if (!catalogue.isEmpty()) {
+        read(catalogue, known);
+    }
+    QHash<QString, int> knownIndex;
+    for (int i = 0; i < known.size(); i++) {
+        knownIndex.insert(known[i].filename, i);
+    }
+
+    QDir dir(directory);
+    const QFileInfoList files(dir.entryInfoList({"*.log"}, QDir::Files | QDir::Readable, QDir::Name));
+    std::vector<Entry> entries;
+    entries.reserve(files.size());
+    std::vector<std::size_t> outdated;
+    for (const QFileInfo &info : files) {
+        const QString filename = info.absoluteFilePath();
+        const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+        const auto it = knownIndex.constFind(filename);
+        if (it != knownIndex.constEnd() && known[*it].size == info.size() && known[*it].modified == modified) {
+            entries.push_back(known[*it]);
+            continue;
+        }
+        Entry entry;
+        entry.filename = filename;
+        entry.size = info.size();
+        entry.modified = modified;
+        entries.push_back(entry);
+        outdated.push_back(entries.size() - 1);
+    }
+
+    // reading the first group of a log is dominated by the decompression, thus the logs are read in parallel
+    std::atomic<std::size_t> nextEntry(0);
+    auto worker = [&]() {
+        for (std::size_t i = nextEntry++; i < outdated.size(); i = nextEntry++) {
+            Entry &entry = entries[outdated[i]];
+            const Entry read = readEntry(entry.filename);
+            entry.state = read.state;
+            entry.uid = read.uid;
+            entry.error = read.error;
+        }
+    };
+    threadCount = std::max(1, std::min(threadCount, int(outdated.size())));
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (int i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    QList<Entry> result;
+    result.reserve(int(entries.size()));
+    for (Entry &entry : entries) {
+        result.append(std::move(entry));
+    }
+    // removed logs also change the catalogue
+    if (!catalogue.isEmpty() && (!outdated.empty() || result.size() != known.size())) {
+        // failing to write the catalogue just means the next scan has to read the logs again
+        QDir().mkpath(cacheDirectory);
+        write(catalogue, result);
+    }
+    return result;
+}
+
+bool LogFileCatalogue::read(const QString &catalogue, QList<Entry> &entries)
+{
+    QFile file(catalogue);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_6);
+
+    QString header;
+    qint32 version;
+    qint32 count;
+    stream >> header >> version >> count;
+    if (stream.status() != QDataStream::Ok || header != CATALOGUE_HEADER || version != CATALOGUE_VERSION || count < 0) {
+        return false;
+    }
+
+    QList<Entry> readEntries;
+    for (qint32 i = 0; i < count; i++) {
+        Entry entry;
+        qint32 state;
+        QByteArray uid;
+        stream >> entry.filename >> entry.size >> entry.modified >> state >> uid >> entry.error;
+        if (stream.status() != QDataStream::Ok || !entry.uid.ParseFromArray(uid.constData(), uid.size())) {
+            return false;
+        }
+        entry.state = Entry::State(state);
+        readEntries.append(entry);
+    }
+    entries.swap(readEntries);
+    return true;
+}
+
+bool LogFileCatalogue::write(const QString &catalogue, const QList<Entry> &entries)
+{
+    // never leave a partially written catalogue behind
+    QSaveFile file(catalogue);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream << CATALOGUE_HEADER << CATALOGUE_VERSION << qint32(entries.size());
+    for (const Entry &entry : entries) {
+        QByteArray uid;
+        uid.resize(entry.uid.ByteSize());
+        entry.uid.SerializeToArray(uid.data(), uid.size());
+        stream << entry.filename << entry.size << entry.modified << qint32(entry.state) << uid << entry.error;
+    }
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
@@ -19,11 +19,11 @@
  ***************************************************************************/
 #include <iostream>
 #include <string>
-#include <QDir>
+#include <QFileInfo>
 #include <QSettings>
 
+#include "logfilecatalogue.h"
 #include "logfilefinder.h"
-#include "logfilereader.h"
 
 LogFileFinder::LogFileFinder()
 {
@@ -104,30 +104,25 @@ static LogFileFinder::LogFileQuality compareHash(const logfile::Uid& timeline, c
 
 void LogFileFinder::addDirectory(const QString& s, logfile::LogOffer* offers)
 {
-    QDir dir(s);
-    QFileInfoList files(dir.entryInfoList({"*.log"}, QDir::Files | QDir::Readable));
-    for(const QFileInfo &info : files) {
-        QString filename = info.absoluteFilePath();
-        SeqLogFileReader slfr;
-        auto* entry = offers->add_entries();
-        entry->mutable_uri()->set_path(filename.toStdString());
-        entry->set_name(info.fileName().toStdString());
-        if(!slfr.open(filename)) {
-            entry->set_quality(logfile::LogOfferEntry::UNREADABLE);
-            std::cout << slfr.errorMsg().toStdString() << std::endl; // TODO: stdout
+    // only logs which changed since the last search are read again
+    for (const LogFileCatalogue::Entry &log : LogFileCatalogue::scanDirectory(s)) {
+        if (log.state == LogFileCatalogue::Entry::HasLogId && !isPerfectMatch(m_hash, log.uid)) {
             continue;
         }
-        Status s = slfr.readStatus();
-        if (s.isNull()) {
+        auto* entry = offers->add_entries();
+        entry->mutable_uri()->set_path(log.filename.toStdString());
+        entry->set_name(QFileInfo(log.filename).fileName().toStdString());
+        switch (log.state) {
+        case LogFileCatalogue::Entry::Unreadable:
             entry->set_quality(logfile::LogOfferEntry::UNREADABLE);
-        } else if (!s->has_log_id()) {
+            std::cout << log.error.toStdString() << std::endl; // TODO: stdout
+            break;
+        case LogFileCatalogue::Entry::NoLogId:
             entry->set_quality(logfile::LogOfferEntry::UNKNOWN);// TODO: This way or Rehash and reask?
-        } else {
+            break;
+        case LogFileCatalogue::Entry::HasLogId:
             entry->set_quality(logfile::LogOfferEntry::PERFECT); // TODO: Offer some non-perfect matches in the future.
-            const logfile::Uid& uid = s->log_id();
-            if (!isPerfectMatch(m_hash, uid)) {
-                offers->mutable_entries()->RemoveLast();
-            }
+            break;
         }
     }
 }
@@ -19,6 +19,7 @@
  ***************************************************************************/
 
 #include "logfilehasher.h"
+#include "mappedlogfilereader.h"
 #include "seqlogfilereader.h"
 #include "logfilewriter.h"
 
@@ -86,6 +87,19 @@ std::string LogFileHasher::hash(SeqLogFileReader& reader)
     return hasher.takeResult();
 }
 
+std::string LogFileHasher::hash(const MappedLogFileReader& reader)
+{
+    MappedLogFileReader::Decoder decoder(reader);
+    LogFileHasher hasher;
+    for (int i=0; i < reader.packetCount() && i < HASHED_PACKAGES; ++i) {
+        Status current = decoder.readStatus(i);
+        if (!current.isNull()) {
+            hasher.add(current);
+        }
+    }
+    return hasher.takeResult();
+}
+
 QString LogFileHasher::replace(QString logname, QString output)
 {
 #ifndef Q_OS_WIN
@@ -0,0 +1,298 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "logfileindex.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+static const QString INDEX_HEADER = "AMUN-RA LOG INDEX";
+static const qint32 INDEX_VERSION = 3;
+// the start and the end of the log are hashed to detect modified logs
+static const qint64 FINGERPRINT_BLOCK_SIZE = 64 * 1024;
+// checking every group would need two seeks per group, which makes opening a long log slow
+static const int CHECKED_GROUPS = 16;
+// timestamps that are too far apart mean that the logfile is corrupt
+static const qint64 MAX_TIMESTAMP_GAP = 200000000000LL;
+
+QString LogFileIndex::defaultCacheDirectory()
+{
+    const QString cache = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return cache.isEmpty() ? QString() : QDir(cache).filePath("logindex");
+}
+
+QString LogFileIndex::indexFilename(const QString &logFilename, const QString &cacheDirectory)
+{
+    if (cacheDirectory.isEmpty()) {
+        return QString();
+    }
+    // logs may be in shared or read only directories, thus the index is named after the log
+    const QByteArray path = QFileInfo(logFilename).absoluteFilePath().toUtf8();
+    const QString name = QCryptographicHash::hash(path, QCryptographicHash::Sha1).toHex();
+    return QDir(cacheDirectory).filePath(name + ".index");
+}
+
+QByteArray LogFileIndex::fingerprint(const QString &logFilename, qint64 &size, qint64 &modified)
+{
+    QFile file(logFilename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    size = file.size();
+    modified = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(file.read(FINGERPRINT_BLOCK_SIZE));
+    if (size > FINGERPRINT_BLOCK_SIZE) {
+        file.seek(std::max(FINGERPRINT_BLOCK_SIZE, size - FINGERPRINT_BLOCK_SIZE));
+        hash.addData(file.read(FINGERPRINT_BLOCK_SIZE));
+    }
+    return hash.result();
+}
+
+bool LogFileIndex::checkGroups(const QString &logFilename, const QList<SeqLogFileReader::Memento> &packets,
+                               const QList<qint64> &timings, qint32 &groupCount)
+{
+    QFile file(logFilename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_6);
+
+    // only grouped logs (version 2 to 4) can be checked without reading every packet
+    QString name;
+    int version;
+    qint32 groupSize;
+    stream >> name >> version >> groupSize;
+    if (stream.status() != QDataStream::Ok || name != "AMUN-RA LOG" || version < 2 || version > 4 || groupSize <= 0) {
+        return false;
+    }
+
+    QList<int> groupStarts;
+    for (int i = 0; i < packets.size(); i++) {
+        if (packets[i].groupIndex == 0) {
+            groupStarts.append(i);
+        }
+    }
+    groupCount = groupStarts.size();
+    if (groupStarts.isEmpty()) {
+        return false;
+    }
+
+    // every group starts with the uncompressed timestamps of its packets, followed by the size of the compressed group.
+    // Check for a sample of the groups, always including the first and the last one, that they
+    // start with the indexed timestamp and end where the next group starts.
+    const int checkedGroups = std::min(CHECKED_GROUPS, groupCount);
+    for (int sample = 0; sample < checkedGroups; sample++) {
+        const int group = checkedGroups == 1 ? 0 : int(qint64(sample) * (groupCount - 1) / (checkedGroups - 1));
+        const SeqLogFileReader::Memento &packet = packets[groupStarts[group]];
+        const qint64 groupStart = packet.baseOffset - qint64(sizeof(qint64)) * groupSize;
+        if (!file.seek(groupStart)) {
+            return false;
+        }
+        qint64 time;
+        stream >> time;
+        if (!file.seek(packet.baseOffset)) {
+            return false;
+        }
+        quint32 size;
+        stream >> size;
+        if (stream.status() != QDataStream::Ok || time != timings[groupStarts[group]]) {
+            return false;
+        }
+        const qint64 groupEnd = packet.baseOffset + qint64(sizeof(quint32)) + size;
+        const qint64 nextGroupStart = group + 1 < groupCount
+                ? packets[groupStarts[group + 1]].baseOffset - qint64(sizeof(qint64)) * groupSize
+                : file.size();
+        if (groupEnd != nextGroupStart) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LogFileIndex::isValidTimeline(const QList<qint64> &timings)
+{
+    if (timings.isEmpty()) {
+        return false;
+    }
+    qint64 lastTime = 0;
+    for (qint64 time : timings) {
+        if (time == 0) {
+            return false;
+        }
+        if (lastTime != 0 && (time - lastTime < 0 || time - lastTime > MAX_TIMESTAMP_GAP)) {
+            return false;
+        }
+        lastTime = time;
+    }
+    return true;
+}
+
+bool LogFileIndex::read(const QString &logFilename, QList<SeqLogFileReader::Memento> &packets, QList<qint64> &timings,
+                        const QString &cacheDirectory)
+{
+    const QString filename = indexFilename(logFilename, cacheDirectory);
+    if (filename.isEmpty()) {
+        return false;
+    }
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_6);
+
+    QString header;
+    qint32 version;
+    qint64 indexedSize;
+    qint64 indexedModified;
+    QByteArray indexedFingerprint;
+    qint32 indexedGroupCount;
+    QByteArray compressed;
+    stream >> header >> version >> indexedSize >> indexedModified >> indexedFingerprint >> indexedGroupCount >> compressed;
+    if (stream.status() != QDataStream::Ok || header != INDEX_HEADER || version != INDEX_VERSION) {
+        return false;
+    }
+
+    qint64 size = -1;
+    qint64 modified = -1;
+    if (fingerprint(logFilename, size, modified) != indexedFingerprint || size != indexedSize || modified != indexedModified) {
+        return false;
+    }
+
+    const QByteArray data = qUncompress(compressed);
+    QDataStream ds(data);
+    ds.setVersion(QDataStream::Qt_4_6);
+    qint32 count;
+    ds >> count;
+    if (ds.status() != QDataStream::Ok || count <= 0 || data.size() < qint64(count) * qint64(2 * sizeof(qint64) + sizeof(qint32))) {
+        return false;
+    }
+
+    // the columns are delta encoded, which compresses well
+    QList<qint64> readTimings;
+    QList<SeqLogFileReader::Memento> readPackets;
+    readTimings.reserve(count);
+    readPackets.reserve(count);
+    qint64 time = 0;
+    for (qint32 i = 0; i < count; i++) {
+        qint64 delta;
+        ds >> delta;
+        time += delta;
+        readTimings.append(time);
+    }
+    qint64 baseOffset = 0;
+    for (qint32 i = 0; i < count; i++) {
+        qint64 delta;
+        ds >> delta;
+        baseOffset += delta;
+        readPackets.append(SeqLogFileReader::Memento(baseOffset, 0));
+    }
+    for (qint32 i = 0; i < count; i++) {
+        ds >> readPackets[i].groupIndex;
+    }
+    if (ds.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    // the fingerprint does not cover the middle of the log, thus also check some of the groups
+    qint32 groupCount = 0;
+    if (!checkGroups(logFilename, readPackets, readTimings, groupCount) || groupCount != indexedGroupCount) {
+        return false;
+    }
+
+    packets.swap(readPackets);
+    timings.swap(readTimings);
+    return true;
+}
+
+bool LogFileIndex::write(const QString &logFilename, const QList<SeqLogFileReader::Memento> &packets, const QList<qint64> &timings,
+                         const QString &cacheDirectory)
+{
+    const QString filename = indexFilename(logFilename, cacheDirectory);
+    if (filename.isEmpty() || packets.size() != timings.size() || !isValidTimeline(timings)) {
+        return false;
+    }
+
+    qint64 size = -1;
+    qint64 modified = -1;
+    const QByteArray logFingerprint = fingerprint(logFilename, size, modified);
+    if (logFingerprint.isEmpty()) {
+        return false;
+    }
+    qint32 groupCount = 0;
+    if (!checkGroups(logFilename, packets, timings, groupCount)) {
+        return false;
+    }
+
+    QByteArray data;
+    {
+        QDataStream ds(&data, QIODevice::WriteOnly);
+        ds.setVersion(QDataStream::Qt_4_6);
+        ds << qint32(timings.size());
+        qint64 lastTime = 0;
+        for (qint64 time : timings) {
+            ds << time - lastTime;
+            lastTime = time;
+        }
+        qint64 lastOffset = 0;
+        for (const SeqLogFileReader::Memento &packet : packets) {
+            ds << packet.baseOffset - lastOffset;
+            lastOffset = packet.baseOffset;
+        }
+        for (const SeqLogFileReader::Memento &packet : packets) {
+            ds << qint32(packet.groupIndex);
+        }
+    }
+
+    if (!QDir().mkpath(cacheDirectory)) {
+        return false;
+    }
+    // never leave a partially written index behind
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream << INDEX_HEADER << INDEX_VERSION << size << modified << logFingerprint << groupCount << qCompress(data);
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+void LogFileIndex::remove(const QString &logFilename, const QString &cacheDirectory)
+{
+    const QString filename = indexFilename(logFilename, cacheDirectory);
+    if (!filename.isEmpty()) {
+        QFile::remove(filename);
+    }
+}
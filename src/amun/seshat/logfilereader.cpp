@@ -19,11 +19,13 @@
  ***************************************************************************/
 
 #include "logfilereader.h"
+#include "decodedgroupcache.h"
+#include "logfileindex.h"
+#include "mappedlogfilereader.h"
 
 #include <QMutex>
 #include <QMutexLocker>
 
-
 LogFileReader::LogFileReader()
 {
 }
@@ -80,11 +82,20 @@ bool LogFileReader::open(const QString &filename)
 
     m_headerCorrect = true;
 
-    // index the whole file
-    if (m_timings.size() == 0 && !indexFile()) {
+    if (m_timings.size() > 0) {
+        return true;
+    }
+
+    // use the persisted index if it still matches the log, otherwise index the whole file
+    if (LogFileIndex::read(filename, m_packets, m_timings)) {
+        return true;
+    }
+    if (!indexFile()) {
         m_reader.close();
         return false;
     }
+    // failing to write the index, e.g. without a cache directory, just means the next open has to scan again
+    LogFileIndex::write(filename, m_packets, m_timings);
 
     return true;
 }
@@ -92,6 +103,12 @@ bool LogFileReader::open(const QString &filename)
 void LogFileReader::close()
 {
     // cleanup everything and close file
+    {
+        QMutexLocker locker(&m_groupCacheMutex);
+        m_groupCache.reset();
+        m_mappedReader.reset();
+        m_groupCacheChecked = false;
+    }
     m_reader.close();
 
     m_errorMsg.clear();
@@ -103,7 +120,12 @@ bool LogFileReader::indexFile()
 {
     qint64 lastTime = 0;
     bool atEnd = false;
-    while (!m_reader.atEnd()) {
+    const qint32 groupSize = m_reader.groupSize();
+    for (qint64 slot = 0; !m_reader.atEnd(); slot++) {
+        // the LogGroupCopier leaves unused packet slots at the end of groups in the middle of version 4 logs
+        if (m_reader.hasPartialGroups() && slot % groupSize == 0) {
+            atEnd = false;
+        }
         SeqLogFileReader::Memento mem = m_reader.createMemento();
 
         qint64 time = m_reader.readTimestamp();
@@ -123,10 +145,10 @@ bool LogFileReader::indexFile()
             // remember the start of the current frame
             m_packets.append(mem);
             m_timings.append(time);
+            lastTime = time;
         } else {
             atEnd = true;
         }
-        lastTime = time;
     }
 
     if (m_packets.size() == 0) {
@@ -137,11 +159,62 @@ bool LogFileReader::indexFile()
     return true;
 }
 
+void LogFileReader::setGroupCacheSize(std::size_t bytes)
+{
+    QMutexLocker locker(&m_groupCacheMutex);
+    m_groupCache.reset();
+    m_mappedReader.reset();
+    m_groupCacheChecked = false;
+    m_groupCacheSize = bytes;
+}
+
+DecodedGroupCache *LogFileReader::groupCache()
+{
+    QMutexLocker locker(&m_groupCacheMutex);
+    if (m_groupCacheChecked || m_groupCacheSize == 0) {
+        return m_groupCache.get();
+    }
+    m_groupCacheChecked = true;
+
+    // old logs without groups are not supported by the mapped reader
+    if (m_reader.groupSize() <= 0) {
+        return nullptr;
+    }
+    // the packets of a group share its base offset and are numbered from the start of the group,
+    // other layouts can not be described by the mapped reader
+    QList<QPair<qint64, int>> groupStarts;
+    for (int i = 0;i<m_timings.size();i++) {
+        const SeqLogFileReader::Memento &packet = m_packets[i];
+        if (groupStarts.isEmpty() || groupStarts.back().first != packet.baseOffset) {
+            if (packet.groupIndex != 0) {
+                return nullptr;
+            }
+            groupStarts.append({packet.baseOffset, i});
+        } else if (packet.groupIndex != i - groupStarts.back().second) {
+            return nullptr;
+        }
+    }
+
+    m_mappedReader.reset(new MappedLogFileReader);
+    if (!m_mappedReader->open(m_reader.fileName(), m_timings, groupStarts)) {
+        m_mappedReader.reset();
+        return nullptr;
+    }
+    m_groupCache.reset(new DecodedGroupCache(*m_mappedReader, m_groupCacheSize));
+    return m_groupCache.get();
+}
+
 Status LogFileReader::readStatus(int packetNum)
 {
     if (packetNum < 0 || packetNum >= m_packets.size()) {
         return Status();
     }
+    if (DecodedGroupCache *cache = groupCache()) {
+        const Status status = cache->readStatus(packetNum);
+        if (!status.isNull()) {
+            return status;
+        }
+    }
     //seek to the requested packetgroup
     m_reader.applyMemento(m_packets.at(packetNum));
     return m_reader.readStatus();
@@ -21,12 +21,16 @@
 #include "logfilewriter.h"
 #include <QByteArray>
 #include <QMutexLocker>
+#include <algorithm>
 #include <functional>
 
+#include "logfileindex.h"
 #include "logfilereader.h"
 
 LogFileWriter::LogFileWriter() :
-    QObject(), m_stream(&m_file)
+    QObject(), m_stream(&m_file), m_codecType(LogCodec::Zlib),
+    m_compressionQueue(MAX_QUEUED_GROUPS), m_writeQueue(MAX_QUEUED_GROUPS),
+    m_writtenPackages(0), m_writtenStatuses(0), m_droppedStatuses(0), m_backpressuredStatuses(0)
 {
     m_mutex = new QMutex(QMutex::Recursive);
     // ensure compatibility across qt versions
@@ -43,15 +47,31 @@ LogFileWriter::~LogFileWriter()
 
 std::shared_ptr<StatusSource> LogFileWriter::makeStatusSource()
 {
-    auto packetOffsets(m_packetOffsets);
+    QMutexLocker locker(m_mutex);
+    QList<qint64> packetOffsets;
+    qint64 writtenPackages;
+    {
+        // only groups which are completely written can be read
+        std::lock_guard<std::mutex> writtenLock(m_writtenMutex);
+        packetOffsets = m_packetOffsets;
+        writtenPackages = m_writtenPackages;
+    }
     auto timeStamps(m_timeStamps);
-    packetOffsets.erase(packetOffsets.begin() + m_writtenPackages, packetOffsets.end());
-    timeStamps.erase(timeStamps.begin() + m_writtenPackages, timeStamps.end());
+    timeStamps.erase(timeStamps.begin() + writtenPackages, timeStamps.end());
     LogFileReader * reader = new LogFileReader(timeStamps, packetOffsets, GROUPED_PACKAGES);
     reader->open(m_file.fileName());
     return std::shared_ptr<StatusSource>(reader);
 }
 
+LogFileWriter::Statistics LogFileWriter::statistics() const
+{
+    Statistics statistics;
+    statistics.writtenStatuses = m_writtenStatuses;
+    statistics.droppedStatuses = m_droppedStatuses;
+    statistics.backpressuredStatuses = m_backpressuredStatuses;
+    return statistics;
+}
+
 static bool serializeStatus(std::function<void(LogFileWriter*, qint64, QByteArray&&)> lambda, const Status &status, LogFileWriter* self)
 {
     QByteArray data;
@@ -63,35 +83,72 @@ static bool serializeStatus(std::function<void(LogFileWriter*, qint64, QByteArra
     return false;
 }
 
+void LogFileWriter::setCompression(LogCodec::Codec codec, const QByteArray &dictionary)
+{
+    QMutexLocker locker(m_mutex);
+    m_codecType = codec;
+    m_dictionary = dictionary;
+}
+
 bool LogFileWriter::open(const QString &filename, bool ignoreHashing)
 {
     // lock for atomar opening
     QMutexLocker locker(m_mutex);
     close();
 
+    if (!LogCodec::isSupported(m_codecType)) {
+        return false;
+    }
+
     m_file.setFileName(filename);
+    // an index or summary of the previous file is no longer valid
+    LogFileIndex::remove(filename);
+    LogSummary::remove(filename);
     if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
         close();
         return false;
     }
 
+    m_codec.reset(new LogCodec(m_codecType, m_dictionary));
+
     // write log header
     m_stream << QString("AMUN-RA LOG");
-    m_stream << (int) 2; // log file version
-    m_stream << GROUPED_PACKAGES;
+    // zlib compressed logs stay readable by older versions
+    if (m_codecType == LogCodec::Zlib) {
+        m_stream << (int) 2; // log file version
+        m_stream << GROUPED_PACKAGES;
+    } else {
+        m_stream << (int) 3; // log file version
+        m_stream << GROUPED_PACKAGES;
+        m_stream << qint32(m_codec->codec());
+        m_stream << m_codec->dictionary();
+    }
 
     // initialize variables
     m_packageBufferCount = 0;
     m_packageBuffer.clear();
-    m_writtenPackages = 0;
+    m_timeStamps.clear();
     m_hasher.clear();
     m_hashState = HashingState::UNINITIALIZED;
     m_hashStatus->Clear();
+    m_summaryEnabled = m_writeSummary;
+    m_summaryBuilder.clear();
+    m_writtenPackages = 0;
+    m_packetOffsets.clear();
+    m_writtenStatuses = 0;
+    m_droppedStatuses = 0;
+    m_backpressuredStatuses = 0;
 
     if (ignoreHashing) {
         m_hashState = HashingState::HAS_HASHING;
     }
 
+    // the header is written, from now on only the write thread uses the file
+    m_compressionQueue.reopen();
+    m_writeQueue.reopen();
+    m_compressionThread = std::thread(&LogFileWriter::compressGroups, this);
+    m_writeThread = std::thread(&LogFileWriter::writeGroups, this);
+
     return true;
 }
 
@@ -103,23 +160,48 @@ void LogFileWriter::close()
         return;
     }
     if (m_hashState == HashingState::NEEDS_HASHING) {
-        //first: fill m_packageTimeStamps
-        while (m_packageBufferCount < LogFileHasher::HASHED_PACKAGES - 2) {
-            writePackageEntry(0, QByteArray());
-        }
-        //second: insert hash
+        //first: insert hash
         m_hashStatus->mutable_log_id()->add_parts()->set_hash(m_hasher.takeResult());
         serializeStatus(&LogFileWriter::addFirstPackage, m_hashStatus, this);
         m_hashState = HashingState::HAS_HASHING;
-        //third: continue as usual
+        //second: continue as usual
     }
 
-    // write the last header part and compressed data
+    // fill up the last group
     while (m_packageBufferCount > 0) {
         // packet with time 0 get discarded
         writePackageEntry(0, QByteArray());
     }
+    // wait until all groups are written
+    for (PendingGroup &group : m_spilledGroups) {
+        m_compressionQueue.push(std::move(group));
+    }
+    m_spilledGroups.clear();
+    m_compressionQueue.close();
+    m_compressionThread.join();
+    m_writeQueue.close();
+    m_writeThread.join();
     m_file.close();
+
+    writeIndex();
+    if (m_summaryEnabled) {
+        LogSummary::write(m_file.fileName(), m_summaryBuilder.summary());
+    }
+}
+
+void LogFileWriter::writeIndex()
+{
+    QList<qint64> timings = m_timeStamps;
+    QList<qint64> offsets = m_packetOffsets;
+    // the padding packets with time 0 at the end are not part of the index,
+    // logs with other invalid timestamps are rejected by LogFileIndex::write
+    while (!timings.isEmpty() && timings.back() == 0) {
+        timings.removeLast();
+    }
+    while (offsets.size() > timings.size()) {
+        offsets.removeLast();
+    }
+    LogFileIndex::write(m_file.fileName(), SeqLogFileReader::createMementos(offsets, GROUPED_PACKAGES), timings);
 }
 
 bool LogFileWriter::writeStatus(const Status &status)
@@ -130,6 +212,10 @@ bool LogFileWriter::writeStatus(const Status &status)
         return false;
     }
 
+    if (m_summaryEnabled) {
+        m_summaryBuilder.addStatus(status);
+    }
+
     bool serialize = true;
     if (m_hashState == HashingState::UNINITIALIZED && status->has_log_id()) {
         m_hashState = HashingState::HAS_HASHING;
@@ -151,8 +237,9 @@ bool LogFileWriter::writeStatus(const Status &status)
         m_hasher.clear();
     }
 
-    if (serialize) {
-        return serializeStatus(&LogFileWriter::writePackageEntry, status, this);
+    if (serialize && !serializeStatus(&LogFileWriter::writePackageEntry, status, this)) {
+        m_droppedStatuses++;
+        return false;
     }
     return true;
 }
@@ -161,24 +248,84 @@ void LogFileWriter::writePackageEntry(qint64 time, QByteArray&& data)
 {
     m_timeStamps.append(time);
 
+    m_packageTimeStamps[m_packageBufferCount] = time;
     m_packageBufferOffsets[m_packageBufferCount] = m_packageBuffer.size();
     m_packageBuffer.append(data);
-    if ( m_hashState != HashingState::NEEDS_HASHING) {
-        m_packetOffsets.append(m_file.pos());
-        m_stream << time;
-    } else {
-        m_packageTimeStamps[m_packageBufferCount] = time;
-    }
     m_packageBufferCount++;
     if (m_packageBufferCount == GROUPED_PACKAGES) {
-        QDataStream ds(&m_packageBuffer, QIODevice::WriteOnly | QIODevice::Append);
-        ds.setVersion(QDataStream::Qt_4_6);
-        for (qint32 offset: m_packageBufferOffsets) {
-            ds << offset;
+        finishGroup();
+    }
+}
+
+void LogFileWriter::finishGroup()
+{
+    QDataStream ds(&m_packageBuffer, QIODevice::WriteOnly | QIODevice::Append);
+    ds.setVersion(QDataStream::Qt_4_6);
+    for (qint32 offset: m_packageBufferOffsets) {
+        ds << offset;
+    }
+
+    PendingGroup group;
+    group.timeStamps.assign(m_packageTimeStamps, m_packageTimeStamps + GROUPED_PACKAGES);
+    group.data.swap(m_packageBuffer);
+    group.statusCount = std::count_if(group.timeStamps.begin(), group.timeStamps.end(), [](qint64 time) { return time != 0; });
+    m_packageBufferCount = 0;
+    m_packageBuffer.clear();
+
+    // keep the order of the groups, writeStatus must never wait for the compression
+    queueSpilledGroups();
+    if (m_spilledGroups.empty() && m_compressionQueue.tryPush(group)) {
+        return;
+    }
+    if (m_spilledGroups.size() >= MAX_SPILLED_GROUPS) {
+        // the group was not written, thus remove it from the packets of the log
+        m_timeStamps.erase(m_timeStamps.end() - GROUPED_PACKAGES, m_timeStamps.end());
+        m_droppedStatuses += group.statusCount;
+        return;
+    }
+    m_backpressuredStatuses += group.statusCount;
+    m_spilledGroups.push_back(std::move(group));
+}
+
+void LogFileWriter::queueSpilledGroups()
+{
+    while (!m_spilledGroups.empty() && m_compressionQueue.tryPush(m_spilledGroups.front())) {
+        m_spilledGroups.pop_front();
+    }
+}
+
+void LogFileWriter::compressGroups()
+{
+    PendingGroup group;
+    while (m_compressionQueue.pop(group)) {
+        group.data = m_codec->compress(group.data);
+        m_writeQueue.push(std::move(group));
+    }
+}
+
+void LogFileWriter::writeGroups()
+{
+    PendingGroup group;
+    while (m_writeQueue.pop(group)) {
+        const qint64 groupStart = m_file.pos();
+        for (qint64 time : group.timeStamps) {
+            m_stream << time;
+        }
+        m_stream << group.data;
+        // readers created by makeStatusSource must see the whole group
+        m_file.flush();
+
+        if (group.data.isEmpty() || m_stream.status() != QDataStream::Ok) {
+            m_droppedStatuses += group.statusCount;
+            m_stream.resetStatus();
+        } else {
+            m_writtenStatuses += group.statusCount;
+        }
+
+        std::lock_guard<std::mutex> writtenLock(m_writtenMutex);
+        for (int i = 0; i < GROUPED_PACKAGES; i++) {
+            m_packetOffsets.append(groupStart + sizeof(qint64) * i);
         }
-        m_stream << qCompress(m_packageBuffer);
-        m_packageBufferCount = 0;
-        m_packageBuffer.clear();
         m_writtenPackages += GROUPED_PACKAGES;
     }
 }
@@ -186,13 +333,11 @@ void LogFileWriter::writePackageEntry(qint64 time, QByteArray&& data)
 void LogFileWriter::addFirstPackage(qint64 time, QByteArray&& data)
 {
     m_timeStamps.prepend(time);
-    m_packetOffsets.append(m_file.pos());
-    m_stream << time;
-
-    for (qint64 oldTime : m_packageTimeStamps) {
-        m_packetOffsets.append(m_file.pos());
-        m_stream << oldTime;
+    // the group is not finished yet, as it is larger than the hashed packages
+    for (int i = m_packageBufferCount; i > 0; --i) {
+        m_packageTimeStamps[i] = m_packageTimeStamps[i - 1];
     }
+    m_packageTimeStamps[0] = time;
 
     qint32 oldOffset = m_packageBufferOffsets[0];
     qint32 firstLength = data.size();
@@ -0,0 +1,284 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "loggroupcopier.h"
+#include "logfileindex.h"
+#include "mappedlogfilereader.h"
+#include "seqlogfilereader.h"
+#include <algorithm>
+
+LogGroupCopier::LogGroupCopier() :
+    m_stream(&m_file)
+{
+    // ensure compatibility across qt versions
+    m_stream.setVersion(QDataStream::Qt_4_6);
+}
+
+LogGroupCopier::~LogGroupCopier()
+{
+    close();
+}
+
+bool LogGroupCopier::open(const QString &filename, LogCodec::Codec codec, const QByteArray &dictionary)
+{
+    close();
+    m_errorMsg.clear();
+
+    if (!LogCodec::isSupported(codec)) {
+        m_errorMsg = QString("%1 compression is not supported by this build!").arg(LogCodec::name(codec));
+        return false;
+    }
+
+    m_file.setFileName(filename);
+    // an index of the previous file is no longer valid
+    LogFileIndex::remove(filename);
+    // the groups are read again if the header has to grow on close
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        m_errorMsg = "Opening output file failed";
+        return false;
+    }
+    m_codec.reset(new LogCodec(codec, dictionary));
+
+    // the header of version 3 and 4 is identical, the version is updated on close if necessary
+    m_version = codec == LogCodec::Zlib ? 2 : 3;
+    m_stream << QString("AMUN-RA LOG");
+    m_versionOffset = m_file.pos();
+    m_stream << m_version; // log file version
+    m_stream << GROUPED_PACKAGES;
+    m_groupSizeEnd = m_file.pos();
+    if (m_version == 3) {
+        m_stream << qint32(m_codec->codec());
+        m_stream << m_codec->dictionary();
+    }
+
+    m_statistics = Statistics();
+    m_lastTime = 0;
+    m_packageBuffer.clear();
+    m_packageBufferOffsets.clear();
+    m_packageTimeStamps.clear();
+    m_timeStamps.clear();
+    m_packetOffsets.clear();
+    m_lastGroupPartial = false;
+    m_hasPartialGroups = false;
+    return true;
+}
+
+bool LogGroupCopier::close()
+{
+    if (!m_file.isOpen()) {
+        return false;
+    }
+    finishGroup();
+    bool success = true;
+    if (m_hasPartialGroups) {
+        success = m_version == 3 || insertCodecHeader();
+        m_file.seek(m_versionOffset);
+        m_stream << (int) 4; // log file version
+    }
+    success = success && m_stream.status() == QDataStream::Ok;
+    m_stream.resetStatus();
+    m_file.close();
+    m_codec.reset();
+
+    if (!success) {
+        m_errorMsg = "Writing output file failed";
+        return false;
+    }
+
+    // the unused packet slots are not part of the index
+    const QList<SeqLogFileReader::Memento> slotMementos = SeqLogFileReader::createMementos(m_packetOffsets, GROUPED_PACKAGES);
+    QList<SeqLogFileReader::Memento> packets;
+    QList<qint64> timings;
+    for (int i = 0; i < m_timeStamps.size(); i++) {
+        if (m_timeStamps[i] != 0) {
+            packets.append(slotMementos[i]);
+            timings.append(m_timeStamps[i]);
+        }
+    }
+    LogFileIndex::write(m_file.fileName(), packets, timings);
+    return true;
+}
+
+bool LogGroupCopier::checkTime(qint64 time)
+{
+    // the same conditions as for reading the log
+    if (time == 0 || (m_lastTime != 0 && !LogFileIndex::isValidTimeline({m_lastTime, time}))) {
+        m_errorMsg = "The packets are not in chronological order or too far apart";
+        return false;
+    }
+    return true;
+}
+
+bool LogGroupCopier::writeStatus(const Status &status)
+{
+    if (!isOpen() || !checkTime(status->time())) {
+        return false;
+    }
+    QByteArray data;
+    data.resize(status->ByteSize());
+    if (!status->IsInitialized() || !status->SerializeToArray(data.data(), data.size())) {
+        m_errorMsg = "Serializing status failed";
+        return false;
+    }
+    addPacket(status->time(), data);
+    return true;
+}
+
+bool LogGroupCopier::canCopyGroup(const MappedLogFileReader &reader) const
+{
+    return reader.groupSize() == GROUPED_PACKAGES && reader.codec() == m_codec->codec()
+            && (reader.codec() != LogCodec::Zstd || reader.dictionary() == m_codec->dictionary());
+}
+
+bool LogGroupCopier::append(const MappedLogFileReader &reader, int firstPacket, int endPacket)
+{
+    firstPacket = std::max(firstPacket, 0);
+    endPacket = std::min(endPacket, reader.packetCount());
+    if (!isOpen() || firstPacket >= endPacket) {
+        return isOpen();
+    }
+    if (!checkTime(reader.timings()[firstPacket])) {
+        return false;
+    }
+
+    const bool compatible = canCopyGroup(reader);
+    MappedLogFileReader::Decoder decoder(reader);
+    const int lastGroup = reader.groupOfPacket(endPacket - 1);
+    for (int group = reader.groupOfPacket(firstPacket); group <= lastGroup; group++) {
+        const int groupStart = reader.firstPacketOfGroup(group);
+        const int groupEnd = groupStart + reader.packetCountOfGroup(group);
+        const int start = std::max(groupStart, firstPacket);
+        const int end = std::min(groupEnd, endPacket);
+
+        if (compatible && start == groupStart && end == groupEnd) {
+            // the timestamps are the only part of the group that is not compressed
+            std::vector<qint64> timeStamps(GROUPED_PACKAGES, 0);
+            std::copy(reader.timings().begin() + start, reader.timings().begin() + end, timeStamps.begin());
+            finishGroup();
+            writeGroup(timeStamps, reader.compressedGroup(group));
+            m_statistics.copiedGroups++;
+            m_statistics.packets += end - start;
+            continue;
+        }
+
+        const QByteArray groupData = decoder.decompressGroup(group);
+        if (groupData.isEmpty()) {
+            m_errorMsg = QString("Group %1 of %2 is corrupt").arg(group).arg(reader.fileName());
+            return false;
+        }
+        for (int packet = start; packet < end; packet++) {
+            addPacket(reader.timings()[packet], reader.packetData(groupData, packet - groupStart));
+        }
+    }
+    m_lastTime = reader.timings()[endPacket - 1];
+
+    if (m_stream.status() != QDataStream::Ok) {
+        m_errorMsg = "Writing output file failed";
+        return false;
+    }
+    return true;
+}
+
+void LogGroupCopier::addPacket(qint64 time, const QByteArray &data)
+{
+    m_packageTimeStamps.push_back(time);
+    m_packageBufferOffsets.push_back(m_packageBuffer.size());
+    m_packageBuffer.append(data);
+    m_lastTime = time;
+    m_statistics.packets++;
+    if (m_packageTimeStamps.size() == GROUPED_PACKAGES) {
+        finishGroup();
+    }
+}
+
+void LogGroupCopier::finishGroup()
+{
+    if (m_packageTimeStamps.empty()) {
+        return;
+    }
+    // packets with time 0 get discarded by the readers
+    while (m_packageTimeStamps.size() < GROUPED_PACKAGES) {
+        m_packageTimeStamps.push_back(0);
+        m_packageBufferOffsets.push_back(m_packageBuffer.size());
+    }
+
+    QDataStream ds(&m_packageBuffer, QIODevice::WriteOnly | QIODevice::Append);
+    ds.setVersion(QDataStream::Qt_4_6);
+    for (qint32 offset : m_packageBufferOffsets) {
+        ds << offset;
+    }
+    writeGroup(m_packageTimeStamps, m_codec->compress(m_packageBuffer));
+    m_statistics.reencodedGroups++;
+
+    m_packageBuffer.clear();
+    m_packageBufferOffsets.clear();
+    m_packageTimeStamps.clear();
+}
+
+// moves all groups backwards to make room for the codec fields, only necessary if a version 2 log gets partial groups
+bool LogGroupCopier::insertCodecHeader()
+{
+    const qint64 COPY_CHUNK_SIZE = 1024 * 1024;
+
+    QByteArray codecHeader;
+    {
+        QDataStream ds(&codecHeader, QIODevice::WriteOnly);
+        ds.setVersion(QDataStream::Qt_4_6);
+        ds << qint32(m_codec->codec());
+        ds << m_codec->dictionary();
+    }
+
+    // the source and destination overlap, thus copy starting at the end
+    for (qint64 end = m_file.size(); end > m_groupSizeEnd;) {
+        const qint64 start = std::max(m_groupSizeEnd, end - COPY_CHUNK_SIZE);
+        if (!m_file.seek(start)) {
+            return false;
+        }
+        const QByteArray chunk = m_file.read(end - start);
+        if (chunk.size() != end - start || !m_file.seek(start + codecHeader.size())
+                || m_file.write(chunk) != chunk.size()) {
+            return false;
+        }
+        end = start;
+    }
+    if (!m_file.seek(m_groupSizeEnd) || m_file.write(codecHeader) != codecHeader.size()) {
+        return false;
+    }
+
+    for (qint64 &offset : m_packetOffsets) {
+        offset += codecHeader.size();
+    }
+    return true;
+}
+
+void LogGroupCopier::writeGroup(const std::vector<qint64> &timeStamps, const QByteArray &data)
+{
+    // only the last group of older log versions may be partially filled
+    m_hasPartialGroups = m_hasPartialGroups || m_lastGroupPartial;
+    m_lastGroupPartial = timeStamps[GROUPED_PACKAGES - 1] == 0;
+
+    const qint64 groupStart = m_file.pos();
+    for (int i = 0; i < GROUPED_PACKAGES; i++) {
+        m_stream << timeStamps[i];
+        m_timeStamps.append(timeStamps[i]);
+        m_packetOffsets.append(groupStart + sizeof(qint64) * i);
+    }
+    m_stream << data;
+}
@@ -0,0 +1,178 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "logsummary.h"
+#include "seqlogfilereader.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+static const QString SUMMARY_HEADER = "AMUN-RA LOG SUMMARY";
+static const qint32 SUMMARY_VERSION = 1;
+
+QString LogSummary::filenameForLog(const QString &logFilename)
+{
+    return logFilename + ".summary";
+}
+
+bool LogSummary::read(const QString &logFilename, LogSummary &summary)
+{
+    QFile file(filenameForLog(logFilename));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_6);
+
+    QString header;
+    qint32 version;
+    QByteArray compressed;
+    stream >> header >> version >> compressed;
+    if (stream.status() != QDataStream::Ok || header != SUMMARY_HEADER || version != SUMMARY_VERSION) {
+        return false;
+    }
+
+    const QByteArray data = qUncompress(compressed);
+    QDataStream ds(data);
+    ds.setVersion(QDataStream::Qt_4_6);
+    ds.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    LogSummary result;
+    qint32 eventCount;
+    ds >> eventCount;
+    for (qint32 i = 0; i < eventCount && ds.status() == QDataStream::Ok; i++) {
+        Event event;
+        qint32 type;
+        ds >> event.time >> type >> event.value >> event.detail;
+        event.type = EventType(type);
+        result.events.append(event);
+    }
+    qint32 ballCount;
+    ds >> ballCount;
+    for (qint32 i = 0; i < ballCount && ds.status() == QDataStream::Ok; i++) {
+        BallSample sample;
+        ds >> sample.time >> sample.x >> sample.y;
+        result.ball.append(sample);
+    }
+    if (ds.status() != QDataStream::Ok) {
+        return false;
+    }
+    summary = result;
+    return true;
+}
+
+bool LogSummary::write(const QString &logFilename, const LogSummary &summary)
+{
+    QByteArray data;
+    {
+        QDataStream ds(&data, QIODevice::WriteOnly);
+        ds.setVersion(QDataStream::Qt_4_6);
+        ds.setFloatingPointPrecision(QDataStream::SinglePrecision);
+        ds << qint32(summary.events.size());
+        for (const Event &event : summary.events) {
+            ds << event.time << qint32(event.type) << event.value << event.detail;
+        }
+        ds << qint32(summary.ball.size());
+        for (const BallSample &sample : summary.ball) {
+            ds << sample.time << sample.x << sample.y;
+        }
+    }
+
+    // never leave a partially written summary behind
+    QSaveFile file(filenameForLog(logFilename));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream << SUMMARY_HEADER << SUMMARY_VERSION << qCompress(data);
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+void LogSummary::remove(const QString &logFilename)
+{
+    QFile::remove(filenameForLog(logFilename));
+}
+
+bool LogSummary::create(const QString &logFilename)
+{
+    SeqLogFileReader reader;
+    if (!reader.open(logFilename)) {
+        return false;
+    }
+    LogSummaryBuilder builder;
+    while (!reader.atEnd()) {
+        const Status status = reader.readStatus();
+        if (!status.isNull()) {
+            builder.addStatus(status);
+        }
+    }
+    return write(logFilename, builder.summary());
+}
+
+void LogSummaryBuilder::addStatus(const Status &status)
+{
+    const qint64 time = status->time();
+    if (status->has_game_state()) {
+        const amun::GameState &gameState = status->game_state();
+        if (gameState.has_stage() && gameState.stage() != m_stage) {
+            m_stage = gameState.stage();
+            m_summary.events.append({time, LogSummary::EventType::Stage, m_stage, 0});
+        }
+        if (gameState.has_state() && gameState.state() != m_state) {
+            m_state = gameState.state();
+            m_summary.events.append({time, LogSummary::EventType::GameState, m_state, 0});
+        }
+        const qint32 yellowScore = gameState.yellow().score();
+        const qint32 blueScore = gameState.blue().score();
+        if (gameState.has_yellow() && gameState.has_blue() && (yellowScore != m_yellowScore || blueScore != m_blueScore)) {
+            m_yellowScore = yellowScore;
+            m_blueScore = blueScore;
+            m_summary.events.append({time, LogSummary::EventType::Score, yellowScore, blueScore});
+        }
+    }
+
+    if (status->has_status_strategy()) {
+        const qint32 type = status->status_strategy().type();
+        const qint32 state = status->status_strategy().status().state();
+        // only the transition to the failed state is an event
+        if (state == amun::StatusStrategy::FAILED && m_strategyStates.value(type, -1) != state) {
+            m_summary.events.append({time, LogSummary::EventType::StrategyFailed, type, 0});
+        }
+        m_strategyStates[type] = state;
+    }
+
+    if (status->has_world_state() && status->world_state().has_ball()
+            && (m_lastBallSample == 0 || time - m_lastBallSample >= LogSummary::BALL_SAMPLE_INTERVAL)) {
+        const world::Ball &ball = status->world_state().ball();
+        m_summary.ball.append({time, ball.p_x(), ball.p_y()});
+        m_lastBallSample = time;
+    }
+}
+
+void LogSummaryBuilder::clear()
+{
+    *this = LogSummaryBuilder();
+}
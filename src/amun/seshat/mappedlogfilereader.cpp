@@ -0,0 +1,296 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "mappedlogfilereader.h"
+#include <QDataStream>
+#include <QIODevice>
+#include <QtEndian>
+#include <algorithm>
+#include <limits>
+
+MappedLogFileReader::~MappedLogFileReader()
+{
+    close();
+}
+
+bool MappedLogFileReader::open(const QString &filename)
+{
+    qint64 groupsOffset;
+    if (!mapFile(filename, groupsOffset)) {
+        return false;
+    }
+    indexGroups(groupsOffset);
+    return true;
+}
+
+bool MappedLogFileReader::open(const QString &filename, const QList<qint64> &timings, const QList<QPair<qint64, int>> &groupStarts)
+{
+    qint64 groupsOffset;
+    if (!mapFile(filename, groupsOffset)) {
+        return false;
+    }
+
+    // only the bounds of the groups are checked, the timestamps are not read again
+    for (int i = 0;i<groupStarts.size();i++) {
+        const qint64 sizeOffset = groupStarts[i].first;
+        const int firstPacket = groupStarts[i].second;
+        const int nextPacket = i + 1 < groupStarts.size() ? groupStarts[i + 1].second : timings.size();
+        const qint64 dataOffset = sizeOffset + sizeof(quint32);
+        if ((i == 0 && firstPacket != 0) || sizeOffset < groupsOffset || dataOffset > m_size || nextPacket - firstPacket <= 0 || nextPacket - firstPacket > m_groupSize) {
+            close();
+            m_errorMsg = "Invalid packet index";
+            return false;
+        }
+        const quint32 dataSize = qFromBigEndian<quint32>(m_data + sizeOffset);
+        if (dataSize > quint32(std::numeric_limits<int>::max()) || dataOffset + dataSize > m_size) {
+            close();
+            m_errorMsg = "Invalid packet index";
+            return false;
+        }
+        m_groups.push_back(Group{dataOffset, dataSize, firstPacket, nextPacket - firstPacket});
+    }
+    m_timings = timings;
+    return true;
+}
+
+bool MappedLogFileReader::mapFile(const QString &filename, qint64 &groupsOffset)
+{
+    close();
+
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        close();
+        m_errorMsg = "Opening logfile failed";
+        return false;
+    }
+    m_size = m_file.size();
+    m_data = m_size > 0 ? m_file.map(0, m_size) : nullptr;
+    if (!m_data) {
+        close();
+        m_errorMsg = "Mapping logfile failed";
+        return false;
+    }
+
+    if (!readHeader(groupsOffset)) {
+        const QString error = m_errorMsg;
+        close();
+        m_errorMsg = error;
+        return false;
+    }
+    return true;
+}
+
+void MappedLogFileReader::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_errorMsg.clear();
+
+    m_codec = LogCodec::Zlib;
+    m_dictionary.clear();
+    m_groupSize = 0;
+    m_groups.clear();
+    m_timings.clear();
+}
+
+bool MappedLogFileReader::readHeader(qint64 &groupsOffset)
+{
+    // does not copy the mapped file, only the start of the file is relevant
+    const int headerSize = int(std::min<qint64>(m_size, std::numeric_limits<int>::max()));
+    const QByteArray header = QByteArray::fromRawData(reinterpret_cast<const char*>(m_data), headerSize);
+    QDataStream stream(header);
+    // ensure compatibility across qt versions
+    stream.setVersion(QDataStream::Qt_4_6);
+
+    QString name;
+    int version = 0;
+    stream >> name >> version;
+    if (name != "AMUN-RA LOG" || (version < 2 || version > 4)) {
+        m_errorMsg = "Only logs with grouped packages can be mapped!";
+        return false;
+    }
+
+    stream >> m_groupSize;
+    if (version >= 3) {
+        qint32 codec;
+        stream >> codec >> m_dictionary;
+        m_codec = LogCodec::Codec(codec);
+    }
+    if (stream.status() != QDataStream::Ok || m_groupSize <= 0) {
+        m_errorMsg = "File format not supported!";
+        return false;
+    }
+    if (!LogCodec::isSupported(m_codec)) {
+        m_errorMsg = QString("Log is compressed with %1, which is not supported by this build!").arg(LogCodec::name(m_codec));
+        return false;
+    }
+
+    groupsOffset = stream.device()->pos();
+    return true;
+}
+
+void MappedLogFileReader::indexGroups(qint64 offset)
+{
+    // every group consists of the timestamps, followed by the compressed data as a serialized QByteArray
+    const qint64 timestampsSize = sizeof(qint64) * m_groupSize;
+    // an incomplete group at the end, for example of a log which is still written, is ignored
+    while (offset + timestampsSize + qint64(sizeof(quint32)) <= m_size) {
+        const uchar *timestamps = m_data + offset;
+        const quint32 dataSize = qFromBigEndian<quint32>(m_data + offset + timestampsSize);
+        const qint64 dataOffset = offset + timestampsSize + sizeof(quint32);
+        // a null QByteArray has the size 0xffffffff
+        if (dataSize > quint32(std::numeric_limits<int>::max()) || dataOffset + dataSize > m_size) {
+            break;
+        }
+
+        Group group{dataOffset, dataSize, m_timings.size(), 0};
+        // time 0 marks the unused entries of the last group
+        while (group.packetCount < m_groupSize) {
+            const qint64 time = qFromBigEndian<qint64>(timestamps + sizeof(qint64) * group.packetCount);
+            if (time == 0) {
+                break;
+            }
+            m_timings.append(time);
+            group.packetCount++;
+        }
+        if (group.packetCount > 0) {
+            m_groups.push_back(group);
+        }
+        offset = dataOffset + dataSize;
+    }
+}
+
+int MappedLogFileReader::groupOfPacket(int packet) const
+{
+    if (packet < 0 || packet >= packetCount()) {
+        return -1;
+    }
+    const auto it = std::upper_bound(m_groups.begin(), m_groups.end(), packet, [](int p, const Group &group) {
+        return p < group.firstPacket;
+    });
+    return int(it - m_groups.begin()) - 1;
+}
+
+MappedLogFileReader::Decoder::Decoder(const MappedLogFileReader &reader) :
+    m_reader(reader),
+    m_codec(reader.m_codec, reader.m_dictionary)
+{
+}
+
+QByteArray MappedLogFileReader::Decoder::decompressGroup(int group)
+{
+    if (!loadGroup(group)) {
+        return QByteArray();
+    }
+    return m_groupData;
+}
+
+bool MappedLogFileReader::Decoder::loadGroup(int group)
+{
+    if (group == m_group) {
+        return true;
+    }
+    m_group = -1;
+    if (group < 0 || group >= m_reader.groupCount()) {
+        return false;
+    }
+
+    // the compressed data is read directly from the mapped file
+    m_groupData = m_codec.uncompress(m_reader.compressedGroup(group));
+
+    if (m_groupData.size() < int(sizeof(qint32)) * m_reader.m_groupSize) {
+        m_groupData.clear();
+        return false;
+    }
+    m_group = group;
+    return true;
+}
+
+QByteArray MappedLogFileReader::compressedGroup(int group) const
+{
+    if (group < 0 || group >= groupCount()) {
+        return QByteArray();
+    }
+    const Group &info = m_groups[group];
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(m_data + info.dataOffset), int(info.dataSize));
+}
+
+bool MappedLogFileReader::packetRange(const QByteArray &groupData, int index, qint32 &start, qint32 &end) const
+{
+    const int packetDataSize = groupData.size() - int(sizeof(qint32)) * m_groupSize;
+    if (index < 0 || index >= m_groupSize || packetDataSize < 0) {
+        return false;
+    }
+    const uchar *offsets = reinterpret_cast<const uchar*>(groupData.constData()) + packetDataSize;
+    start = qFromBigEndian<qint32>(offsets + sizeof(qint32) * index);
+    end = index + 1 < m_groupSize ? qFromBigEndian<qint32>(offsets + sizeof(qint32) * (index + 1)) : packetDataSize;
+    //check for invalid offsets
+    return start >= 0 && end >= start && end <= packetDataSize;
+}
+
+Status MappedLogFileReader::parsePacket(const QByteArray &groupData, int index) const
+{
+    qint32 start, end;
+    if (!packetRange(groupData, index, start, end)) {
+        return Status();
+    }
+
+    Status status = Status::createArena();
+    if (!status->ParseFromArray(groupData.constData() + start, end - start)) {
+        return Status();
+    }
+    return status;
+}
+
+QByteArray MappedLogFileReader::packetData(const QByteArray &groupData, int index) const
+{
+    qint32 start, end;
+    if (!packetRange(groupData, index, start, end)) {
+        return QByteArray();
+    }
+    return groupData.mid(start, end - start);
+}
+
+Status MappedLogFileReader::Decoder::readStatus(int packet)
+{
+    const int group = m_reader.groupOfPacket(packet);
+    if (group < 0 || !loadGroup(group)) {
+        return Status();
+    }
+    return m_reader.parsePacket(m_groupData, packet - m_reader.firstPacketOfGroup(group));
+}
+
+bool MappedLogFileReader::Decoder::readGroup(int group, QList<Status> &statuses)
+{
+    statuses.clear();
+    if (!loadGroup(group)) {
+        return false;
+    }
+    const int count = m_reader.packetCountOfGroup(group);
+    statuses.reserve(count);
+    for (int i = 0;i<count;i++) {
+        statuses.append(m_reader.parsePacket(m_groupData, i));
+    }
+    return true;
+}
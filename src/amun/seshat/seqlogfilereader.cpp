@@ -19,13 +19,15 @@
  ***************************************************************************/
 
 #include "seqlogfilereader.h"
+#include "logcodec.h"
 
 #include <QMutex>
 #include <QMutexLocker>
 
 SeqLogFileReader::SeqLogFileReader() :
     m_file(new QFile()),
-    m_stream(new QDataStream(m_file.get()))
+    m_stream(new QDataStream(m_file.get())),
+    m_codec(new LogCodec())
 {
     m_mutex = new QMutex(QMutex::Recursive);
     // ensure compatibility across qt versions
@@ -43,11 +45,13 @@ SeqLogFileReader::SeqLogFileReader(SeqLogFileReader&& o) :
     m_file(std::move(o.m_file)),
     m_stream(std::move(o.m_stream)),
     m_version(std::move(o.m_version)),
+    m_codec(std::move(o.m_codec)),
     m_currentGroup(std::move(o.m_currentGroup)),
     m_currentGroupOffsets(std::move(o.m_currentGroupOffsets)),
     m_currentGroupIndex(std::move(o.m_currentGroupIndex)),
     m_currentGroupMaxIndex(std::move(o.m_currentGroupMaxIndex)),
     m_packageGroupSize(std::move(o.m_packageGroupSize)),
+    m_partialGroups(std::move(o.m_partialGroups)),
     m_baseOffset(std::move(o.m_baseOffset)),
     m_readingTimstamps(std::move(o.m_readingTimstamps)),
     m_startOffset(std::move(o.m_startOffset))
@@ -55,6 +59,7 @@ SeqLogFileReader::SeqLogFileReader(SeqLogFileReader&& o) :
     //leave o in a valid state
     o.m_file.reset(new QFile());
     o.m_stream.reset(new QDataStream(o.m_file.get()));
+    o.m_codec.reset(new LogCodec());
 }
 
 bool SeqLogFileReader::open(const QString &filename)
@@ -76,6 +81,8 @@ bool SeqLogFileReader::open(const QString &filename)
     // packageGroupSize will be updated in readVersion, if a new Version is detected.
     // This makes sure that m_startOffset = m_baseOffset = m_file->pos(), which is important for .reset()
     m_packageGroupSize = 0;
+    m_partialGroups = false;
+    m_codec.reset(new LogCodec());
 
     // check for known version
     if (!readVersion()) {
@@ -141,7 +148,7 @@ bool SeqLogFileReader::readNextGroup()
     if (m_currentGroup.isEmpty()) {
         return false;
     }
-    m_currentGroup = qUncompress(m_currentGroup);
+    m_currentGroup = m_codec->uncompress(m_currentGroup);
     if (m_currentGroup.isEmpty()) {
         return false;
     }
@@ -188,6 +195,24 @@ bool SeqLogFileReader::readVersion()
             *m_stream >> m_packageGroupSize;
             break;
 
+        case 3:
+        case 4:
+        {
+            m_version = Version2;
+            m_partialGroups = v == 4;
+            *m_stream >> m_packageGroupSize;
+            qint32 codec;
+            QByteArray dictionary;
+            *m_stream >> codec >> dictionary;
+            if (!LogCodec::isSupported(LogCodec::Codec(codec))) {
+                m_errorMsg = QString("Log is compressed with %1, which is not supported by this build!")
+                        .arg(LogCodec::name(LogCodec::Codec(codec)));
+                return false;
+            }
+            m_codec.reset(new LogCodec(LogCodec::Codec(codec), dictionary));
+            break;
+        }
+
         default:
             m_errorMsg = "File format not supported!";
             return false;
@@ -30,6 +30,10 @@
 #include <QCoreApplication>
 #include <QFileInfo>
 #include <functional>
+#include <memory>
+
+// decompressed groups kept by the playback, which is enough for a few minutes of a typical game log
+static const std::size_t PLAYBACK_GROUP_CACHE_SIZE = 128 * 1024 * 1024;
 
 Seshat::Seshat(int backlogLength, QObject* parent) :
     QObject(parent),
@@ -236,6 +240,10 @@ void Seshat::openLogfile(const logfile::LogRequest& logRequest)
 
         if (openResult.first != nullptr) {
             auto logfile = openResult.first;
+            if (auto reader = std::dynamic_pointer_cast<LogFileReader>(logfile)) {
+                // scrubbing reads the groups around the current position again and again
+                reader->setGroupCacheSize(PLAYBACK_GROUP_CACHE_SIZE);
+            }
 
             sendLogfileInfo(QFileInfo(QString::fromStdString(filename)).fileName().toStdString(), false);
             setStatusSource(logfile);
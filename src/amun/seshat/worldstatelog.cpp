@@ -0,0 +1,323 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "worldstatelog.h"
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+static const QString WORLD_STATE_LOG_HEADER = "AMUN-RA WORLD STATE LOG";
+static const qint32 WORLD_STATE_LOG_VERSION = 1;
+// about ten seconds of a live game
+static const int CHUNK_FRAMES = 1000;
+
+// the columns are stored as little endian arrays
+template<std::size_t Size> struct RawColumnType;
+template<> struct RawColumnType<1> { using type = quint8; };
+template<> struct RawColumnType<4> { using type = quint32; };
+template<> struct RawColumnType<8> { using type = quint64; };
+
+template<typename T>
+static void appendColumn(QByteArray &data, const std::vector<T> &column)
+{
+    using Raw = typename RawColumnType<sizeof(T)>::type;
+    const int start = data.size();
+    data.resize(start + int(sizeof(T) * column.size()));
+    char *out = data.data() + start;
+    for (const T &value : column) {
+        Raw raw;
+        std::memcpy(&raw, &value, sizeof(T));
+        raw = qToLittleEndian(raw);
+        std::memcpy(out, &raw, sizeof(T));
+        out += sizeof(T);
+    }
+}
+
+template<typename T>
+static bool readColumn(const QByteArray &data, int &position, std::size_t count, std::vector<T> &column)
+{
+    using Raw = typename RawColumnType<sizeof(T)>::type;
+    if (position + sizeof(T) * count > std::size_t(data.size())) {
+        return false;
+    }
+    const char *in = data.constData() + position;
+    const std::size_t start = column.size();
+    column.resize(start + count);
+    for (std::size_t i = 0;i<count;i++) {
+        Raw raw;
+        std::memcpy(&raw, in + sizeof(T) * i, sizeof(T));
+        raw = qFromLittleEndian(raw);
+        std::memcpy(&column[start + i], &raw, sizeof(T));
+    }
+    position += int(sizeof(T) * count);
+    return true;
+}
+
+static void addRobots(WorldStateColumns::Robots &robots, const google::protobuf::RepeatedPtrField<world::Robot> &source)
+{
+    robots.firstRobot.push_back(qint32(robots.id.size()));
+    robots.robotCount.push_back(quint8(std::min(source.size(), 255)));
+    for (int i = 0;i<robots.robotCount.back();i++) {
+        const world::Robot &robot = source.Get(i);
+        robots.id.push_back(robot.id());
+        robots.p_x.push_back(robot.p_x());
+        robots.p_y.push_back(robot.p_y());
+        robots.phi.push_back(robot.phi());
+        robots.v_x.push_back(robot.v_x());
+        robots.v_y.push_back(robot.v_y());
+        robots.omega.push_back(robot.omega());
+    }
+}
+
+void WorldStateColumns::addState(const world::State &state)
+{
+    time.push_back(state.time());
+
+    const world::Ball &b = state.ball();
+    ball.valid.push_back(state.has_ball() ? 1 : 0);
+    ball.p_x.push_back(b.p_x());
+    ball.p_y.push_back(b.p_y());
+    ball.p_z.push_back(b.p_z());
+    ball.v_x.push_back(b.v_x());
+    ball.v_y.push_back(b.v_y());
+    ball.v_z.push_back(b.v_z());
+
+    addRobots(yellow, state.yellow());
+    addRobots(blue, state.blue());
+}
+
+void WorldStateColumns::clear()
+{
+    time.clear();
+    ball = Ball();
+    yellow = Robots();
+    blue = Robots();
+}
+
+static void appendRobots(QByteArray &data, const WorldStateColumns::Robots &robots)
+{
+    appendColumn(data, robots.robotCount);
+    appendColumn(data, robots.id);
+    appendColumn(data, robots.p_x);
+    appendColumn(data, robots.p_y);
+    appendColumn(data, robots.phi);
+    appendColumn(data, robots.v_x);
+    appendColumn(data, robots.v_y);
+    appendColumn(data, robots.omega);
+}
+
+static bool readRobots(const QByteArray &data, int &position, std::size_t frames, std::size_t robotCount, WorldStateColumns::Robots &robots)
+{
+    const std::size_t firstFrame = robots.robotCount.size();
+    if (!readColumn(data, position, frames, robots.robotCount)) {
+        return false;
+    }
+    qint32 first = qint32(robots.id.size());
+    std::size_t total = 0;
+    for (std::size_t i = firstFrame;i<robots.robotCount.size();i++) {
+        robots.firstRobot.push_back(first);
+        first += robots.robotCount[i];
+        total += robots.robotCount[i];
+    }
+    return total == robotCount
+            && readColumn(data, position, robotCount, robots.id)
+            && readColumn(data, position, robotCount, robots.p_x)
+            && readColumn(data, position, robotCount, robots.p_y)
+            && readColumn(data, position, robotCount, robots.phi)
+            && readColumn(data, position, robotCount, robots.v_x)
+            && readColumn(data, position, robotCount, robots.v_y)
+            && readColumn(data, position, robotCount, robots.omega);
+}
+
+WorldStateLogWriter::WorldStateLogWriter() :
+    m_stream(&m_file)
+{
+    // ensure compatibility across qt versions
+    m_stream.setVersion(QDataStream::Qt_4_6);
+}
+
+WorldStateLogWriter::~WorldStateLogWriter()
+{
+    close();
+}
+
+QString WorldStateLogWriter::filenameForLog(const QString &logFilename)
+{
+    return logFilename + ".world";
+}
+
+bool WorldStateLogWriter::open(const QString &filename)
+{
+    close();
+
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    m_codec.reset(new LogCodec(LogCodec::defaultLogCodec()));
+    m_chunk.clear();
+
+    m_stream << WORLD_STATE_LOG_HEADER;
+    m_stream << WORLD_STATE_LOG_VERSION;
+    m_stream << qint32(m_codec->codec());
+    return true;
+}
+
+void WorldStateLogWriter::close()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+    writeChunk();
+    m_file.close();
+}
+
+void WorldStateLogWriter::writeStatus(const Status &status)
+{
+    if (!m_file.isOpen() || !status->has_world_state()) {
+        return;
+    }
+    m_chunk.addState(status->world_state());
+    if (m_chunk.frameCount() >= CHUNK_FRAMES) {
+        writeChunk();
+    }
+}
+
+void WorldStateLogWriter::writeChunk()
+{
+    if (m_chunk.frameCount() == 0) {
+        return;
+    }
+
+    QByteArray columns;
+    const auto appendCount = [&columns](std::size_t count) {
+        appendColumn(columns, std::vector<qint32>{qint32(count)});
+    };
+    appendCount(m_chunk.time.size());
+    appendCount(m_chunk.yellow.id.size());
+    appendCount(m_chunk.blue.id.size());
+
+    appendColumn(columns, m_chunk.time);
+    appendColumn(columns, m_chunk.ball.valid);
+    appendColumn(columns, m_chunk.ball.p_x);
+    appendColumn(columns, m_chunk.ball.p_y);
+    appendColumn(columns, m_chunk.ball.p_z);
+    appendColumn(columns, m_chunk.ball.v_x);
+    appendColumn(columns, m_chunk.ball.v_y);
+    appendColumn(columns, m_chunk.ball.v_z);
+    appendRobots(columns, m_chunk.yellow);
+    appendRobots(columns, m_chunk.blue);
+
+    m_stream << qint32(m_chunk.frameCount());
+    m_stream << m_chunk.time.front();
+    m_stream << m_chunk.time.back();
+    m_stream << m_codec->compress(columns);
+    m_chunk.clear();
+}
+
+WorldStateLogReader::WorldStateLogReader() :
+    m_stream(&m_file)
+{
+    // ensure compatibility across qt versions
+    m_stream.setVersion(QDataStream::Qt_4_6);
+}
+
+bool WorldStateLogReader::open(const QString &filename)
+{
+    m_file.close();
+    m_chunks.clear();
+    m_errorMsg.clear();
+
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorMsg = "Opening world state log failed";
+        return false;
+    }
+
+    QString header;
+    qint32 version = 0;
+    qint32 codec = 0;
+    m_stream >> header >> version >> codec;
+    if (header != WORLD_STATE_LOG_HEADER || version != WORLD_STATE_LOG_VERSION) {
+        m_errorMsg = "File format not supported!";
+        return false;
+    }
+    if (!LogCodec::isSupported(LogCodec::Codec(codec))) {
+        m_errorMsg = QString("World state log is compressed with %1, which is not supported by this build!")
+                .arg(LogCodec::name(LogCodec::Codec(codec)));
+        return false;
+    }
+    m_codec.reset(new LogCodec(LogCodec::Codec(codec)));
+
+    // index the chunks, an incomplete chunk at the end is ignored
+    while (!m_stream.atEnd()) {
+        qint32 frames;
+        Chunk chunk;
+        quint32 size;
+        m_stream >> frames >> chunk.startTime >> chunk.endTime;
+        chunk.offset = m_file.pos();
+        m_stream >> size;
+        if (m_stream.status() != QDataStream::Ok || size == 0xffffffff || m_file.pos() + size > m_file.size()) {
+            break;
+        }
+        m_file.seek(m_file.pos() + size);
+        m_chunks.push_back(chunk);
+    }
+    m_stream.resetStatus();
+    return true;
+}
+
+bool WorldStateLogReader::readChunk(int chunk, WorldStateColumns &columns)
+{
+    if (chunk < 0 || chunk >= chunkCount()) {
+        return false;
+    }
+    m_file.seek(m_chunks[chunk].offset);
+    QByteArray compressed;
+    m_stream >> compressed;
+    const QByteArray data = m_codec->uncompress(compressed);
+
+    int position = 0;
+    std::vector<qint32> counts;
+    if (!readColumn(data, position, 3, counts) || counts[0] < 0 || counts[1] < 0 || counts[2] < 0) {
+        return false;
+    }
+    const std::size_t frames = counts[0];
+    return readColumn(data, position, frames, columns.time)
+            && readColumn(data, position, frames, columns.ball.valid)
+            && readColumn(data, position, frames, columns.ball.p_x)
+            && readColumn(data, position, frames, columns.ball.p_y)
+            && readColumn(data, position, frames, columns.ball.p_z)
+            && readColumn(data, position, frames, columns.ball.v_x)
+            && readColumn(data, position, frames, columns.ball.v_y)
+            && readColumn(data, position, frames, columns.ball.v_z)
+            && readRobots(data, position, frames, counts[1], columns.yellow)
+            && readRobots(data, position, frames, counts[2], columns.blue);
+}
+
+bool WorldStateLogReader::readAll(WorldStateColumns &columns)
+{
+    for (int i = 0;i<chunkCount();i++) {
+        if (!readChunk(i, columns)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "bodystate.h"
+#include <QDataStream>
+
+void camun::simulator::writeVector(QDataStream &stream, const btVector3 &vector)
+{
+    stream << vector.x() << vector.y() << vector.z();
+}
+
+btVector3 camun::simulator::readVector(QDataStream &stream)
+{
+    btScalar x, y, z;
+    stream >> x >> y >> z;
+    return btVector3(x, y, z);
+}
+
+void camun::simulator::writeTransform(QDataStream &stream, const btTransform &transform)
+{
+    // store the full basis, converting to a quaternion and back is not exact
+    for (int i = 0; i < 3; i++) {
+        writeVector(stream, transform.getBasis().getRow(i));
+    }
+    writeVector(stream, transform.getOrigin());
+}
+
+btTransform camun::simulator::readTransform(QDataStream &stream)
+{
+    const btVector3 row0 = readVector(stream);
+    const btVector3 row1 = readVector(stream);
+    const btVector3 row2 = readVector(stream);
+    const btVector3 origin = readVector(stream);
+    const btMatrix3x3 basis(row0.x(), row0.y(), row0.z(),
+                            row1.x(), row1.y(), row1.z(),
+                            row2.x(), row2.y(), row2.z());
+    return btTransform(basis, origin);
+}
+
+void camun::simulator::writeBodyState(QDataStream &stream, const btRigidBody *body)
+{
+    writeTransform(stream, body->getWorldTransform());
+    writeTransform(stream, body->getInterpolationWorldTransform());
+    writeVector(stream, body->getLinearVelocity());
+    writeVector(stream, body->getAngularVelocity());
+    writeVector(stream, body->getInterpolationLinearVelocity());
+    writeVector(stream, body->getInterpolationAngularVelocity());
+    stream << body->getLinearDamping() << body->getAngularDamping();
+    stream << qint32(body->getActivationState()) << body->getDeactivationTime();
+
+    // the robot and ball positions are read from the (interpolated) motion state
+    btTransform motionTransform = body->getWorldTransform();
+    if (body->getMotionState()) {
+        body->getMotionState()->getWorldTransform(motionTransform);
+    }
+    writeTransform(stream, motionTransform);
+}
+
+camun::simulator::BodyState camun::simulator::readBodyState(QDataStream &stream)
+{
+    BodyState state;
+    state.worldTransform = readTransform(stream);
+    state.interpolationWorldTransform = readTransform(stream);
+    state.linearVelocity = readVector(stream);
+    state.angularVelocity = readVector(stream);
+    state.interpolationLinearVelocity = readVector(stream);
+    state.interpolationAngularVelocity = readVector(stream);
+    stream >> state.linearDamping >> state.angularDamping;
+    stream >> state.activationState >> state.deactivationTime;
+    state.motionTransform = readTransform(stream);
+    return state;
+}
+
+void camun::simulator::applyBodyState(const BodyState &state, btRigidBody *body)
+{
+    body->setWorldTransform(state.worldTransform);
+    body->setInterpolationWorldTransform(state.interpolationWorldTransform);
+    body->setLinearVelocity(state.linearVelocity);
+    body->setAngularVelocity(state.angularVelocity);
+    body->setInterpolationLinearVelocity(state.interpolationLinearVelocity);
+    body->setInterpolationAngularVelocity(state.interpolationAngularVelocity);
+    body->setDamping(state.linearDamping, state.angularDamping);
+    body->forceActivationState(state.activationState);
+    body->setDeactivationTime(state.deactivationTime);
+    if (body->getMotionState()) {
+        body->getMotionState()->setWorldTransform(state.motionTransform);
+    }
+}
@@ -0,0 +1,57 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef BODYSTATE_H
+#define BODYSTATE_H
+
+#include <btBulletDynamicsCommon.h>
+#include <QtGlobal>
+
+class QDataStream;
+
+namespace camun {
+    namespace simulator {
+        void writeVector(QDataStream &stream, const btVector3 &vector);
+        btVector3 readVector(QDataStream &stream);
+        void writeTransform(QDataStream &stream, const btTransform &transform);
+        btTransform readTransform(QDataStream &stream);
+        // the dynamic state of a rigid body, its shape and mass are not included
+        struct BodyState
+        {
+            btTransform worldTransform;
+            btTransform interpolationWorldTransform;
+            btVector3 linearVelocity;
+            btVector3 angularVelocity;
+            btVector3 interpolationLinearVelocity;
+            btVector3 interpolationAngularVelocity;
+            btScalar linearDamping = 0;
+            btScalar angularDamping = 0;
+            qint32 activationState = 0;
+            btScalar deactivationTime = 0;
+            btTransform motionTransform;
+        };
+        void writeBodyState(QDataStream &stream, const btRigidBody *body);
+        // only parses the state, a restore has to be validated before the body is modified
+        BodyState readBodyState(QDataStream &stream);
+        void applyBodyState(const BodyState &state, btRigidBody *body);
+    }
+}
+
+#endif // BODYSTATE_H
@@ -0,0 +1,105 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "cameragrid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace camun::simulator;
+
+static const float CELL_SIZE = 0.1f;
+
+static float cameraDistance(const btVector3 &camera, const btVector3 &p)
+{
+    // manhattan distance for rectangular camera regions (if the cameras are distributed normally)
+    return std::abs(camera.x() - p.x()) + std::abs(camera.y() - p.y());
+}
+
+void CameraGrid::rebuild(const QVector<btVector3> &cameraPositions, float overlap, float width, float height)
+{
+    m_cameraPositions = cameraPositions.mid(0, MAX_CAMERAS);
+    m_overlap = overlap;
+    m_minX = -width / 2;
+    m_minY = -height / 2;
+    m_columns = std::max(0, int(std::ceil(width / CELL_SIZE)));
+    m_rows = std::max(0, int(std::ceil(height / CELL_SIZE)));
+    m_cells.assign(std::size_t(m_columns) * m_rows, Cell{0, 0});
+
+    // the distance to any camera changes by at most half the cell width plus half the cell height
+    // between the cell center and any other point in the cell, so the distance difference changes by twice that.
+    // The small additional margin covers rounding errors
+    const float margin = 2 * CELL_SIZE + 1E-3f;
+    const float threshold = 2 * m_overlap;
+    std::vector<float> distances(m_cameraPositions.size());
+    for (int row = 0; row < m_rows; row++) {
+        for (int column = 0; column < m_columns; column++) {
+            const btVector3 center(m_minX + (column + 0.5f) * CELL_SIZE, m_minY + (row + 0.5f) * CELL_SIZE, 0);
+            float minDistance = std::numeric_limits<float>::max();
+            for (int i = 0; i < m_cameraPositions.size(); i++) {
+                distances[i] = cameraDistance(m_cameraPositions[i], center);
+                minDistance = std::min(minDistance, distances[i]);
+            }
+
+            Cell &cell = m_cells[std::size_t(row) * m_columns + column];
+            for (int i = 0; i < m_cameraPositions.size(); i++) {
+                const float difference = distances[i] - minDistance;
+                if (difference + margin <= threshold) {
+                    cell.visible |= CameraSet(1) << i;
+                } else if (difference - margin <= threshold) {
+                    cell.uncertain |= CameraSet(1) << i;
+                }
+            }
+        }
+    }
+}
+
+CameraGrid::CameraSet CameraGrid::visibleCameras(const btVector3 &p) const
+{
+    const int column = int(std::floor((p.x() - m_minX) / CELL_SIZE));
+    const int row = int(std::floor((p.y() - m_minY) / CELL_SIZE));
+    if (column < 0 || column >= m_columns || row < 0 || row >= m_rows) {
+        const CameraSet allCameras = m_cameraPositions.size() == MAX_CAMERAS ?
+                    ~CameraSet(0) : (CameraSet(1) << m_cameraPositions.size()) - 1;
+        return checkCameras(p, allCameras);
+    }
+
+    const Cell &cell = m_cells[std::size_t(row) * m_columns + column];
+    if (cell.uncertain == 0) {
+        return cell.visible;
+    }
+    return cell.visible | checkCameras(p, cell.uncertain);
+}
+
+CameraGrid::CameraSet CameraGrid::checkCameras(const btVector3 &p, CameraSet candidates) const
+{
+    float minDistance = std::numeric_limits<float>::max();
+    for (const btVector3 &camera : m_cameraPositions) {
+        minDistance = std::min(minDistance, cameraDistance(camera, p));
+    }
+
+    CameraSet result = 0;
+    for (int i = 0; i < m_cameraPositions.size(); i++) {
+        if (contains(candidates, i) && cameraDistance(m_cameraPositions[i], p) <= minDistance + 2 * m_overlap) {
+            result |= CameraSet(1) << i;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,69 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef CAMERAGRID_H
+#define CAMERAGRID_H
+
+#include <QVector>
+#include <btBulletDynamicsCommon.h>
+#include <cstdint>
+#include <vector>
+
+namespace camun {
+    namespace simulator {
+        class CameraGrid;
+    }
+}
+
+// Precomputed assignment of field positions to the cameras that see them.
+// A camera sees every position which is at most twice the overlap farther away (manhattan distance)
+// than the closest camera. Cells close to the border of a camera region are checked exactly,
+// thus the result does not depend on the grid resolution.
+class camun::simulator::CameraGrid
+{
+public:
+    typedef uint64_t CameraSet;
+    static const int MAX_CAMERAS = 64;
+
+    // the grid covers the area of the given size around the field center, positions outside are checked exactly
+    void rebuild(const QVector<btVector3> &cameraPositions, float overlap, float width, float height);
+    CameraSet visibleCameras(const btVector3 &p) const;
+    static bool contains(CameraSet cameras, std::size_t cameraId) { return (cameras >> cameraId) & 1; }
+
+private:
+    CameraSet checkCameras(const btVector3 &p, CameraSet candidates) const;
+
+private:
+    struct Cell
+    {
+        CameraSet visible;
+        CameraSet uncertain;
+    };
+
+    QVector<btVector3> m_cameraPositions;
+    float m_overlap = 0;
+    float m_minX = 0;
+    float m_minY = 0;
+    int m_columns = 0;
+    int m_rows = 0;
+    std::vector<Cell> m_cells;
+};
+
+#endif // CAMERAGRID_H
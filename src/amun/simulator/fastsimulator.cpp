@@ -24,10 +24,18 @@
 #include <algorithm>
 
 bool FastSimulator::goWithCallback(camun::simulator::Simulator* sim, Timer* t, qint64 targetTime,const std::function<void(void)>& callback)
+{
+    return goWhile(sim, t, targetTime, [&callback]() {
+        callback();
+        return true;
+    });
+}
+
+bool FastSimulator::goWhile(camun::simulator::Simulator* sim, Timer* t, qint64 targetTime, const std::function<bool(void)>& callback)
 {
 
     if (t->scaling() != 0) return false;
-    callback();
+    if (!callback()) return true;
     const qint64 maxSimulationStep = 1e9 / 200;
     qint64 now = t->currentTime();
     qint64 lastCallbackTime = now;
@@ -37,7 +45,9 @@ bool FastSimulator::goWithCallback(camun::simulator::Simulator* sim, Timer* t, q
         sim->process();
         now = t->currentTime();
         if (now - lastCallbackTime >= 1e7) {
-            callback();
+            if (!callback()) {
+                break;
+            }
             lastCallbackTime = now;
         }
     }
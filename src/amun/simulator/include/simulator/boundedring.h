@@ -0,0 +1,112 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef BOUNDEDRING_H
+#define BOUNDEDRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Lock-free ring buffer with a fixed capacity, which may be used by multiple producers
+// and a single consumer. Unlike BoundedQueue a push never blocks, it fails if the ring is full.
+// Every slot carries a sequence number which tells whether it is ready for writing or reading.
+template<typename T>
+class BoundedRing
+{
+public:
+    // the capacity is rounded up to the next power of two
+    explicit BoundedRing(std::size_t capacity) :
+        m_mask(roundUp(capacity) - 1),
+        m_slots(new Slot[m_mask + 1])
+    {
+        for (std::size_t i = 0; i <= m_mask; i++) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    BoundedRing(const BoundedRing&) = delete;
+    BoundedRing& operator=(const BoundedRing&) = delete;
+
+    // may be called from any thread, returns false if the ring is full
+    bool push(T &&value)
+    {
+        std::size_t pos = m_writePos.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true) {
+            slot = &m_slots[pos & m_mask];
+            const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(pos);
+            if (diff == 0) {
+                if (m_writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // the consumer has not read this slot yet
+                return false;
+            } else {
+                pos = m_writePos.load(std::memory_order_relaxed);
+            }
+        }
+        slot->value = std::move(value);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // must only be called by the consumer thread, returns false if no value is ready
+    bool pop(T &value)
+    {
+        Slot &slot = m_slots[m_readPos & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != m_readPos + 1) {
+            return false;
+        }
+        value = std::move(slot.value);
+        // release the shared data before handing the slot back to the producers
+        slot.value = T();
+        slot.sequence.store(m_readPos + m_mask + 1, std::memory_order_release);
+        m_readPos++;
+        return true;
+    }
+
+    std::size_t capacity() const { return m_mask + 1; }
+
+private:
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    static std::size_t roundUp(std::size_t capacity)
+    {
+        std::size_t result = 1;
+        while (result < capacity) {
+            result *= 2;
+        }
+        return result;
+    }
+
+    const std::size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<std::size_t> m_writePos{0};
+    // only accessed by the consumer
+    std::size_t m_readPos = 0;
+};
+
+#endif // BOUNDEDRING_H
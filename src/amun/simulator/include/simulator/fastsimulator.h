@@ -38,6 +38,9 @@ namespace FastSimulator {
     // Instead, the callback will be called at the beginning and every 10 ms after that.
     bool goWithCallback(camun::simulator::Simulator* sim, Timer* t, qint64 targetTime, const std::function<void(void)>& callback);
 
+    // like goWithCallback, but stops early as soon as the callback returns false
+    bool goWhile(camun::simulator::Simulator* sim, Timer* t, qint64 targetTime, const std::function<bool(void)>& callback);
+
     inline bool goDeltaCallback(camun::simulator::Simulator* sim, Timer* t, qint64 delta, const std::function<void(void)>& cb) {
         return goWithCallback(sim, t, t->currentTime() + delta, cb);
     }
@@ -0,0 +1,82 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef RADIOCOMMANDRING_H
+#define RADIOCOMMANDRING_H
+
+#include "boundedring.h"
+#include "core/timer.h"
+#include "protobuf/sslsim.h"
+#include <atomic>
+#include <tuple>
+#include <utility>
+
+namespace camun {
+    namespace simulator {
+        class RadioCommandRing;
+    }
+}
+
+// Passes radio commands from any thread to the simulator thread without posting an event.
+// The ring is shared by the producers and the simulator, thus it stays valid for a producer
+// even while the simulator is replaced. All simulators reading from one ring must live in the same thread.
+class camun::simulator::RadioCommandRing
+{
+public:
+    // control, processing start and whether the commands are for the blue team
+    typedef std::tuple<SSLSimRobotControl, qint64, bool> RadioCommand;
+
+    // two teams with 100 Hz leave plenty of room, the ring is emptied on every simulator tick
+    explicit RadioCommandRing(std::size_t capacity = 256) : m_ring(capacity) {}
+    RadioCommandRing(const RadioCommandRing&) = delete;
+    RadioCommandRing& operator=(const RadioCommandRing&) = delete;
+
+    // may be called from any thread, commands which don't fit into the ring are counted as dropped
+    bool push(const SSLSimRobotControl &control, bool isBlue, qint64 processingStart)
+    {
+        if (m_ring.push(std::make_pair(std::make_tuple(control, processingStart, isBlue), Timer::systemTime()))) {
+            return true;
+        }
+        (isBlue ? m_droppedBlue : m_droppedYellow)++;
+        return false;
+    }
+
+    // must only be called by the simulator thread, pushTime is the system time when the command was added
+    bool pop(RadioCommand &command, qint64 &pushTime)
+    {
+        std::pair<RadioCommand, qint64> entry;
+        if (!m_ring.pop(entry)) {
+            return false;
+        }
+        command = std::move(entry.first);
+        pushTime = entry.second;
+        return true;
+    }
+
+    qint64 droppedCommands(bool isBlue) const { return isBlue ? m_droppedBlue.load() : m_droppedYellow.load(); }
+    std::size_t capacity() const { return m_ring.capacity(); }
+
+private:
+    BoundedRing<std::pair<RadioCommand, qint64>> m_ring;
+    std::atomic<qint64> m_droppedBlue{0};
+    std::atomic<qint64> m_droppedYellow{0};
+};
+
+#endif // RADIOCOMMANDRING_H
@@ -24,11 +24,13 @@
 #include "protobuf/command.h"
 #include "protobuf/status.h"
 #include "protobuf/sslsim.h"
+#include "radiocommandring.h"
 #include <QList>
 #include <QMap>
 #include <QPair>
 #include <QQueue>
 #include <QByteArray>
+#include <memory>
 #include <tuple>
 #include <random>
 
@@ -65,12 +67,41 @@ class camun::simulator::Simulator : public QObject
 public:
     typedef QMap<unsigned int, QPair<SimRobot*, unsigned int>> RobotMap; /*First int: ID, Second int: Generation*/
 
-    explicit Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool useManualTrigger = false);
+    struct RadioCommandStatistics
+    {
+        qint64 receivedCommands = 0;
+        // commands that did not fit into the command ring, they are reported as simulator errors
+        qint64 droppedCommands = 0;
+        // time from handing the commands to the simulator until the simulator thread fetched them, in nanoseconds
+        qint64 totalIngestionDelay = 0;
+        qint64 maxIngestionDelay = 0;
+    };
+
+    // The radio command ring can be owned by the producers of the commands, see RadioCommandRing.
+    // Otherwise the simulator creates its own ring.
+    explicit Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool useManualTrigger = false,
+                       std::shared_ptr<RadioCommandRing> radioCommandRing = nullptr);
     ~Simulator() override;
     Simulator(const Simulator&) = delete;
     Simulator& operator=(const Simulator&) = delete;
     void handleSimulatorTick(double timeStep);
     void seedPRGN(uint32_t seed);
+    // Makes runs reproducible bit by bit: all random generators are seeded, radio commands
+    // are applied in a fixed order and no wall clock measurements are sent.
+    // Only possible for simulators created with useManualTrigger = true
+    void setDeterministic(uint32_t seed);
+
+    // Captures the complete dynamic state (bodies, constraints, pending commands and vision packets,
+    // random generators) into a binary blob. The configuration like the geometry or realism settings
+    // is not included, a snapshot can only be restored into a simulator with the same setup.
+    // Radio commands which are still in the command ring are fetched first.
+    QByteArray snapshot();
+    // Replaces the current state with a snapshot. Restoring the same snapshot multiple times
+    // always continues identically. The timer must be reset to time() afterwards.
+    // A damaged snapshot is rejected as a whole and leaves the current state unchanged.
+    bool restore(const QByteArray &snapshot);
+    qint64 time() const { return m_time; }
+    RadioCommandStatistics radioCommandStatistics() const;
 
 signals:
     void gotPacket(const QByteArray &data, qint64 time, QString sender);
@@ -81,6 +112,9 @@ signals:
 
 public slots:
     void handleCommand(const Command &command);
+    // Thread safe, the commands are passed to the simulator thread via a lock-free ring.
+    // Connect with Qt::DirectConnection to avoid posting an event for every command, the
+    // connection must be removed in the sending thread before the simulator is deleted
     void handleRadioCommands(const SSLSimRobotControl& control, bool isBlue, qint64 processingStart);
     void setScaling(double scaling);
     void setFlipped(bool flipped);
@@ -90,12 +124,17 @@ public slots:
     void process();
 
 private slots:
-    void sendVisionPacket();
+    void sendDueVisionPackets();
 
 private:
     void sendSSLSimErrorInternal(ErrorSource source);
+    qint64 fetchRadioCommands();
     void resetFlipped(RobotMap &robots, float side);
+    void stepKinematics(double timeDelta);
     std::tuple<QList<QByteArray>, QByteArray, qint64> createVisionPacket();
+    void sendVisionPacket();
+    void enqueueVisionPacket(const std::tuple<QList<QByteArray>, QByteArray, qint64> &packet);
+    void scheduleVisionPackets();
     void resetVisionPackets();
     void setTeam(RobotMap &list, float side, const robot::Team &team, QMap<uint32_t, robot::Specs>& specs);
     void moveBall(const sslsim::TeleportBall &ball);
@@ -104,12 +143,22 @@ private:
     void initializeDetection(SSL_DetectionFrame *detection, std::size_t cameraId);
 
 private:
-    typedef std::tuple<SSLSimRobotControl, qint64, bool> RadioCommand;
+    typedef RadioCommandRing::RadioCommand RadioCommand;
     SimulatorData *m_data;
+    // written by the producer threads
+    std::shared_ptr<RadioCommandRing> m_radioCommandRing;
+    // dropped commands which were already reported, per team
+    qint64 m_reportedDroppedBlue;
+    qint64 m_reportedDroppedYellow;
+    RadioCommandStatistics m_radioCommandStatistics;
+    // commands waiting for the command delay, only accessed by the simulator thread
     QQueue<RadioCommand> m_radioCommands;
+    // ordered by the delivery time, which is the last tuple element
     QQueue<std::tuple<QList<QByteArray>, QByteArray, qint64>> m_visionPackets;
-    QQueue<QTimer *> m_visionTimers;
+    // delivers the vision packets when not using the manual trigger
+    QTimer *m_visionTimer;
     bool m_isPartial;
+    bool m_deterministic;
     const Timer *m_timer;
     QTimer *m_trigger;
     qint64 m_time;
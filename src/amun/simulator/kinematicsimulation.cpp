@@ -0,0 +1,220 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "kinematicsimulation.h"
+#include "simball.h"
+#include "simrobot.h"
+#include "simulator.h"
+#include <QtGlobal>
+#include <algorithm>
+
+using namespace camun::simulator;
+
+KinematicSimulation::KinematicSimulation(const world::Geometry &geometry)
+{
+    // same layout as SimField, the corner blocks are not included
+    const float totalWidth = geometry.field_width() / 2.0f + geometry.boundary_width();
+    const float totalHeight = geometry.field_height() / 2.0f + geometry.boundary_width();
+    const float height = geometry.field_height() / 2.0f - geometry.line_width();
+    const float goalWidthHalf = geometry.goal_width() / 2.0f + geometry.goal_wall_width();
+    const float goalDepth = geometry.goal_depth() + geometry.goal_wall_width();
+    const float goalDepthHalf = goalDepth / 2.0f;
+    const float goalWallHalf = geometry.goal_wall_width() / 2.0f;
+    const float roomHeight = 8.0f;
+    // the walls are thick enough that nothing can pass through them during one step
+    const float wallHalf = 0.5f;
+
+    addBox(-totalWidth - wallHalf, 0, wallHalf, totalHeight + 2 * wallHalf, roomHeight, 0.3f);
+    addBox(totalWidth + wallHalf, 0, wallHalf, totalHeight + 2 * wallHalf, roomHeight, 0.3f);
+    for (const float side : {-1.0f, 1.0f}) {
+        const float y = side * (totalHeight + wallHalf);
+        if (geometry.boundary_width() == 0.0) {
+            // the goals stand outside of the field, leave an opening for them
+            const float halfWidth = (totalWidth - goalWidthHalf) / 2.0f;
+            addBox(goalWidthHalf + halfWidth, y, halfWidth, wallHalf, roomHeight, 0.3f);
+            addBox(-goalWidthHalf - halfWidth, y, halfWidth, wallHalf, roomHeight, 0.3f);
+        } else {
+            addBox(0, y, totalWidth, wallHalf, roomHeight, 0.3f);
+        }
+
+        const float lineWidthOffset = geometry.boundary_width() != 0.0 ? 0.0f : geometry.line_width() * 0.5f;
+        addBox(goalWidthHalf - goalWallHalf, side * (height + goalDepthHalf + lineWidthOffset), goalWallHalf, goalDepthHalf,
+               geometry.goal_height(), 0.3f);
+        addBox(-(goalWidthHalf - goalWallHalf), side * (height + goalDepthHalf + lineWidthOffset), goalWallHalf, goalDepthHalf,
+               geometry.goal_height(), 0.3f);
+        addBox(0, side * (height + goalDepth - goalWallHalf + lineWidthOffset), goalWidthHalf, goalWallHalf,
+               geometry.goal_height(), 0.1f);
+    }
+}
+
+void KinematicSimulation::addBox(float centerX, float centerY, float halfWidth, float halfHeight, float height, float restitution)
+{
+    Box box;
+    box.min = btVector3(centerX - halfWidth, centerY - halfHeight, 0) * SIMULATOR_SCALE;
+    box.max = btVector3(centerX + halfWidth, centerY + halfHeight, 0) * SIMULATOR_SCALE;
+    box.height = height * SIMULATOR_SCALE;
+    box.restitution = restitution;
+    m_walls.push_back(box);
+}
+
+void KinematicSimulation::step(SimBall *ball, const std::vector<SimRobot*> &robots, double timeStep)
+{
+    for (SimRobot *robot : robots) {
+        robot->stepKinematic(ball, timeStep);
+    }
+    ball->stepKinematic(timeStep);
+
+    // the robots are much heavier than the ball, thus it does not push them
+    for (std::size_t i = 0; i < robots.size(); i++) {
+        for (std::size_t j = i + 1; j < robots.size(); j++) {
+            collideRobots(robots[i], robots[j]);
+        }
+    }
+    for (SimRobot *robot : robots) {
+        collideWithWalls(robot);
+    }
+    collideBall(ball, robots);
+
+    for (SimRobot *robot : robots) {
+        robot->finishKinematicStep();
+    }
+}
+
+bool KinematicSimulation::boxContact(const Box &box, const btVector3 &center, btScalar radius, btVector3 &normal, btScalar &depth)
+{
+    const btVector3 closest(qBound(box.min.x(), center.x(), box.max.x()), qBound(box.min.y(), center.y(), box.max.y()), 0);
+    const btVector3 diff(center.x() - closest.x(), center.y() - closest.y(), 0);
+    const btScalar distance = diff.length();
+    if (distance > 0) {
+        normal = diff / distance;
+        depth = radius - distance;
+    } else {
+        // the center is inside of the box, leave it through the closest side
+        const btScalar distances[4] = { center.x() - box.min.x(), box.max.x() - center.x(),
+                                        center.y() - box.min.y(), box.max.y() - center.y() };
+        const btVector3 normals[4] = { btVector3(-1, 0, 0), btVector3(1, 0, 0), btVector3(0, -1, 0), btVector3(0, 1, 0) };
+        const int side = std::min_element(distances, distances + 4) - distances;
+        normal = normals[side];
+        depth = radius + distances[side];
+    }
+    return depth > 0;
+}
+
+static void moveBody(btRigidBody *body, const btVector3 &offset)
+{
+    body->getWorldTransform().setOrigin(body->getWorldTransform().getOrigin() + offset);
+}
+
+void KinematicSimulation::collideRobots(SimRobot *a, SimRobot *b)
+{
+    btVector3 normal;
+    btScalar depth;
+    const btVector3 center = b->body()->getWorldTransform().getOrigin();
+    if (!a->kinematicContact(center, b->specs().radius() * SIMULATOR_SCALE, normal, depth)) {
+        return;
+    }
+
+    // both robots have roughly the same mass, split the correction and stop the approach
+    moveBody(a->body(), -normal * depth * 0.5f);
+    moveBody(b->body(), normal * depth * 0.5f);
+    const btVector3 velocityA = a->body()->getLinearVelocity();
+    const btVector3 velocityB = b->body()->getLinearVelocity();
+    const btScalar approach = (velocityB - velocityA).dot(normal);
+    if (approach < 0) {
+        a->body()->setLinearVelocity(velocityA + normal * approach * 0.5f);
+        b->body()->setLinearVelocity(velocityB - normal * approach * 0.5f);
+    }
+}
+
+void KinematicSimulation::collideWithWalls(SimRobot *robot) const
+{
+    const btScalar radius = robot->specs().radius() * SIMULATOR_SCALE;
+    for (const Box &box : m_walls) {
+        btVector3 normal;
+        btScalar depth;
+        if (!boxContact(box, robot->body()->getWorldTransform().getOrigin(), radius, normal, depth)) {
+            continue;
+        }
+        moveBody(robot->body(), normal * depth);
+        const btVector3 velocity = robot->body()->getLinearVelocity();
+        const btScalar approach = velocity.dot(normal);
+        if (approach < 0) {
+            robot->body()->setLinearVelocity(velocity - normal * approach);
+        }
+    }
+}
+
+void KinematicSimulation::collideBall(SimBall *ball, const std::vector<SimRobot*> &robots) const
+{
+    const btScalar radius = BALL_RADIUS * SIMULATOR_SCALE;
+    btVector3 position = ball->body()->getWorldTransform().getOrigin();
+    btVector3 velocity = ball->body()->getLinearVelocity();
+    bool collided = false;
+
+    for (SimRobot *robot : robots) {
+        // a chipped ball can fly over the robots
+        if (position.z() - radius > robot->specs().height() * SIMULATOR_SCALE) {
+            continue;
+        }
+        btVector3 normal;
+        btScalar depth;
+        if (!robot->kinematicContact(position, radius, normal, depth)) {
+            continue;
+        }
+        position += normal * depth;
+        const btScalar approach = (velocity - robot->body()->getLinearVelocity()).dot(normal);
+        if (approach < 0) {
+            // the dribbler absorbs more of the impact than the robot cover
+            const btVector3 forward = robot->body()->getWorldTransform().getBasis() * btVector3(0, 1, 0);
+            const btScalar restitution = normal.dot(forward) > 0.99f ? 0.2f : 0.6f;
+            velocity -= normal * (1 + restitution) * approach;
+        }
+        collided = true;
+    }
+
+    for (const Box &box : m_walls) {
+        if (position.z() - radius > box.height) {
+            continue;
+        }
+        btVector3 normal;
+        btScalar depth;
+        if (!boxContact(box, position, radius, normal, depth)) {
+            continue;
+        }
+        position += normal * depth;
+        const btScalar approach = velocity.dot(normal);
+        if (approach < 0) {
+            velocity -= normal * (1 + box.restitution) * approach;
+        }
+        collided = true;
+    }
+
+    if (collided) {
+        ball->setKinematicMotion(position, velocity, true);
+    }
+
+    // a dribbling robot takes the ball along
+    for (SimRobot *robot : robots) {
+        if (robot->isDribbling() && robot->canKickBall(ball)) {
+            ball->setKinematicMotion(robot->dribbledBallPosition(), robot->body()->getLinearVelocity(), false);
+            break;
+        }
+    }
+}
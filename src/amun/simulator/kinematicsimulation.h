@@ -0,0 +1,67 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef KINEMATICSIMULATION_H
+#define KINEMATICSIMULATION_H
+
+#include "protobuf/world.pb.h"
+#include <btBulletDynamicsCommon.h>
+#include <vector>
+
+namespace camun {
+    namespace simulator {
+        class KinematicSimulation;
+        class SimBall;
+        class SimRobot;
+    }
+}
+
+// Simulation backend without rigid body physics, used for the kinematic fidelity.
+// The robots follow their commands within their acceleration limits and the ball
+// moves according to the ball model published in the geometry. Robots, ball, walls
+// and goals only interact by simple collisions of circles and boxes in the xy-plane.
+// The bullet bodies are just used to store the state, the dynamics world is never stepped.
+class camun::simulator::KinematicSimulation
+{
+public:
+    explicit KinematicSimulation(const world::Geometry &geometry);
+
+    void step(SimBall *ball, const std::vector<SimRobot*> &robots, double timeStep);
+
+private:
+    struct Box
+    {
+        btVector3 min;
+        btVector3 max;
+        btScalar height;
+        btScalar restitution;
+    };
+
+    void addBox(float centerX, float centerY, float halfWidth, float halfHeight, float height, float restitution);
+    static bool boxContact(const Box &box, const btVector3 &center, btScalar radius, btVector3 &normal, btScalar &depth);
+    static void collideRobots(SimRobot *a, SimRobot *b);
+    void collideWithWalls(SimRobot *robot) const;
+    void collideBall(SimBall *ball, const std::vector<SimRobot*> &robots) const;
+
+private:
+    std::vector<Box> m_walls;
+};
+
+#endif // KINEMATICSIMULATION_H
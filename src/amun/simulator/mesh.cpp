@@ -19,6 +19,7 @@
  ***************************************************************************/
 
 #include "mesh.h"
+#include <algorithm>
 #include <cmath>
 
 using namespace camun::simulator;
@@ -29,7 +30,7 @@ using namespace camun::simulator;
  * \brief A 3D mesh
  */
 
-Mesh::Mesh(float radius, float height, float angle, float holeSize, float boxHeight)
+Mesh::Mesh(float radius, float height, float angle, float holeSize, float boxHeight, uint coverSegments)
     : m_radius(radius), m_height(height), m_angle(angle), m_holeSize(holeSize)
 {
     const float frontPlateLength = std::sin(angle / 2.0f) * radius;
@@ -40,15 +41,16 @@ Mesh::Mesh(float radius, float height, float angle, float holeSize, float boxHei
     const float halfOuterAngle = outerAngle / 2.0f;
     const float outerAngleStart = halfOuterAngle + M_PI_2;
     const float outerAngleStop =  2.0f * M_PI - halfOuterAngle + M_PI_2;
-    addRobotCover(20, outerAngleStart, outerAngleStop);
+    addRobotCover(coverSegments, outerAngleStart, outerAngleStop);
 
     //right pillar
-    addRobotCover(5, outerAngleStart - angleDiff, outerAngleStart);
+    const uint pillarSegments = std::max(1u, coverSegments / 4);
+    addRobotCover(pillarSegments, outerAngleStart - angleDiff, outerAngleStart);
     m_hull.back().append(QVector3D(-frontPlateLength, holePlatePos,  m_height / 2.0f));
     m_hull.back().append(QVector3D(-frontPlateLength, holePlatePos, -m_height / 2.0f));
 
     //left pillar
-    addRobotCover(5, outerAngleStop, outerAngleStop + angleDiff);
+    addRobotCover(pillarSegments, outerAngleStop, outerAngleStop + angleDiff);
     m_hull.back().append(QVector3D(frontPlateLength, holePlatePos,  m_height / 2.0f));
     m_hull.back().append(QVector3D(frontPlateLength, holePlatePos, -m_height / 2.0f));
 
@@ -35,7 +35,8 @@ namespace camun {
 class camun::simulator::Mesh
 {
 public:
-    Mesh(float radius, float height, float angle, float holeSize, float boxHeight);
+    // coverSegments is the number of segments of the round robot cover
+    Mesh(float radius, float height, float angle, float holeSize, float boxHeight, uint coverSegments = 20);
     void createRobotMeshes(float radius, float height, float angle);
     const QList<QList<QVector3D>> &hull() const { return m_hull; }
 
@@ -19,12 +19,15 @@
  ***************************************************************************/
 
 #include "simball.h"
+#include "bodystate.h"
 #include "simulator.h"
 #include "core/rng.h"
 #include "core/coordinates.h"
 #include "core/vector.h"
 #include "protobuf/ssl_detection.pb.h"
+#include <algorithm>
 #include <cmath>
+#include <QDataStream>
 #include <QDebug>
 
 using namespace camun::simulator;
@@ -67,7 +70,7 @@ SimBall::~SimBall()
     delete m_motionState;
 }
 
-void SimBall::begin()
+void SimBall::begin(double timeStep)
 {
     // custom implementation of rolling friction
     const btVector3 p = m_body->getWorldTransform().getOrigin();
@@ -85,11 +88,15 @@ void SimBall::begin()
             const btScalar rollingDeceleration = hackFactor * 0.35;
             btVector3 force(velocity.x(), velocity.y(), 0.0f);
             force.safeNormalize();
-            m_body->applyCentralImpulse(-force * rollingDeceleration * SIMULATOR_SCALE * BALL_MASS * SUB_TIMESTEP);
+            m_body->applyCentralImpulse(-force * rollingDeceleration * SIMULATOR_SCALE * BALL_MASS * timeStep);
         }
     }
 
+    handleMoveCommand();
+}
 
+void SimBall::handleMoveCommand()
+{
     bool moveCommand = false;
     auto sendPartialCoordError = [this](const char* msg){
         SSLSimError error{new sslsim::SimulatorError};
@@ -337,6 +344,34 @@ void SimBall::restoreState(const world::SimBall &ball)
     m_body->setAngularVelocity(angular);
 }
 
+void SimBall::writeSnapshot(QDataStream &stream) const
+{
+    writeBodyState(stream, m_body);
+    stream << QByteArray::fromStdString(m_move.SerializePartialAsString());
+    stream << m_rollSwitchSpeed << m_hops;
+}
+
+SimBall::Snapshot SimBall::readSnapshot(QDataStream &stream)
+{
+    Snapshot snapshot;
+    snapshot.body = readBodyState(stream);
+    QByteArray move;
+    stream >> move;
+    if (!snapshot.move.ParsePartialFromArray(move.constData(), move.size())) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+    }
+    stream >> snapshot.rollSwitchSpeed >> snapshot.hops;
+    return snapshot;
+}
+
+void SimBall::restoreSnapshot(const Snapshot &snapshot)
+{
+    applyBodyState(snapshot.body, m_body);
+    m_move = snapshot.move;
+    m_rollSwitchSpeed = snapshot.rollSwitchSpeed;
+    m_hops = snapshot.hops;
+}
+
 bool SimBall::isInvalid() const
 {
     const btTransform transform = m_body->getWorldTransform();
@@ -360,3 +395,78 @@ void SimBall::kick(const btVector3 &power)
     // const btVector3 p = transform.getOrigin() / SIMULATOR_SCALE;
     // qDebug() << "kick at" << p.x() << p.y();
 }
+
+void SimBall::stepKinematic(double timeStep)
+{
+    const bool setsVelocity = m_move.has_vx() && !m_move.by_force();
+    handleMoveCommand();
+    if (setsVelocity) {
+        setKinematicMotion(m_body->getWorldTransform().getOrigin(), m_body->getLinearVelocity(), true);
+    }
+
+    btTransform transform = m_body->getWorldTransform();
+    btVector3 p = transform.getOrigin();
+    btVector3 v = m_body->getLinearVelocity();
+    const btScalar groundZ = BALL_RADIUS * SIMULATOR_SCALE;
+
+    if (p.z() > groundZ || v.z() > 0) {
+        // chip_fixed_loss: the flight is not slowed down, every bounce loses a fixed part of the speed
+        const btScalar gravity = 9.81f * SIMULATOR_SCALE;
+        p += v * timeStep - btVector3(0, 0, 0.5f * gravity * timeStep * timeStep);
+        v.setZ(v.z() - gravity * timeStep);
+        if (p.z() <= groundZ) {
+            p.setZ(groundZ);
+            const btScalar dampingXY = (m_hops == 0) ? BALL_DAMPING_XY_FIRST_HOP : BALL_DAMPING_XY_OTHER_HOPS;
+            v = btVector3(v.x() * dampingXY, v.y() * dampingXY, -v.z() * BALL_DAMPING_Z);
+            m_hops++;
+            // stop bouncing once the hops get too small to be seen
+            if (v.z() < 0.1f * SIMULATOR_SCALE) {
+                v.setZ(0);
+                // the ball already rolls after landing
+                m_rollSwitchSpeed = v.length();
+            }
+        }
+    } else {
+        // straight_two_phase: slide until the speed drops below the switch speed, then roll
+        p.setZ(groundZ);
+        v.setZ(0);
+        const btScalar speed = v.length();
+        if (speed > 0) {
+            const btScalar acceleration = (speed > m_rollSwitchSpeed ? BALL_ACC_SLIDE : BALL_ACC_ROLL) * SIMULATOR_SCALE;
+            const btScalar newSpeed = std::max(btScalar(0), speed + acceleration * btScalar(timeStep));
+            const btScalar distance = (newSpeed > 0) ? (speed + newSpeed) * 0.5f * timeStep
+                                                     : speed * speed / (-2 * acceleration);
+            p += v * (distance / speed);
+            v *= newSpeed / speed;
+        }
+    }
+
+    transform.setOrigin(p);
+    m_body->setWorldTransform(transform);
+    m_body->setLinearVelocity(v);
+    m_body->setAngularVelocity(btVector3(0, 0, 0));
+    syncMotionState();
+}
+
+void SimBall::kickKinematic(const btVector3 &velocity)
+{
+    setKinematicMotion(m_body->getWorldTransform().getOrigin(), m_body->getLinearVelocity() + velocity, true);
+    m_hops = 0;
+}
+
+void SimBall::setKinematicMotion(const btVector3 &position, const btVector3 &velocity, bool sliding)
+{
+    btTransform transform = m_body->getWorldTransform();
+    transform.setOrigin(position);
+    m_body->setWorldTransform(transform);
+    m_body->setLinearVelocity(velocity);
+    const btScalar groundSpeed = btVector3(velocity.x(), velocity.y(), 0).length();
+    m_rollSwitchSpeed = sliding ? groundSpeed * BALL_K_SWITCH : groundSpeed;
+    syncMotionState();
+}
+
+void SimBall::syncMotionState()
+{
+    // done by bullet after each step when using rigid body physics
+    m_motionState->setWorldTransform(m_body->getWorldTransform());
+}
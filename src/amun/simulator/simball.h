@@ -24,6 +24,7 @@
 #include "protobuf/command.pb.h"
 #include "protobuf/sslsim.h"
 #include <btBulletDynamicsCommon.h>
+#include "bodystate.h"
 #include "simfield.h"
 #include <QObject>
 
@@ -31,6 +32,15 @@ static const float BALL_RADIUS = 0.0215f;
 static const float BALL_MASS = 0.046f;
 static const float BALL_DECELERATION = 0.5f;
 
+// ball model published in the geometry, the kinematic simulation follows it exactly
+static const float BALL_ACC_SLIDE = -3.9f;
+static const float BALL_ACC_ROLL = -0.35f;
+static const float BALL_K_SWITCH = 0.69f;
+static const float BALL_DAMPING_Z = 0.566f;
+static const float BALL_DAMPING_XY_FIRST_HOP = 0.715f;
+static const float BALL_DAMPING_XY_OTHER_HOPS = 1.0f;
+
+class QDataStream;
 class RNG;
 class SSL_DetectionBall;
 
@@ -54,16 +64,34 @@ signals:
     void sendSSLSimError(const SSLSimError& error, ErrorSource s);
 
 public:
-    void begin();
+    void begin(double timeStep);
     bool update(SSL_DetectionBall *ball, float stddev, float stddevArea, const btVector3 &cameraPosition,
                bool enableInvisibleBall, float visibilityThreshold, btVector3 positionOffset);
     void move(const sslsim::TeleportBall &ball);
     void kick(const btVector3 &power);
+    // kinematic simulation without rigid body physics, see KinematicSimulation
+    void stepKinematic(double timeStep);
+    // adds the velocity, the ball starts sliding again
+    void kickKinematic(const btVector3 &velocity);
+    // a sliding ball decelerates faster until the rolling phase is reached
+    void setKinematicMotion(const btVector3 &position, const btVector3 &velocity, bool sliding);
     // returns the ball position projected onto the floor (z component is not included)
     btVector3 position() const;
     btVector3 speed() const;
     void writeBallState(world::SimBall *ball) const;
     void restoreState(const world::SimBall &ball);
+    // complete state including pending teleports, used by Simulator::snapshot
+    struct Snapshot
+    {
+        BodyState body;
+        sslsim::TeleportBall move;
+        btScalar rollSwitchSpeed = 0;
+        int hops = 0;
+    };
+    void writeSnapshot(QDataStream &stream) const;
+    // sets the stream status to ReadCorruptData if the snapshot can't be parsed
+    static Snapshot readSnapshot(QDataStream &stream);
+    void restoreSnapshot(const Snapshot &snapshot);
     btRigidBody *body() const { return m_body; }
     bool isInvalid() const;
 
@@ -71,6 +99,10 @@ public:
     bool addDetection(SSL_DetectionBall *ball, btVector3 pos, float stddev, float stddevArea, const btVector3 &cameraPosition,
                       bool enableInvisibleBall, float visibilityThreshold, btVector3 positionOffset);
 
+private:
+    void handleMoveCommand();
+    void syncMotionState();
+
 private:
     RNG *m_rng;
     btDiscreteDynamicsWorld *m_world;
@@ -78,6 +110,9 @@ private:
     btRigidBody *m_body;
     btMotionState *m_motionState;
     sslsim::TeleportBall m_move;
+    // only used by the kinematic simulation
+    btScalar m_rollSwitchSpeed = 0;
+    int m_hops = 0;
 };
 
 #endif // SIMBALL_H
@@ -22,10 +22,13 @@
 #include "core/coordinates.h"
 #include "mesh.h"
 #include "protobuf/ssl_detection.pb.h"
+#include "bodystate.h"
 #include "simball.h"
 #include "simrobot.h"
 #include "simulator.h"
+#include <algorithm>
 #include <cmath>
+#include <QDataStream>
 #include <QDebug>
 
 using namespace camun::simulator;
@@ -38,7 +41,7 @@ float boundSpeed(float speed)
 }
 
 
-SimRobot::SimRobot(RNG *rng, const robot::Specs &specs, btDiscreteDynamicsWorld *world, const btVector3 &pos, float dir) :
+SimRobot::SimRobot(RNG *rng, const robot::Specs &specs, btDiscreteDynamicsWorld *world, const btVector3 &pos, float dir, uint coverSegments) :
     m_rng(rng),
     m_specs(specs),
     m_world(world),
@@ -58,7 +61,8 @@ SimRobot::SimRobot(RNG *rng, const robot::Specs &specs, btDiscreteDynamicsWorld
 
     // subtract collision margin from dimensions
     Mesh mesh(m_specs.radius() - COLLISION_MARGIN / SIMULATOR_SCALE,
-              m_specs.height() - 2 * COLLISION_MARGIN / SIMULATOR_SCALE, m_specs.angle(), 0.04f, m_specs.dribbler_height() + 0.02f);
+              m_specs.height() - 2 * COLLISION_MARGIN / SIMULATOR_SCALE, m_specs.angle(), 0.04f, m_specs.dribbler_height() + 0.02f,
+              coverSegments);
     for (const QList<QVector3D> & hullPart : mesh.hull()) {
         btConvexHullShape* hullPartShape = new btConvexHullShape;
         m_shapes.append(hullPartShape);
@@ -156,25 +160,9 @@ void SimRobot::dribble(SimBall *ball, float speed)
 {
     if (m_perfectDribbler) {
         if (canKickBall(ball) && !m_holdBallConstraint) {
-            btVector3 localA, localB;
-            localB.setZero();
-
             const auto robotWorldTransform = m_body->getWorldTransform();
             const auto worldToRobot = robotWorldTransform.inverse();
-            localA = worldToRobot * ball->position();
-
-            m_holdBallConstraint.reset(new btPoint2PointConstraint(*m_body, *ball->body(), localA, localB));
-            m_world->addConstraint(m_holdBallConstraint.get(), true);
-
-            // add a constraint to prevent the robot from tipping over
-            // previously it was common for one robot tipping over if both had the dribbling constraint
-            // this is an ugly hack, but then again so is this the holdBallConstraint
-            m_notTipOverConstraint.reset(new btGeneric6DofSpring2Constraint(*m_body, robotWorldTransform));
-            m_notTipOverConstraint->setAngularLowerLimit(btVector3(0,0,1));
-            m_notTipOverConstraint->setAngularUpperLimit(btVector3(0,0,0));
-            m_notTipOverConstraint->setLinearLowerLimit(btVector3(1,1,1));
-            m_notTipOverConstraint->setLinearUpperLimit(btVector3(0,0,0));
-            m_world->addConstraint(m_notTipOverConstraint.get(),true);
+            holdBall(ball, worldToRobot * ball->position(), robotWorldTransform);
         }
     } else {
         // unit for rotation is  (rad / s) in bullet, but (rpm) in sslCommand
@@ -186,6 +174,24 @@ void SimRobot::dribble(SimBall *ball, float speed)
     }
 }
 
+void SimRobot::holdBall(SimBall *ball, const btVector3 &ballInRobot, const btTransform &robotTransform)
+{
+    btVector3 localB;
+    localB.setZero();
+    m_holdBallConstraint.reset(new btPoint2PointConstraint(*m_body, *ball->body(), ballInRobot, localB));
+    m_world->addConstraint(m_holdBallConstraint.get(), true);
+
+    // add a constraint to prevent the robot from tipping over
+    // previously it was common for one robot tipping over if both had the dribbling constraint
+    // this is an ugly hack, but then again so is this the holdBallConstraint
+    m_notTipOverConstraint.reset(new btGeneric6DofSpring2Constraint(*m_body, robotTransform));
+    m_notTipOverConstraint->setAngularLowerLimit(btVector3(0,0,1));
+    m_notTipOverConstraint->setAngularUpperLimit(btVector3(0,0,0));
+    m_notTipOverConstraint->setLinearLowerLimit(btVector3(1,1,1));
+    m_notTipOverConstraint->setLinearUpperLimit(btVector3(0,0,0));
+    m_world->addConstraint(m_notTipOverConstraint.get(),true);
+}
+
 void SimRobot::stopDribbling()
 {
     m_dribblerConstraint->enableAngularMotor(false, 0, 0);
@@ -323,7 +329,7 @@ bool SimRobot::handleMoveCommand()
     return false;
 }
 
-void SimRobot::begin(SimBall *ball, double time)
+void SimRobot::updateCommandTimeout(double time)
 {
     m_commandTime += time;
     m_inStandby = false;
@@ -335,9 +341,19 @@ void SimRobot::begin(SimBall *ball, double time)
         // the real robot switches to standby after a short delay
         m_inStandby = true;
     }
+}
+
+bool SimRobot::isDribbling() const
+{
+    return !m_inStandby && m_sslCommand.has_dribbler_speed() && m_sslCommand.dribbler_speed() > 0;
+}
+
+void SimRobot::begin(SimBall *ball, double time)
+{
+    updateCommandTimeout(time);
 
     // enable dribbler if necessary
-    if (!m_inStandby && m_sslCommand.has_dribbler_speed() && m_sslCommand.dribbler_speed() > 0) {
+    if (isDribbling()) {
         dribble(ball, m_sslCommand.dribbler_speed());
     } else {
         stopDribbling();
@@ -349,59 +365,15 @@ void SimRobot::begin(SimBall *ball, double time)
 
     m_body->setDamping(0.7, 0.8);
 
-    btTransform t = m_body->getWorldTransform();
-    t.setOrigin(btVector3(0,0,0));
-
-    // charge kicker only if enabled
-    if (!m_inStandby && m_charge) {
-        m_shootTime += time;
-        // recharge only after a short timeout, to prevent kick the ball twice
-        if (!m_isCharged && m_shootTime > 0.1) {
-            m_isCharged = true;
-        }
-    } else {
-        m_isCharged = false;
-        m_shootTime = 0.0;
-    }
-    // check if should kick and can do that
-    if (m_isCharged && m_sslCommand.has_kick_speed() && m_sslCommand.kick_speed() > 0 && canKickBall(ball)) {
-        float power = 0.0;
-        const float angle = m_sslCommand.kick_angle()/180*M_PI;
-        const float dirFloor = std::cos(angle);
-        const float dirUp = std::sin(angle);
-
-        stopDribbling();
-
-        if (m_sslCommand.kick_angle() == 0) {
-            power = qBound(0.05f, m_sslCommand.kick_speed(), m_specs.shot_linear_max());
-        } else {
-            // FIXME: for now we just recalc the max distance based on the given angle
-            const float maxShootSpeed = coordinates::chipVelFromChipDistance(m_specs.shot_chip_max());
-            power = qBound(0.05f, m_sslCommand.kick_speed(), maxShootSpeed);
-        }
-
-        const auto getSpeedCompensation = [&]() -> float {
-            if (m_sslCommand.kick_angle() == 0) {
-                return 0.0f;
-            } else {
-                // if the ball hits the robot the chip distance actually decreases
-                const btVector3 relBallSpeed = relativeBallSpeed(ball) / SIMULATOR_SCALE;
-                return std::max((btScalar)0, relBallSpeed.y())
-                    - qBound((btScalar)0, (btScalar)0.5 * relBallSpeed.y(), (btScalar)0.5 * dirFloor);
-            }
-        };
-        const float speedCompensation = getSpeedCompensation();
-
-        ball->kick(t * btVector3(0, dirFloor * power + speedCompensation, dirUp * power) * (1/time) * SIMULATOR_SCALE * BALL_MASS);
-        // discharge
-        m_isCharged = false;
-        m_shootTime = 0.0;
-    }
+    updateKicker(ball, time);
 
     if (m_inStandby || !m_sslCommand.has_move_command() || !m_sslCommand.move_command().has_local_velocity()) {
         return;
     }
 
+    btTransform t = m_body->getWorldTransform();
+    t.setOrigin(btVector3(0,0,0));
+
     float output_v_f = m_sslCommand.move_command().local_velocity().forward();
     float output_v_s = -m_sslCommand.move_command().local_velocity().left();
     float output_omega = m_sslCommand.move_command().local_velocity().angular();
@@ -445,20 +417,11 @@ void SimRobot::begin(SimBall *ball, double time)
     const float K_I_phi = /*0*0.2/1000; //*/ 0.f;
 
     const float a_phi = V_phi*omega + K_phi*error_omega + K_I_phi*error_sum_omega;
-    const bool useBasicAccelLimit = !m_specs.has_simulation_limits();
 
-    float a_phi_bound, a_s_bound, a_f_bound;
-    if (useBasicAccelLimit) {
-        const float accelScale = 2.0f; // let robot accelerate / brake faster than the accelerator does
-        a_f_bound = bound(a_f, v_f, accelScale*m_specs.strategy().a_speedup_f_max(), accelScale*m_specs.strategy().a_brake_f_max());
-        a_s_bound = bound(a_s, v_s, accelScale*m_specs.strategy().a_speedup_s_max(), accelScale*m_specs.strategy().a_brake_s_max());
-        a_phi_bound = bound(a_phi, omega, accelScale*m_specs.strategy().a_speedup_phi_max(), accelScale*m_specs.strategy().a_brake_phi_max());
-    } else {
-        const Eigen::Vector3f limited = limitAcceleration(a_f, a_s, a_phi, v_f, v_s, omega);
-        a_s_bound = limited[0];
-        a_f_bound = limited[1];
-        a_phi_bound = limited[2];
-    }
+    const Eigen::Vector3f bounded = boundAcceleration(a_f, a_s, a_phi, v_f, v_s, omega);
+    const float a_s_bound = bounded[0];
+    const float a_f_bound = bounded[1];
+    const float a_phi_bound = bounded[2];
 
     const btVector3 force(a_s_bound*m_specs.mass(), a_f_bound*m_specs.mass(), 0);
     const btVector3 torque(0, 0, a_phi_bound * 0.007884f);
@@ -469,6 +432,183 @@ void SimRobot::begin(SimBall *ball, double time)
     }
 }
 
+void SimRobot::stepKinematic(SimBall *ball, double time)
+{
+    updateCommandTimeout(time);
+
+    if (handleMoveCommand()) {
+        // a push by force is slowed down by the damping set for it
+        m_body->applyDamping(time);
+    } else {
+        updateKicker(ball, time);
+
+        btTransform t = m_body->getWorldTransform();
+        t.setOrigin(btVector3(0,0,0));
+        const btVector3 v_local = t.inverse() * m_body->getLinearVelocity() / SIMULATOR_SCALE;
+        const float v_f = v_local.y();
+        const float v_s = v_local.x();
+        const float omega = m_body->getAngularVelocity().z();
+
+        // the robot brakes to a stop without a command
+        float v_d_f = 0, v_d_s = 0, omega_d = 0;
+        if (!m_inStandby && m_sslCommand.has_move_command() && m_sslCommand.move_command().has_local_velocity()) {
+            v_d_f = boundSpeed(m_sslCommand.move_command().local_velocity().forward());
+            v_d_s = boundSpeed(-m_sslCommand.move_command().local_velocity().left());
+            omega_d = boundSpeed(m_sslCommand.move_command().local_velocity().angular());
+        }
+
+        // there is no friction to compensate, thus try to reach the commanded speed within one step
+        const Eigen::Vector3f bounded = boundAcceleration((v_d_f - v_f) / time, (v_d_s - v_s) / time, (omega_d - omega) / time,
+                                                          v_f, v_s, omega);
+        const btVector3 newVelocity(v_s + bounded[0] * time, v_f + bounded[1] * time, 0);
+        m_body->setLinearVelocity(t * newVelocity * SIMULATOR_SCALE);
+        m_body->setAngularVelocity(btVector3(0, 0, omega + bounded[2] * time));
+    }
+
+    btTransform transform = m_body->getWorldTransform();
+    btVector3 position = transform.getOrigin() + m_body->getLinearVelocity() * time;
+    position.setZ(m_specs.height() / 2.0f * SIMULATOR_SCALE);
+    transform.setOrigin(position);
+    transform.setRotation(btQuaternion(btVector3(0, 0, 1), m_body->getAngularVelocity().z() * time) * transform.getRotation());
+    m_body->setWorldTransform(transform);
+}
+
+void SimRobot::finishKinematicStep()
+{
+    const btTransform transform = m_body->getWorldTransform();
+    // done by bullet after each step when using rigid body physics
+    m_motionState->setWorldTransform(transform);
+    calculateDribblerMove(transform.getOrigin() / SIMULATOR_SCALE, transform.getRotation(),
+                          m_body->getLinearVelocity(), m_body->getAngularVelocity().z());
+}
+
+bool SimRobot::kinematicContact(const btVector3 &center, btScalar radius, btVector3 &normal, btScalar &depth) const
+{
+    // the robot is a circle which is cut off at the dribbler
+    const btScalar robotRadius = m_specs.radius() * SIMULATOR_SCALE;
+    const btScalar front = kinematicFront();
+    const btScalar frontHalfWidth = std::sqrt(robotRadius * robotRadius - front * front);
+
+    const btTransform &transform = m_body->getWorldTransform();
+    const btVector3 local = transform.invXform(center);
+    const btVector3 p(local.x(), local.y(), 0);
+    const btScalar length = p.length();
+
+    btVector3 localNormal;
+    // signed distance to the robot surface, negative inside of the robot
+    btScalar distance;
+    if (length <= robotRadius && p.y() <= front) {
+        // push out through the closest side
+        const btScalar frontDistance = front - p.y();
+        const btScalar circleDistance = robotRadius - length;
+        if (frontDistance < circleDistance || length < SIMD_EPSILON) {
+            localNormal = btVector3(0, 1, 0);
+            distance = -frontDistance;
+        } else {
+            localNormal = p / length;
+            distance = -circleDistance;
+        }
+    } else {
+        btVector3 closest(qBound(-frontHalfWidth, p.x(), frontHalfWidth), front, 0);
+        const btVector3 onCircle = p * (robotRadius / length);
+        if (onCircle.y() <= front && p.distance2(onCircle) < p.distance2(closest)) {
+            closest = onCircle;
+        }
+        localNormal = p - closest;
+        distance = localNormal.length();
+        localNormal /= distance;
+    }
+
+    depth = radius - distance;
+    if (depth <= 0) {
+        return false;
+    }
+    normal = transform.getBasis() * localNormal;
+    return true;
+}
+
+btScalar SimRobot::kinematicFront() const
+{
+    return std::min(m_specs.shoot_radius(), m_specs.radius()) * SIMULATOR_SCALE;
+}
+
+btVector3 SimRobot::dribbledBallPosition() const
+{
+    return m_body->getWorldTransform() * btVector3(0, kinematicFront() + BALL_RADIUS * SIMULATOR_SCALE,
+                                                   (BALL_RADIUS - m_specs.height() / 2.0f) * SIMULATOR_SCALE);
+}
+
+void SimRobot::updateKicker(SimBall *ball, double time)
+{
+    btTransform t = m_body->getWorldTransform();
+    t.setOrigin(btVector3(0,0,0));
+
+    // charge kicker only if enabled
+    if (!m_inStandby && m_charge) {
+        m_shootTime += time;
+        // recharge only after a short timeout, to prevent kick the ball twice
+        if (!m_isCharged && m_shootTime > 0.1) {
+            m_isCharged = true;
+        }
+    } else {
+        m_isCharged = false;
+        m_shootTime = 0.0;
+    }
+    // check if should kick and can do that
+    if (m_isCharged && m_sslCommand.has_kick_speed() && m_sslCommand.kick_speed() > 0 && canKickBall(ball)) {
+        float power = 0.0;
+        const float angle = m_sslCommand.kick_angle()/180*M_PI;
+        const float dirFloor = std::cos(angle);
+        const float dirUp = std::sin(angle);
+
+        stopDribbling();
+
+        if (m_sslCommand.kick_angle() == 0) {
+            power = qBound(0.05f, m_sslCommand.kick_speed(), m_specs.shot_linear_max());
+        } else {
+            // FIXME: for now we just recalc the max distance based on the given angle
+            const float maxShootSpeed = coordinates::chipVelFromChipDistance(m_specs.shot_chip_max());
+            power = qBound(0.05f, m_sslCommand.kick_speed(), maxShootSpeed);
+        }
+
+        const auto getSpeedCompensation = [&]() -> float {
+            if (m_sslCommand.kick_angle() == 0) {
+                return 0.0f;
+            } else {
+                // if the ball hits the robot the chip distance actually decreases
+                const btVector3 relBallSpeed = relativeBallSpeed(ball) / SIMULATOR_SCALE;
+                return std::max((btScalar)0, relBallSpeed.y())
+                    - qBound((btScalar)0, (btScalar)0.5 * relBallSpeed.y(), (btScalar)0.5 * dirFloor);
+            }
+        };
+        const float speedCompensation = getSpeedCompensation();
+
+        const btVector3 kickVelocity = t * btVector3(0, dirFloor * power + speedCompensation, dirUp * power) * SIMULATOR_SCALE;
+        if (m_kinematic) {
+            ball->kickKinematic(kickVelocity);
+        } else {
+            ball->kick(kickVelocity * (1/time) * BALL_MASS);
+        }
+        // discharge
+        m_isCharged = false;
+        m_shootTime = 0.0;
+    }
+}
+
+Eigen::Vector3f SimRobot::boundAcceleration(float a_f, float a_s, float a_phi, float v_f, float v_s, float omega) const
+{
+    const bool useBasicAccelLimit = !m_specs.has_simulation_limits();
+    if (useBasicAccelLimit) {
+        const float accelScale = 2.0f; // let robot accelerate / brake faster than the accelerator does
+        return {
+            bound(a_s, v_s, accelScale*m_specs.strategy().a_speedup_s_max(), accelScale*m_specs.strategy().a_brake_s_max()),
+            bound(a_f, v_f, accelScale*m_specs.strategy().a_speedup_f_max(), accelScale*m_specs.strategy().a_brake_f_max()),
+            bound(a_phi, omega, accelScale*m_specs.strategy().a_speedup_phi_max(), accelScale*m_specs.strategy().a_brake_phi_max())
+        };
+    }
+    return limitAcceleration(a_f, a_s, a_phi, v_f, v_s, omega);
+}
+
 void SimRobot::generateVelocityCoupling()
 {
     // TODO: configurable wheel angles
@@ -570,6 +710,15 @@ bool SimRobot::canKickBall(SimBall *ball) const
         return true;
     }
 
+    if (m_kinematic) {
+        // the ball must lie directly in front of the dribbler
+        const btVector3 local = m_body->getWorldTransform().invXform(ballPos);
+        const btScalar front = kinematicFront();
+        const btScalar tolerance = 0.005f * SIMULATOR_SCALE;
+        return std::abs(local.x()) <= m_specs.dribbler_width() / 2.0f * SIMULATOR_SCALE
+                && local.y() >= front && local.y() <= front + BALL_RADIUS * SIMULATOR_SCALE + tolerance;
+    }
+
     // check for collision between ball and dribbler
     int numManifolds = m_world->getDispatcher()->getNumManifolds();
     for (int i = 0; i < numManifolds; ++i) {
@@ -673,6 +822,12 @@ void SimRobot::update(world::SimRobot* robot, SimBall *ball) const
     robot->set_r_z(angular.z());
 
     bool ballTouchesRobot = false;
+    if (m_kinematic) {
+        btVector3 normal;
+        btScalar depth;
+        const btScalar tolerance = 0.001f * SIMULATOR_SCALE;
+        ballTouchesRobot = kinematicContact(ball->body()->getWorldTransform().getOrigin(), BALL_RADIUS * SIMULATOR_SCALE + tolerance, normal, depth);
+    }
     int numManifolds = m_world->getDispatcher()->getNumManifolds();
     for (int i = 0; i < numManifolds; ++i) {
         btPersistentManifold *contactManifold = m_world->getDispatcher()->getManifoldByIndexInternal(i);
@@ -700,6 +855,73 @@ void SimRobot::restoreState(const world::SimRobot &robot)
     m_body->setAngularVelocity(angular);
 }
 
+void SimRobot::writeSnapshot(QDataStream &stream) const
+{
+    writeBodyState(stream, m_body);
+    writeBodyState(stream, m_dribblerBody);
+    // both are empty until the first teleport or command, the required robot id is not set then
+    stream << QByteArray::fromStdString(m_move.SerializePartialAsString());
+    stream << QByteArray::fromStdString(m_sslCommand.SerializePartialAsString());
+    stream << m_charge << m_isCharged << m_inStandby << m_shootTime << m_commandTime;
+    stream << error_sum_v_s << error_sum_v_f << error_sum_omega << m_lastSendTime;
+
+    // the dribbler motor is set again on every tick, but the ball constraint is only created once
+    stream << bool(m_holdBallConstraint);
+    if (m_holdBallConstraint) {
+        writeVector(stream, m_holdBallConstraint->getPivotInA());
+        writeTransform(stream, m_notTipOverConstraint->getFrameOffsetA());
+        writeTransform(stream, m_notTipOverConstraint->getFrameOffsetB());
+    }
+}
+
+SimRobot::Snapshot SimRobot::readSnapshot(QDataStream &stream)
+{
+    Snapshot snapshot;
+    snapshot.body = readBodyState(stream);
+    snapshot.dribblerBody = readBodyState(stream);
+    QByteArray move, command;
+    stream >> move >> command;
+    if (!snapshot.move.ParsePartialFromArray(move.constData(), move.size())
+            || !snapshot.command.ParsePartialFromArray(command.constData(), command.size())) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+    }
+    stream >> snapshot.charge >> snapshot.isCharged >> snapshot.inStandby >> snapshot.shootTime >> snapshot.commandTime;
+    stream >> snapshot.errorSumVS >> snapshot.errorSumVF >> snapshot.errorSumOmega >> snapshot.lastSendTime;
+
+    stream >> snapshot.holdsBall;
+    if (snapshot.holdsBall) {
+        snapshot.ballInRobot = readVector(stream);
+        snapshot.fixedFrame = readTransform(stream);
+        snapshot.robotTransform = readTransform(stream);
+    }
+    return snapshot;
+}
+
+void SimRobot::restoreSnapshot(const Snapshot &snapshot, SimBall *ball)
+{
+    stopDribbling();
+
+    applyBodyState(snapshot.body, m_body);
+    applyBodyState(snapshot.dribblerBody, m_dribblerBody);
+    m_move = snapshot.move;
+    m_sslCommand = snapshot.command;
+    m_charge = snapshot.charge;
+    m_isCharged = snapshot.isCharged;
+    m_inStandby = snapshot.inStandby;
+    m_shootTime = snapshot.shootTime;
+    m_commandTime = snapshot.commandTime;
+    error_sum_v_s = snapshot.errorSumVS;
+    error_sum_v_f = snapshot.errorSumVF;
+    error_sum_omega = snapshot.errorSumOmega;
+    m_lastSendTime = snapshot.lastSendTime;
+
+    if (snapshot.holdsBall) {
+        holdBall(ball, snapshot.ballInRobot, snapshot.robotTransform);
+        // the fixed frame was derived from the robot position when the ball was caught
+        m_notTipOverConstraint->setFrames(snapshot.fixedFrame, snapshot.robotTransform);
+    }
+}
+
 void SimRobot::move(const sslsim::TeleportRobot &robot)
 {
     m_move = robot;
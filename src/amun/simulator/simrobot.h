@@ -27,7 +27,9 @@
 #include <Eigen/Dense>
 #include <Eigen/QR>
 #include <btBulletDynamicsCommon.h>
+#include "bodystate.h"
 
+class QDataStream;
 class RNG;
 class SSL_DetectionRobot;
 
@@ -43,7 +45,7 @@ class camun::simulator::SimRobot: public QObject
 {
     Q_OBJECT
 public:
-    SimRobot(RNG *rng, const robot::Specs &specs, btDiscreteDynamicsWorld *world, const btVector3 &pos, float dir);
+    SimRobot(RNG *rng, const robot::Specs &specs, btDiscreteDynamicsWorld *world, const btVector3 &pos, float dir, uint coverSegments);
     ~SimRobot();
     SimRobot(const SimRobot&) = delete;
     SimRobot& operator=(const SimRobot&) = delete;
@@ -53,21 +55,57 @@ signals:
 
 public:
     void begin(SimBall *ball, double time);
+    // kinematic simulation without rigid body physics, see KinematicSimulation
+    void stepKinematic(SimBall *ball, double time);
+    // updates the parts which bullet updates after a step, call after moving the robot body
+    void finishKinematicStep();
+    // contact of a circle in the xy-plane with the robot, the normal points away from the robot
+    bool kinematicContact(const btVector3 &center, btScalar radius, btVector3 &normal, btScalar &depth) const;
+    // position of a ball held by the dribbler
+    btVector3 dribbledBallPosition() const;
+    bool isDribbling() const;
     bool canKickBall(SimBall *ball) const;
     void tryKick(SimBall *ball, float power, double time);
     robot::RadioResponse setCommand(const sslsim::RobotCommand &command, SimBall *ball, bool charge, float rxLoss, float txLoss);
     void update(SSL_DetectionRobot *robot, float stddev_p, float stddev_phi, qint64 time, btVector3 positionOffset);
     void update(world::SimRobot *robot, SimBall *ball) const;
     void restoreState(const world::SimRobot &robot);
+    // complete state including the current command and dribbling constraint, used by Simulator::snapshot
+    struct Snapshot
+    {
+        BodyState body;
+        BodyState dribblerBody;
+        sslsim::TeleportRobot move;
+        sslsim::RobotCommand command;
+        bool charge = false;
+        bool isCharged = false;
+        bool inStandby = false;
+        double shootTime = 0;
+        double commandTime = 0;
+        float errorSumVS = 0;
+        float errorSumVF = 0;
+        float errorSumOmega = 0;
+        qint64 lastSendTime = 0;
+        bool holdsBall = false;
+        btVector3 ballInRobot;
+        btTransform fixedFrame;
+        btTransform robotTransform;
+    };
+    void writeSnapshot(QDataStream &stream) const;
+    // sets the stream status to ReadCorruptData if the snapshot can't be parsed
+    static Snapshot readSnapshot(QDataStream &stream);
+    void restoreSnapshot(const Snapshot &snapshot, SimBall *ball);
     void move(const sslsim::TeleportRobot &robot);
     bool isFlipped();
     btVector3 position() const;
     btVector3 dribblerCorner(bool left) const;
     qint64 getLastSendTime() const { return m_lastSendTime; }
     void setDribbleMode(bool perfectDribbler);
+    void setKinematic(bool kinematic) { m_kinematic = kinematic; }
     void stopDribbling();
 
     const robot::Specs& specs() const { return m_specs; }
+    btRigidBody *body() const { return m_body; }
 
 private:
     btVector3 relativeBallSpeed(SimBall *ball) const;
@@ -75,7 +113,14 @@ private:
     void calculateDribblerMove(const btVector3 pos, const btQuaternion rot, const btVector3 linVel, float omega);
     // returns {a_s, a_f, a_phi} bounded
     Eigen::Vector3f limitAcceleration(float a_f, float a_s, float a_phi, float v_f, float v_s, float omega) const;
+    // returns {a_s, a_f, a_phi} bounded, using limitAcceleration if the specs contain simulation limits
+    Eigen::Vector3f boundAcceleration(float a_f, float a_s, float a_phi, float v_f, float v_s, float omega) const;
+    void updateCommandTimeout(double time);
+    void updateKicker(SimBall *ball, double time);
+    // distance of the dribbler from the robot center for the kinematic simulation
+    btScalar kinematicFront() const;
     void dribble(SimBall *ball, float speed);
+    void holdBall(SimBall *ball, const btVector3 &ballInRobot, const btTransform &robotTransform);
     bool handleMoveCommand();
     void reportAccelerationLimits() const;
     void generateVelocityCoupling();
@@ -112,6 +157,7 @@ private:
     float error_sum_omega;
 
     bool m_perfectDribbler = false;
+    bool m_kinematic = false;
 
     qint64 m_lastSendTime = 0;
 
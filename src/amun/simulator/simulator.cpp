@@ -19,6 +19,9 @@
  ***************************************************************************/
 
 #include "simulator.h"
+#include "bodystate.h"
+#include "cameragrid.h"
+#include "kinematicsimulation.h"
 #include "core/rng.h"
 #include "core/timer.h"
 #include "core/coordinates.h"
@@ -28,11 +31,15 @@
 #include "simfield.h"
 #include "simrobot.h"
 #include "erroraggregator.h"
+#include <QDataStream>
+#include <QMetaMethod>
 #include <QTimer>
 #include <algorithm>
+#include <cmath>
 #include <QtDebug>
 #include <QVector>
 #include <cstdint>
+#include <sstream>
 
 using namespace camun::simulator;
 
@@ -63,6 +70,45 @@ using namespace camun::simulator;
  * => f_b = 1; f_f = 0.35; f_r = 0.22
  */
 
+static const qint32 SNAPSHOT_VERSION = 2;
+
+// physics parameters of a SimulatorSetup::Fidelity
+struct FidelityProfile
+{
+    btScalar subTimestep;
+    int maxSubSteps;
+    int solverIterations;
+    // segments of the round part of the robot cover
+    uint robotCoverSegments;
+    // use KinematicSimulation instead of bullet
+    bool kinematic;
+};
+
+static FidelityProfile fidelityProfile(amun::SimulatorSetup::Fidelity fidelity)
+{
+    switch (fidelity) {
+    case amun::SimulatorSetup::FAST:
+        // limit the simulated time per call to 50 ms, just like for the accurate profile
+        return {1/100.f, 5, 4, 8, false};
+    case amun::SimulatorSetup::KINEMATIC:
+        // the robot meshes are only used to check the ball visibility
+        return {SUB_TIMESTEP, 10, 10, 8, true};
+    case amun::SimulatorSetup::ACCURATE:
+    default:
+        // 10 iterations is the default of bullet
+        return {SUB_TIMESTEP, 10, 10, 20, false};
+    }
+}
+
+// the fraction of a time step which was not simulated yet is part of the simulator state
+class SimulatorWorld : public btDiscreteDynamicsWorld
+{
+public:
+    using btDiscreteDynamicsWorld::btDiscreteDynamicsWorld;
+    btScalar localTime() const { return m_localTime; }
+    void setLocalTime(btScalar localTime) { m_localTime = localTime; }
+};
+
 struct camun::simulator::SimulatorData
 {
     RNG rng;
@@ -70,10 +116,11 @@ struct camun::simulator::SimulatorData
     btCollisionDispatcher *dispatcher;
     btBroadphaseInterface *overlappingPairCache;
     btSequentialImpulseConstraintSolver *solver;
-    btDiscreteDynamicsWorld *dynamicsWorld;
+    SimulatorWorld *dynamicsWorld;
     world::Geometry geometry;
     QVector<SSL_GeometryCameraCalibration> reportedCameraSetup;
     QVector<btVector3> cameraPositions;
+    CameraGrid cameraGrid;
     SimField *field;
     SimBall *ball;
     Simulator::RobotMap robotsBlue;
@@ -97,6 +144,12 @@ struct camun::simulator::SimulatorData
     bool dribblePerfect;
     float missingRobotDetections;
     uint64_t commandDelay;
+    FidelityProfile fidelity;
+    // only set for the kinematic fidelity
+    KinematicSimulation *kinematics;
+    // serialized SSL_WrapperPacket only containing the geometry, empty if outdated
+    QByteArray serializedGeometry;
+    std::vector<char> visionArenaBlock;
 };
 
 static void simulatorTickCallback(btDynamicsWorld *world, btScalar timeStep)
@@ -105,14 +158,27 @@ static void simulatorTickCallback(btDynamicsWorld *world, btScalar timeStep)
     sim->handleSimulatorTick(timeStep);
 }
 
+static void updateCameraGrid(SimulatorData *data)
+{
+    const float width = data->geometry.field_width() + 2 * data->geometry.boundary_width();
+    const float height = data->geometry.field_height() + 2 * data->geometry.boundary_width();
+    data->cameraGrid.rebuild(data->cameraPositions, data->cameraOverlap, width, height);
+}
+
 /*!
  * \class Simulator
  * \ingroup simulator
  * \brief %Simulator interface
  */
 
-Simulator::Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool useManualTrigger) :
+Simulator::Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool useManualTrigger,
+                     std::shared_ptr<RadioCommandRing> radioCommandRing) :
+    m_radioCommandRing(radioCommandRing ? radioCommandRing : std::make_shared<RadioCommandRing>()),
+    // commands dropped before a previous simulator was replaced are not reported again
+    m_reportedDroppedBlue(m_radioCommandRing->droppedCommands(true)),
+    m_reportedDroppedYellow(m_radioCommandRing->droppedCommands(false)),
     m_isPartial(useManualTrigger),
+    m_deterministic(false),
     m_timer(timer),
     m_time(0),
     m_lastSentStatusTime(0),
@@ -130,6 +196,10 @@ Simulator::Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool
     if (!m_isPartial) {
         connect(m_trigger, SIGNAL(timeout()), SLOT(process()));
     }
+    m_visionTimer = new QTimer(this);
+    m_visionTimer->setTimerType(Qt::PreciseTimer);
+    m_visionTimer->setSingleShot(true);
+    connect(m_visionTimer, SIGNAL(timeout()), SLOT(sendDueVisionPackets()));
 
     // setup bullet
     m_data = new SimulatorData;
@@ -137,9 +207,11 @@ Simulator::Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool
     m_data->dispatcher = new btCollisionDispatcher(m_data->collision);
     m_data->overlappingPairCache = new btDbvtBroadphase();
     m_data->solver = new btSequentialImpulseConstraintSolver;
-    m_data->dynamicsWorld = new btDiscreteDynamicsWorld(m_data->dispatcher, m_data->overlappingPairCache, m_data->solver, m_data->collision);
+    m_data->dynamicsWorld = new SimulatorWorld(m_data->dispatcher, m_data->overlappingPairCache, m_data->solver, m_data->collision);
     m_data->dynamicsWorld->setGravity(btVector3(0.0f, 0.0f, -9.81f * SIMULATOR_SCALE));
     m_data->dynamicsWorld->setInternalTickCallback(simulatorTickCallback, this, true);
+    m_data->fidelity = fidelityProfile(setup.fidelity());
+    m_data->dynamicsWorld->getSolverInfo().m_numIterations = m_data->fidelity.solverIterations;
 
     m_data->geometry.CopyFrom(setup.geometry());
     for (const auto& camera : setup.camera_setup()) {
@@ -155,6 +227,7 @@ Simulator::Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool
     m_data->field = new SimField(m_data->dynamicsWorld, m_data->geometry);
     m_data->ball = new SimBall(&m_data->rng, m_data->dynamicsWorld);
     connect(m_data->ball, &SimBall::sendSSLSimError, m_aggregator, &ErrorAggregator::aggregate);
+    m_data->kinematics = m_data->fidelity.kinematic ? new KinematicSimulation(m_data->geometry) : nullptr;
     m_data->flip = false;
     m_data->stddevBall = 0.0f;
     m_data->stddevBallArea = 0.0f;
@@ -172,6 +245,8 @@ Simulator::Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool
     m_data->dribblePerfect = false;
     m_data->missingRobotDetections = 0;
     m_data->commandDelay = 0;
+    m_data->visionArenaBlock.resize(32 * 1024);
+    updateCameraGrid(m_data);
 
     // no robots after initialisation
 
@@ -194,6 +269,7 @@ Simulator::~Simulator()
     deleteAll(m_data->robotsYellow);
     delete m_data->ball;
     delete m_data->field;
+    delete m_data->kinematics;
     delete m_data->dynamicsWorld;
     delete m_data->solver;
     delete m_data->overlappingPairCache;
@@ -209,11 +285,15 @@ void Simulator::process()
 
     const qint64 current_time = m_timer->currentTime();
 
-    // first: send vision packets in partial mode
-    if (m_isPartial) {
-        while(m_visionPackets.size() > 0 && std::get<2>(m_visionPackets.head()) >= current_time) {
-            sendVisionPacket();
-        }
+    // first: send the vision packets which are due
+    sendDueVisionPackets();
+
+    const qint64 ingestionDelay = fetchRadioCommands();
+    if (m_deterministic) {
+        // the commands of both teams may arrive in any order, sort them by their creation time, blue first
+        std::stable_sort(m_radioCommands.begin(), m_radioCommands.end(), [](const RadioCommand &a, const RadioCommand &b) {
+            return std::make_tuple(std::get<1>(a), !std::get<2>(a)) < std::make_tuple(std::get<1>(b), !std::get<2>(b));
+        });
     }
 
     // collect responses from robots
@@ -268,39 +348,34 @@ void Simulator::process()
 
     // simulate to current strategy time
     double timeDelta = (current_time - m_time) * 1E-9;
-    m_data->dynamicsWorld->stepSimulation(timeDelta, 10, SUB_TIMESTEP);
+    if (m_data->kinematics) {
+        stepKinematics(timeDelta);
+    } else {
+        m_data->dynamicsWorld->stepSimulation(timeDelta, m_data->fidelity.maxSubSteps, m_data->fidelity.subTimestep);
+    }
     m_time = current_time;
 
     // only send a vision packet every third frame = 15 ms - epsilon (=half frame)
     // gives a vision frequency of 66.67Hz
     if (m_lastSentStatusTime + 12500000 <= m_time) {
         auto data = createVisionPacket();
-
-
-
-        if (m_isPartial) {
-            std::get<2>(data) = m_time + m_visionDelay;
-            m_visionPackets.enqueue(data);
-        } else {
-            m_visionPackets.enqueue(data);
-            // timeout is in milliseconds
-            int timeout = m_visionDelay * 1E-6 / m_timeScaling;
-
-            // send after timeout, default timer mode, may jitter a bit
-            QTimer *timer = new QTimer();
-            timer->setTimerType(Qt::PreciseTimer);
-            timer->setSingleShot(true);
-            connect(timer, SIGNAL(timeout()), SLOT(sendVisionPacket()));
-            timer->start(timeout);
-            m_visionTimers.enqueue(timer);
-        }
+        std::get<2>(data) = m_time + m_visionDelay;
+        enqueueVisionPacket(data);
+        // sends the packet right away without vision delay
+        sendDueVisionPackets();
 
         m_lastSentStatusTime = m_time;
     }
 
-    // send timing information
+    // send timing information, it depends on the machine
+    if (m_deterministic) {
+        return;
+    }
     Status status(new amun::Status);
     status->mutable_timing()->set_simulator((Timer::systemTime() - start_time) * 1E-9f);
+    if (ingestionDelay >= 0) {
+        status->mutable_timing()->set_simulator_command_ingestion(ingestionDelay * 1E-9f);
+    }
     emit sendStatus(status);
 }
 
@@ -313,8 +388,10 @@ void Simulator::sendSSLSimErrorInternal(ErrorSource source)
 
 static void createRobot(Simulator::RobotMap &list, float x, float y, uint32_t id, const ErrorAggregator* agg, SimulatorData* data, const QMap<uint32_t, robot::Specs>& teamSpecs)
 {
-    SimRobot *robot = new SimRobot(&data->rng, teamSpecs[id], data->dynamicsWorld, btVector3(x, y, 0), 0.f);
+    SimRobot *robot = new SimRobot(&data->rng, teamSpecs[id], data->dynamicsWorld, btVector3(x, y, 0), 0.f,
+                                   data->fidelity.robotCoverSegments);
     robot->setDribbleMode(data->dribblePerfect);
+    robot->setKinematic(data->fidelity.kinematic);
     robot->connect(robot, &SimRobot::sendSSLSimError, agg, &ErrorAggregator::aggregate);
     list[id] = {robot, teamSpecs[id].generation()};
 
@@ -329,10 +406,12 @@ void Simulator::resetFlipped(Simulator::RobotMap &robots, float side)
     for (RobotMap::iterator it = robots.begin(); it != robots.end(); ++it) {
         SimRobot *robot = it.value().first;
         if (robot->isFlipped()) {
-            SimRobot *new_robot = new SimRobot(&m_data->rng, robot->specs(), m_data->dynamicsWorld, btVector3(x, side * y, 0), 0.0f);
+            SimRobot *new_robot = new SimRobot(&m_data->rng, robot->specs(), m_data->dynamicsWorld, btVector3(x, side * y, 0), 0.0f,
+                                               m_data->fidelity.robotCoverSegments);
             delete robot;
             connect(new_robot, &SimRobot::sendSSLSimError, m_aggregator, &ErrorAggregator::aggregate); // TODO? use createRobot instead of this. However, doing so naively will break the iteration, so I left it for now.
             new_robot->setDribbleMode(m_data->dribblePerfect);
+            new_robot->setKinematic(m_data->fidelity.kinematic);
             it.value().first = new_robot;
         }
         y -= 0.3;
@@ -353,7 +432,7 @@ void Simulator::handleSimulatorTick(double timeStep)
     }
 
     // apply commands and forces to ball and robots
-    m_data->ball->begin();
+    m_data->ball->begin(timeStep);
     for(const auto& pair : m_data->robotsBlue) {
         pair.first->begin(m_data->ball, timeStep);
     }
@@ -366,19 +445,24 @@ void Simulator::handleSimulatorTick(double timeStep)
     m_data->dynamicsWorld->applyGravity();
 }
 
-static bool checkCameraID(const int cameraId, const btVector3 &p, const QVector<btVector3> &cameraPositions, const float overlap)
+void Simulator::stepKinematics(double timeDelta)
 {
-    float minDistance = std::numeric_limits<float>::max();
-    float ownDistance = 0;
-    for (int i = 0;i<cameraPositions.size();i++) {
-        // manhattan distance for rectangular camera regions (if the cameras are distributed normally)
-        float distance = std::abs(cameraPositions[i].x() - p.x()) + std::abs(cameraPositions[i].y() - p.y());
-        minDistance = std::min(minDistance, distance);
-        if (i == cameraId) {
-            ownDistance = distance;
-        }
+    // same fixed steps as bullet, the remaining time is simulated in the next call
+    const btScalar subTimestep = m_data->fidelity.subTimestep;
+    const btScalar localTime = m_data->dynamicsWorld->localTime() + timeDelta;
+    const int steps = int(localTime / subTimestep);
+    m_data->dynamicsWorld->setLocalTime(localTime - steps * subTimestep);
+
+    std::vector<SimRobot*> robots;
+    for (const auto& pair : m_data->robotsBlue) {
+        robots.push_back(pair.first);
+    }
+    for (const auto& pair : m_data->robotsYellow) {
+        robots.push_back(pair.first);
+    }
+    for (int i = 0; i < std::min(steps, m_data->fidelity.maxSubSteps); i++) {
+        m_data->kinematics->step(m_data->ball, robots, subTimestep);
     }
-    return ownDistance <= minDistance + 2 * overlap;
 }
 
 void Simulator::initializeDetection(SSL_DetectionFrame *detection, std::size_t cameraId)
@@ -403,27 +487,85 @@ static btVector3 positionOffsetForCamera(float offsetStrength, btVector3 cameraP
     return btVector3(cameraPos.x(), cameraPos.y(), 0).normalized() * offsetStrength;
 }
 
+static QByteArray createGeometryPacket(const SimulatorData *data)
+{
+    SSL_WrapperPacket packet;
+    SSL_GeometryData *geometry = packet.mutable_geometry();
+    SSL_GeometryFieldSize *field = geometry->mutable_field();
+    convertToSSlGeometry(data->geometry, field);
+
+    const btVector3 positionErrorSimScale = btVector3(0.3f, 0.7f, 0.05f).normalized() * data->cameraPositionError;
+    btVector3 positionErrorVisionScale{0, 0, positionErrorSimScale.z() * 1000};
+    coordinates::toVision(positionErrorSimScale, positionErrorVisionScale);
+    for (const auto &calibration : data->reportedCameraSetup) {
+        auto calib = geometry->add_calib();
+        calib->CopyFrom(calibration);
+        calib->set_derived_camera_world_tx(calib->derived_camera_world_tx() + positionErrorVisionScale.x());
+        calib->set_derived_camera_world_ty(calib->derived_camera_world_ty() + positionErrorVisionScale.y());
+        calib->set_derived_camera_world_tz(calib->derived_camera_world_tz() + positionErrorVisionScale.z());
+    }
+
+    // add ball model to geometry data
+    geometry->mutable_models()->mutable_straight_two_phase()->set_acc_roll(BALL_ACC_ROLL);
+    geometry->mutable_models()->mutable_straight_two_phase()->set_acc_slide(BALL_ACC_SLIDE);
+    geometry->mutable_models()->mutable_straight_two_phase()->set_k_switch(BALL_K_SWITCH);
+    geometry->mutable_models()->mutable_chip_fixed_loss()->set_damping_z(BALL_DAMPING_Z);
+    geometry->mutable_models()->mutable_chip_fixed_loss()->set_damping_xy_first_hop(BALL_DAMPING_XY_FIRST_HOP);
+    geometry->mutable_models()->mutable_chip_fixed_loss()->set_damping_xy_other_hops(BALL_DAMPING_XY_OTHER_HOPS);
+
+    QByteArray d;
+    d.resize(packet.ByteSize());
+    if (!packet.SerializeToArray(d.data(), d.size())) {
+        d = {};
+    }
+    return d;
+}
+
 std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket()
 {
     const std::size_t numCameras = m_data->reportedCameraSetup.size();
-    world::SimulatorState simState;
-    simState.set_time(m_time);
+    // the true simulator state is only serialized if anyone is interested in it
+    static const QMetaMethod sendRealDataSignal = QMetaMethod::fromSignal(&Simulator::sendRealData);
+    const bool createTruth = isSignalConnected(sendRealDataSignal);
+
+    // the ray tests for the ball visibility use the bounding boxes, bullet only updates them during a step
+    if (m_data->kinematics && m_data->enableInvisibleBall) {
+        m_data->dynamicsWorld->updateAabbs();
+    }
+
+    // all messages of a frame are allocated in the arena, its first block is reused between frames
+    google::protobuf::ArenaOptions options;
+    options.initial_block = m_data->visionArenaBlock.data();
+    options.initial_block_size = m_data->visionArenaBlock.size();
+    google::protobuf::Arena arena(options);
 
-    std::vector<SSL_DetectionFrame> detections(numCameras);
+    world::SimulatorState *simState = google::protobuf::Arena::CreateMessage<world::SimulatorState>(&arena);
+    simState->set_time(m_time);
+
+    // add a wrapper packet for all detections (also for empty ones).
+    // The reason is that other teams might rely on the fact that these detections are in regular intervals.
+    std::vector<SSL_WrapperPacket*> packets(std::max<std::size_t>(numCameras, 1));
+    std::vector<SSL_DetectionFrame*> detections(numCameras);
+    for (std::size_t i = 0;i<packets.size();i++) {
+        packets[i] = google::protobuf::Arena::CreateMessage<SSL_WrapperPacket>(&arena);
+    }
     for (std::size_t i = 0;i<numCameras;i++) {
-        initializeDetection(&detections[i], i);
+        detections[i] = packets[i]->mutable_detection();
+        initializeDetection(detections[i], i);
     }
 
-    auto* ball = simState.mutable_ball();
-    m_data->ball->writeBallState(ball);
+    if (createTruth) {
+        m_data->ball->writeBallState(simState->mutable_ball());
+    }
 
     const btVector3 ballPosition = m_data->ball->position() / SIMULATOR_SCALE;
     if (m_time - m_lastBallSendTime >= m_minBallDetectionTime) {
         m_lastBallSendTime = m_time;
 
+        // at least one camera is always valid
+        const CameraGrid::CameraSet ballCameras = m_data->cameraGrid.visibleCameras(ballPosition);
         for (std::size_t cameraId = 0; cameraId < numCameras; ++cameraId) {
-            // at least one id is always valid
-            if (!checkCameraID(cameraId, ballPosition, m_data->cameraPositions, m_data->cameraOverlap)) {
+            if (!CameraGrid::contains(ballCameras, cameraId)) {
                 continue;
             }
 
@@ -434,10 +576,10 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
 
             // get ball position
             const btVector3 positionOffset = positionOffsetForCamera(m_data->objectPositionOffset, m_data->cameraPositions[cameraId]);
-            bool visible = m_data->ball->update(detections[cameraId].add_balls(), m_data->stddevBall, m_data->stddevBallArea, m_data->cameraPositions[cameraId],
+            bool visible = m_data->ball->update(detections[cameraId]->add_balls(), m_data->stddevBall, m_data->stddevBallArea, m_data->cameraPositions[cameraId],
                     m_data->enableInvisibleBall, m_data->ballVisibilityThreshold, positionOffset);
             if (!visible) {
-                detections[cameraId].clear_balls();
+                detections[cameraId]->clear_balls();
             }
         }
     }
@@ -448,16 +590,19 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
 
         for (const auto& it : team) {
             SimRobot* robot = it.first;
-            auto* robotProto = teamIsBlue ? simState.add_blue_robots() : simState.add_yellow_robots();
-            robot->update(robotProto, m_data->ball);
+            if (createTruth) {
+                auto* robotProto = teamIsBlue ? simState->add_blue_robots() : simState->add_yellow_robots();
+                robot->update(robotProto, m_data->ball);
+            }
 
             if (m_time - robot->getLastSendTime() >= m_minRobotDetectionTime) {
                 const float timeDiff = (m_time - robot->getLastSendTime()) * 1E-9;
                 const btVector3 robotPos = robot->position() / SIMULATOR_SCALE;
+                const CameraGrid::CameraSet robotCameras = m_data->cameraGrid.visibleCameras(robotPos);
 
                 for (std::size_t cameraId = 0; cameraId < numCameras; ++cameraId) {
 
-                    if (!checkCameraID(cameraId, robotPos, m_data->cameraPositions, m_data->cameraOverlap)) {
+                    if (!CameraGrid::contains(robotCameras, cameraId)) {
                         continue;
                     }
 
@@ -468,9 +613,9 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
 
                     const btVector3 positionOffset = positionOffsetForCamera(m_data->objectPositionOffset, m_data->cameraPositions[cameraId]);
                     if (teamIsBlue) {
-                        robot->update(detections[cameraId].add_robots_blue(), m_data->stddevRobot, m_data->stddevRobotPhi, m_time, positionOffset);
+                        robot->update(detections[cameraId]->add_robots_blue(), m_data->stddevRobot, m_data->stddevRobotPhi, m_time, positionOffset);
                     } else {
-                        robot->update(detections[cameraId].add_robots_yellow(), m_data->stddevRobot, m_data->stddevRobotPhi, m_time, positionOffset);
+                        robot->update(detections[cameraId]->add_robots_yellow(), m_data->stddevRobot, m_data->stddevRobotPhi, m_time, positionOffset);
                     }
 
                     // once in a while, add a ball mis-detection at a corner of the dribbler
@@ -478,9 +623,9 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
                     float detectionProb = timeDiff * m_data->ballDetectionsAtDribbler;
                     if (m_data->ballDetectionsAtDribbler > 0 && m_data->rng.uniformFloat(0, 1) < detectionProb) {
                         // always on the right side of the dribbler for now
-                        if (!m_data->ball->addDetection(detections[cameraId].add_balls(), robot->dribblerCorner(false) / SIMULATOR_SCALE,
+                        if (!m_data->ball->addDetection(detections[cameraId]->add_balls(), robot->dribblerCorner(false) / SIMULATOR_SCALE,
                                                         m_data->stddevRobot, 0, m_data->cameraPositions[cameraId], false, 0, positionOffset)) {
-                            detections[cameraId].mutable_balls()->DeleteSubrange(detections[cameraId].balls_size()-1, 1);
+                            detections[cameraId]->mutable_balls()->DeleteSubrange(detections[cameraId]->balls_size()-1, 1);
                         }
                     }
                 }
@@ -488,56 +633,27 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
         }
     }
 
-    std::vector<SSL_WrapperPacket> packets;
-    packets.reserve(numCameras);
-
-    // add a wrapper packet for all detections (also for empty ones).
-    // The reason is that other teams might rely on the fact that these detections are in regular intervals.
-    for (auto &frame : detections) {
-
+    for (SSL_DetectionFrame *frame : detections) {
         // if multiple balls are reported, shuffle them randomly (the tracking might have systematic errors depending on the ball order)
-        if (frame.balls_size() > 1) {
-            std::shuffle(frame.mutable_balls()->begin(), frame.mutable_balls()->end(), rand_shuffle_src);
+        if (frame->balls_size() > 1) {
+            std::shuffle(frame->mutable_balls()->begin(), frame->mutable_balls()->end(), rand_shuffle_src);
         }
-
-        SSL_WrapperPacket packet;
-        packet.mutable_detection()->CopyFrom(frame);
-        packets.push_back(packet);
     }
 
-    // add field geometry
-    if (packets.size() == 0) {
-        packets.push_back(SSL_WrapperPacket());
-    }
-    SSL_GeometryData *geometry = packets[0].mutable_geometry();
-    SSL_GeometryFieldSize *field = geometry->mutable_field();
-    convertToSSlGeometry(m_data->geometry, field);
-
-    const btVector3 positionErrorSimScale = btVector3(0.3f, 0.7f, 0.05f).normalized() * m_data->cameraPositionError;
-    btVector3 positionErrorVisionScale{0, 0, positionErrorSimScale.z() * 1000};
-    coordinates::toVision(positionErrorSimScale, positionErrorVisionScale);
-    for (const auto &calibration : m_data->reportedCameraSetup) {
-        auto calib = geometry->add_calib();
-        calib->CopyFrom(calibration);
-        calib->set_derived_camera_world_tx(calib->derived_camera_world_tx() + positionErrorVisionScale.x());
-        calib->set_derived_camera_world_ty(calib->derived_camera_world_ty() + positionErrorVisionScale.y());
-        calib->set_derived_camera_world_tz(calib->derived_camera_world_tz() + positionErrorVisionScale.z());
+    // the field geometry only changes with the camera position error, it is appended to the first packet.
+    // Concatenating the serialized geometry yields the same bytes as serializing a packet containing it
+    if (m_data->serializedGeometry.isEmpty()) {
+        m_data->serializedGeometry = createGeometryPacket(m_data);
     }
 
-    // add ball model to geometry data
-    geometry->mutable_models()->mutable_straight_two_phase()->set_acc_roll(-0.35);
-    geometry->mutable_models()->mutable_straight_two_phase()->set_acc_slide(-3.9);
-    geometry->mutable_models()->mutable_straight_two_phase()->set_k_switch(0.69);
-    geometry->mutable_models()->mutable_chip_fixed_loss()->set_damping_z(0.566);
-    geometry->mutable_models()->mutable_chip_fixed_loss()->set_damping_xy_first_hop(0.715);
-    geometry->mutable_models()->mutable_chip_fixed_loss()->set_damping_xy_other_hops(1);
-
     // serialize "vision packet"
     QList<QByteArray> data;
     for (std::size_t i = 0; i < packets.size(); ++i) {
-        QByteArray d;
-        d.resize(packets[i].ByteSize());
-        if (packets[i].SerializeToArray(d.data(), d.size())) {
+        const int size = packets[i]->ByteSize();
+        const int geometrySize = i == 0 ? m_data->serializedGeometry.size() : 0;
+        QByteArray d(size + geometrySize, Qt::Uninitialized);
+        if (packets[i]->SerializeToArray(d.data(), size)) {
+            std::copy_n(m_data->serializedGeometry.constData(), geometrySize, d.data() + size);
             data.push_back(d);
         } else {
             data.push_back(QByteArray());
@@ -545,9 +661,11 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
     }
 
     QByteArray d;
-    d.resize(simState.ByteSize());
-    if (!simState.SerializeToArray(d.data(), d.size())) {
-        d = {};
+    if (createTruth) {
+        d.resize(simState->ByteSize());
+        if (!simState->SerializeToArray(d.data(), d.size())) {
+            d = {};
+        }
     }
     return {data,d, 0};
 }
@@ -555,28 +673,100 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
 void Simulator::sendVisionPacket()
 {
     auto currentVisionPackets = m_visionPackets.dequeue();
+    // use the planned delivery time as receive time, this is independent of the timer accuracy
+    const qint64 receiveTime = std::get<2>(currentVisionPackets);
     for (const QByteArray &data : std::get<0>(currentVisionPackets)) {
-        emit gotPacket(data, m_timer->currentTime(), "simulator"); // send "vision packet" and assume instant receiving
-        // the receive time may be a bit jittered just like a real transmission
+        emit gotPacket(data, receiveTime, "simulator"); // send "vision packet" and assume instant receiving
+    }
+    // empty if there was no receiver while creating the packet
+    if (!std::get<1>(currentVisionPackets).isEmpty()) {
+        emit sendRealData(std::get<1>(currentVisionPackets));
+    }
+}
 
+void Simulator::sendDueVisionPackets()
+{
+    const qint64 currentTime = m_timer->currentTime();
+    while (!m_visionPackets.isEmpty() && std::get<2>(m_visionPackets.head()) <= currentTime) {
+        sendVisionPacket();
     }
-    emit sendRealData(std::get<1>(currentVisionPackets));
-    if (!m_isPartial) {
-        QTimer *timer = m_visionTimers.dequeue();
-        timer->deleteLater();
+    scheduleVisionPackets();
+}
+
+void Simulator::enqueueVisionPacket(const std::tuple<QList<QByteArray>, QByteArray, qint64> &packet)
+{
+    // the delivery times are only out of order after reducing the vision delay
+    auto it = m_visionPackets.end();
+    while (it != m_visionPackets.begin() && std::get<2>(*(it - 1)) > std::get<2>(packet)) {
+        --it;
+    }
+    m_visionPackets.insert(it, packet);
+}
+
+void Simulator::scheduleVisionPackets()
+{
+    // with the manual trigger the packets are only sent while processing
+    if (m_isPartial || m_visionPackets.isEmpty() || m_timeScaling <= 0 || !m_enabled) {
+        m_visionTimer->stop();
+        return;
     }
+    // timeout is in milliseconds, round up to never wake up too early
+    const qint64 remaining = std::get<2>(m_visionPackets.head()) - m_timer->currentTime();
+    const int timeout = std::ceil(std::max<qint64>(0, remaining) * 1E-6 / m_timeScaling);
+    m_visionTimer->start(timeout);
 }
 
 void Simulator::resetVisionPackets()
 {
-    qDeleteAll(m_visionTimers);
-    m_visionTimers.clear();
+    m_visionTimer->stop();
     m_visionPackets.clear();
 }
 
 void Simulator::handleRadioCommands(const SSLSimRobotControl &commands, bool isBlue, qint64 processingStart)
 {
-    m_radioCommands.enqueue(std::make_tuple(commands, processingStart, isBlue));
+    m_radioCommandRing->push(commands, isBlue, processingStart);
+}
+
+// moves the commands from the ring into the queue of the simulator thread,
+// returns the largest ingestion delay or -1 if there were no new commands
+qint64 Simulator::fetchRadioCommands()
+{
+    const qint64 now = Timer::systemTime();
+    qint64 maxDelay = -1;
+    RadioCommand command;
+    qint64 pushTime;
+    while (m_radioCommandRing->pop(command, pushTime)) {
+        const qint64 delay = now - pushTime;
+        m_radioCommands.enqueue(std::move(command));
+        maxDelay = std::max(maxDelay, delay);
+
+        m_radioCommandStatistics.receivedCommands++;
+        m_radioCommandStatistics.totalIngestionDelay += delay;
+        m_radioCommandStatistics.maxIngestionDelay = std::max(m_radioCommandStatistics.maxIngestionDelay, delay);
+    }
+
+    // the producers can't wait for the simulator, tell the team that its commands were lost
+    for (bool isBlue : {true, false}) {
+        qint64 &reported = isBlue ? m_reportedDroppedBlue : m_reportedDroppedYellow;
+        const qint64 dropped = m_radioCommandRing->droppedCommands(isBlue);
+        if (dropped > reported) {
+            SSLSimError error{new sslsim::SimulatorError};
+            error->set_code("RADIO_COMMANDS_DROPPED");
+            std::string message = std::to_string(dropped - reported) + " radio commands were dropped";
+            message += ", the simulator could not keep up with the commands";
+            error->set_message(std::move(message));
+            m_aggregator->aggregate(error, isBlue ? ErrorSource::BLUE : ErrorSource::YELLOW);
+            reported = dropped;
+        }
+    }
+    return maxDelay;
+}
+
+Simulator::RadioCommandStatistics Simulator::radioCommandStatistics() const
+{
+    RadioCommandStatistics statistics = m_radioCommandStatistics;
+    statistics.droppedCommands = m_radioCommandRing->droppedCommands(true) + m_radioCommandRing->droppedCommands(false);
+    return statistics;
 }
 
 
@@ -769,10 +959,12 @@ void Simulator::handleCommand(const Command &command)
 
             if (realism.has_camera_overlap()) {
                 m_data->cameraOverlap = realism.camera_overlap();
+                updateCameraGrid(m_data);
             }
 
             if (realism.has_camera_position_error()) {
                 m_data->cameraPositionError = realism.camera_position_error();
+                m_data->serializedGeometry.clear();
             }
 
             if (realism.has_object_position_offset()) {
@@ -885,21 +1077,236 @@ void Simulator::setScaling(double scaling)
         // scale default timing of 5 milliseconds
         const int t = 5 / scaling;
         m_trigger->start(qMax(1, t));
-
-        // The vision packet timings are wrong after a scaling change
-        // In addition if the new scaling is larger than the old one,
-        // this would cause the timers started after the scaling change
-        // to trigger before the old timers, what causes the deletion of
-        // the old timers before they are fired.
-        resetVisionPackets();
     }
     // needed if scaling is set before simulator was enabled
     m_timeScaling = scaling;
+    // the delivery times are in simulated time, only the timeout changes
+    scheduleVisionPackets();
 }
 
 void Simulator::seedPRGN(uint32_t seed)
 {
     m_data->rng.seed(seed);
+    rand_shuffle_src.seed(seed);
+}
+
+void Simulator::setDeterministic(uint32_t seed)
+{
+    Q_ASSERT(m_isPartial);
+    seedPRGN(seed);
+    m_deterministic = true;
+}
+
+static void writeSpecs(QDataStream &stream, const QMap<uint32_t, robot::Specs> &teamSpecs)
+{
+    stream << quint32(teamSpecs.size());
+    for (auto it = teamSpecs.begin(); it != teamSpecs.end(); ++it) {
+        stream << quint32(it.key()) << QByteArray::fromStdString(it.value().SerializePartialAsString());
+    }
+}
+
+static QMap<uint32_t, robot::Specs> readSpecs(QDataStream &stream)
+{
+    QMap<uint32_t, robot::Specs> teamSpecs;
+    quint32 count;
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; i++) {
+        quint32 id;
+        QByteArray specs;
+        stream >> id >> specs;
+        if (!teamSpecs[id].ParsePartialFromArray(specs.constData(), specs.size())) {
+            stream.setStatus(QDataStream::ReadCorruptData);
+        }
+    }
+    return teamSpecs;
+}
+
+QByteArray Simulator::snapshot()
+{
+    fetchRadioCommands();
+
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_4_6);
+
+    stream << SNAPSHOT_VERSION;
+    stream << m_time << m_lastSentStatusTime << m_lastBallSendTime << m_charge;
+    stream << m_data->dynamicsWorld->localTime();
+    const RNG::State rngState = m_data->rng.state();
+    stream << rngState[0] << rngState[1] << rngState[2];
+    std::ostringstream shuffleState;
+    shuffleState << rand_shuffle_src;
+    stream << QByteArray::fromStdString(shuffleState.str());
+
+    stream << quint32(m_lastFrameNumber.size());
+    for (const auto &frameNumber : m_lastFrameNumber) {
+        stream << frameNumber.first << quint32(frameNumber.second);
+    }
+
+    writeSpecs(stream, m_data->specsBlue);
+    writeSpecs(stream, m_data->specsYellow);
+    m_data->ball->writeSnapshot(stream);
+    for (const RobotMap *team : {&m_data->robotsBlue, &m_data->robotsYellow}) {
+        stream << quint32(team->size());
+        for (auto it = team->begin(); it != team->end(); ++it) {
+            stream << quint32(it.key()) << quint32(it.value().second);
+            it.value().first->writeSnapshot(stream);
+        }
+    }
+
+    stream << quint32(m_radioCommands.size());
+    for (const RadioCommand &command : m_radioCommands) {
+        stream << QByteArray::fromStdString(std::get<0>(command)->SerializePartialAsString());
+        stream << std::get<1>(command) << std::get<2>(command);
+    }
+    stream << quint32(m_visionPackets.size());
+    for (const auto &packet : m_visionPackets) {
+        stream << std::get<0>(packet) << std::get<1>(packet) << std::get<2>(packet);
+    }
+    return data;
+}
+
+bool Simulator::restore(const QByteArray &snapshot)
+{
+    QDataStream stream(snapshot);
+    stream.setVersion(QDataStream::Qt_4_6);
+
+    qint32 version;
+    stream >> version;
+    if (stream.status() != QDataStream::Ok || version != SNAPSHOT_VERSION) {
+        return false;
+    }
+
+    // Parse the complete snapshot before touching the simulator, a truncated or corrupt
+    // snapshot must leave the current state unchanged.
+    qint64 time, lastSentStatusTime, lastBallSendTime;
+    bool charge;
+    stream >> time >> lastSentStatusTime >> lastBallSendTime >> charge;
+    btScalar localTime;
+    stream >> localTime;
+    RNG::State rngState;
+    stream >> rngState[0] >> rngState[1] >> rngState[2];
+    QByteArray shuffleState;
+    stream >> shuffleState;
+    std::mt19937 shuffleSource;
+    std::istringstream shuffleStream(shuffleState.toStdString());
+    shuffleStream >> shuffleSource;
+    if (shuffleStream.fail()) {
+        stream.setStatus(QDataStream::ReadCorruptData);
+    }
+
+    std::map<qint64, unsigned> lastFrameNumber;
+    quint32 cameraCount;
+    stream >> cameraCount;
+    for (quint32 i = 0; i < cameraCount && stream.status() == QDataStream::Ok; i++) {
+        qint64 cameraId;
+        quint32 frameNumber;
+        stream >> cameraId >> frameNumber;
+        lastFrameNumber[cameraId] = frameNumber;
+    }
+
+    const QMap<uint32_t, robot::Specs> specsBlue = readSpecs(stream);
+    const QMap<uint32_t, robot::Specs> specsYellow = readSpecs(stream);
+    const SimBall::Snapshot ball = SimBall::readSnapshot(stream);
+    struct RobotSnapshot
+    {
+        quint32 id;
+        quint32 generation;
+        SimRobot::Snapshot state;
+    };
+    std::vector<RobotSnapshot> robotsBlue, robotsYellow;
+    for (bool teamIsBlue : {true, false}) {
+        std::vector<RobotSnapshot> &robots = teamIsBlue ? robotsBlue : robotsYellow;
+        quint32 robotCount;
+        stream >> robotCount;
+        for (quint32 i = 0; i < robotCount && stream.status() == QDataStream::Ok; i++) {
+            RobotSnapshot robot;
+            stream >> robot.id >> robot.generation;
+            robot.state = SimRobot::readSnapshot(stream);
+            const bool duplicate = std::any_of(robots.begin(), robots.end(),
+                                               [&robot](const RobotSnapshot &other) { return other.id == robot.id; });
+            if (duplicate) {
+                stream.setStatus(QDataStream::ReadCorruptData);
+            }
+            robots.push_back(robot);
+        }
+    }
+
+    QQueue<RadioCommand> radioCommands;
+    quint32 commandCount;
+    stream >> commandCount;
+    for (quint32 i = 0; i < commandCount && stream.status() == QDataStream::Ok; i++) {
+        QByteArray control;
+        qint64 processingStart;
+        bool isBlue;
+        stream >> control >> processingStart >> isBlue;
+        SSLSimRobotControl robotControl(new sslsim::RobotControl);
+        if (!robotControl->ParsePartialFromArray(control.constData(), control.size())) {
+            stream.setStatus(QDataStream::ReadCorruptData);
+        }
+        radioCommands.enqueue(std::make_tuple(robotControl, processingStart, isBlue));
+    }
+
+    QQueue<std::tuple<QList<QByteArray>, QByteArray, qint64>> visionPackets;
+    quint32 packetCount;
+    stream >> packetCount;
+    for (quint32 i = 0; i < packetCount && stream.status() == QDataStream::Ok; i++) {
+        QList<QByteArray> packets;
+        QByteArray simState;
+        qint64 packetTime;
+        stream >> packets >> simState >> packetTime;
+        visionPackets.enqueue(std::make_tuple(packets, simState, packetTime));
+    }
+
+    if (stream.status() != QDataStream::Ok || !stream.atEnd()) {
+        return false;
+    }
+
+    m_time = time;
+    m_lastSentStatusTime = lastSentStatusTime;
+    m_lastBallSendTime = lastBallSendTime;
+    m_charge = charge;
+    m_data->rng.setState(rngState);
+    rand_shuffle_src = shuffleSource;
+    m_lastFrameNumber = lastFrameNumber;
+
+    // Rebuild the whole world instead of modifying the existing bodies. The order of the bodies
+    // and the internal caches of bullet influence the simulation, this way they only depend on the snapshot.
+    resetVisionPackets();
+    deleteAll(m_data->robotsBlue);
+    m_data->robotsBlue.clear();
+    deleteAll(m_data->robotsYellow);
+    m_data->robotsYellow.clear();
+    delete m_data->ball;
+    delete m_data->field;
+    // the broadphase only resets once it is empty
+    m_data->overlappingPairCache->resetPool(m_data->dispatcher);
+    m_data->solver->reset();
+    m_data->dynamicsWorld->setLocalTime(localTime);
+
+    m_data->field = new SimField(m_data->dynamicsWorld, m_data->geometry);
+    m_data->ball = new SimBall(&m_data->rng, m_data->dynamicsWorld);
+    connect(m_data->ball, &SimBall::sendSSLSimError, m_aggregator, &ErrorAggregator::aggregate);
+    m_data->specsBlue = specsBlue;
+    m_data->specsYellow = specsYellow;
+    m_data->ball->restoreSnapshot(ball);
+    for (bool teamIsBlue : {true, false}) {
+        RobotMap &team = teamIsBlue ? m_data->robotsBlue : m_data->robotsYellow;
+        const QMap<uint32_t, robot::Specs> &teamSpecs = teamIsBlue ? m_data->specsBlue : m_data->specsYellow;
+        for (const RobotSnapshot &robot : teamIsBlue ? robotsBlue : robotsYellow) {
+            createRobot(team, 0, 0, robot.id, m_aggregator, m_data, teamSpecs);
+            team[robot.id].second = robot.generation;
+            team[robot.id].first->restoreSnapshot(robot.state, m_data->ball);
+        }
+    }
+
+    // commands sent before the restore are discarded
+    fetchRadioCommands();
+    m_radioCommands = radioCommands;
+    m_visionPackets = visionPackets;
+    scheduleVisionPackets();
+
+    return true;
 }
 
 static bool overlapCheck(const btVector3& p0, const float& r0, const btVector3& p1, const float& r1)
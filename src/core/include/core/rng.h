@@ -22,15 +22,20 @@
 #define RNG_H
 
 #include "vector.h"
+#include <array>
 #include <inttypes.h>
 
 class RNG
 {
 public:
+    typedef std::array<uint32_t, 3> State;
+
     explicit RNG(uint32_t seed = 0);
 
 public:
     void seed(uint32_t seed);
+    State state() const { return {m_s1, m_s2, m_s3}; }
+    void setState(const State &state);
     uint32_t uniformInt();
     double uniform();
     double uniformPositive();
@@ -69,6 +69,17 @@ void RNG::seed(uint32_t s)
     }
 }
 
+/*!
+ * \brief Continue a sequence previously saved with \ref state
+ * \param state Internal state of the generator
+ */
+void RNG::setState(const State &state)
+{
+    m_s1 = state[0];
+    m_s2 = state[1];
+    m_s3 = state[2];
+}
+
 /*!
  * \brief Generate a random integer in the range [0, 2^32-1]
  * \return A random number drawn from a uniform distribution [0, 2^32-1]
@@ -25,7 +25,12 @@
 #include <QDebug>
 #include <clocale>
 
+#include "protobuf/gamestate.pb.h"
+#include "protobuf/ssl_referee.pb.h"
+#include "protobuf/status.pb.h"
 #include "seshat/logfilereader.h"
+#include "seshat/logsummary.h"
+#include "seshat/worldstatelog.h"
 
 
 static void ablateStatusRecursive(google::protobuf::Message *message, QList<int> &ablationInfo, int ablationPos)
@@ -177,6 +182,91 @@ static void ablateRandomized(QString filename, LogFileReader &logfile, int itera
     saveResults(filename, fieldSizes);
 }
 
+static void writeRobots(QTextStream &stream, qint64 time, const char *team, const WorldStateColumns::Robots &robots, int frame)
+{
+    for (int r = robots.firstRobot[frame]; r < robots.firstRobot[frame] + robots.robotCount[frame]; r++) {
+        stream << time << "," << team << "," << robots.id[r] << "," << robots.p_x[r] << "," << robots.p_y[r] << ",,"
+               << robots.v_x[r] << "," << robots.v_y[r] << ",," << robots.phi[r] << "," << robots.omega[r] << endl;
+    }
+}
+
+// writes one line per ball and robot of every frame, without parsing the log itself
+static bool exportWorldStates(const QString &logfileName, const QString &outputName)
+{
+    WorldStateLogReader reader;
+    if (!reader.open(WorldStateLogWriter::filenameForLog(logfileName))) {
+        qWarning() << "Could not open the world state log of" << logfileName << ":" << reader.errorMsg();
+        return false;
+    }
+    QFile file(outputName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qWarning() << "Could not open" << outputName;
+        return false;
+    }
+    QTextStream stream(&file);
+    stream << "time,object,id,p_x,p_y,p_z,v_x,v_y,v_z,phi,omega" << endl;
+
+    WorldStateColumns columns;
+    for (int chunk = 0; chunk < reader.chunkCount(); chunk++) {
+        columns.clear();
+        if (!reader.readChunk(chunk, columns)) {
+            qWarning() << "Corrupt world state chunk" << chunk;
+            return false;
+        }
+        for (int frame = 0; frame < columns.frameCount(); frame++) {
+            const qint64 time = columns.time[frame];
+            const WorldStateColumns::Ball &ball = columns.ball;
+            if (ball.valid[frame]) {
+                stream << time << ",ball,," << ball.p_x[frame] << "," << ball.p_y[frame] << "," << ball.p_z[frame] << ","
+                       << ball.v_x[frame] << "," << ball.v_y[frame] << "," << ball.v_z[frame] << ",," << endl;
+            }
+            writeRobots(stream, time, "yellow", columns.yellow, frame);
+            writeRobots(stream, time, "blue", columns.blue, frame);
+        }
+    }
+    return stream.status() == QTextStream::Ok;
+}
+
+static QString summaryEventText(const LogSummary::Event &event)
+{
+    switch (event.type) {
+    case LogSummary::EventType::Stage:
+        return "Stage " + QString::fromStdString(SSL_Referee::Stage_Name(SSL_Referee::Stage(event.value)));
+    case LogSummary::EventType::GameState:
+        return "Game state " + QString::fromStdString(amun::GameState::State_Name(amun::GameState::State(event.value)));
+    case LogSummary::EventType::Score:
+        return QString("Score %1:%2 (yellow:blue)").arg(event.value).arg(event.detail);
+    case LogSummary::EventType::StrategyFailed:
+        return "Strategy failed " + QString::fromStdString(
+                    amun::StatusStrategyWrapper::StrategyType_Name(amun::StatusStrategyWrapper::StrategyType(event.value)));
+    }
+    return QString("Unknown event %1").arg(qint32(event.type));
+}
+
+// lists the events of the game, the summary is created first if the log was recorded without it
+static bool printSummary(const QString &logfileName, const QString &outputName)
+{
+    LogSummary summary;
+    if (!LogSummary::read(logfileName, summary)) {
+        if (!LogSummary::create(logfileName) || !LogSummary::read(logfileName, summary)) {
+            qWarning() << "Could not create the summary of" << logfileName;
+            return false;
+        }
+    }
+    QFile file(outputName);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        qWarning() << "Could not open" << outputName;
+        return false;
+    }
+    QTextStream stream(&file);
+    const qint64 startTime = summary.events.isEmpty() ? 0 : summary.events.first().time;
+    for (const LogSummary::Event &event : summary.events) {
+        stream << QString::number((event.time - startTime) / 1E9, 'f', 1) << "s\t" << summaryEventText(event) << endl;
+    }
+    stream << summary.ball.size() << " ball positions" << endl;
+    return stream.status() == QTextStream::Ok;
+}
+
 int main(int argc, char* argv[])
 {
     QCoreApplication app(argc, argv);
@@ -195,10 +285,16 @@ int main(int argc, char* argv[])
     QCommandLineOption randomizedGroups({"r", "random-groups"}, "Number of random group evaluations used. Random evaluation is only used when this option is set", "randomIterations");
     QCommandLineOption dontShowProgress("no-progress", "Do not show the computation progress.");
     QCommandLineOption dontSaveIntermediateResults("no-temp-saves", "Do not save intermediate results.");
+    QCommandLineOption worldStates("world-states", "Export the world states recorded next to the log as csv "
+                                   "instead of analyzing the memory usage. The log must have been recorded with world state recording enabled.");
+    QCommandLineOption gameSummary("summary", "List the game events of the log using the summary recorded next to it "
+                                   "instead of analyzing the memory usage. The summary is created if it does not exist yet.");
 
     parser.addOption(randomizedGroups);
     parser.addOption(dontShowProgress);
     parser.addOption(dontSaveIntermediateResults);
+    parser.addOption(worldStates);
+    parser.addOption(gameSummary);
 
     // parse command line
     parser.process(app);
@@ -208,6 +304,13 @@ int main(int argc, char* argv[])
         parser.showHelp(1);
     }
 
+    if (parser.isSet(worldStates)) {
+        return exportWorldStates(arguments[0], arguments[1]) ? 0 : 1;
+    }
+    if (parser.isSet(gameSummary)) {
+        return printSummary(arguments[0], arguments[1]) ? 0 : 1;
+    }
+
     LogFileReader logfile;
     QString logfileName = arguments[0];
     QByteArray lognameBytes = logfileName.toUtf8();
@@ -23,8 +23,10 @@
 #include <clocale>
 #include <QtGlobal>
 #include <iostream>
+#include <limits>
 
 #include "logcutter/logprocessor.h"
+#include "seshat/logcodec.h"
 #include "seshat/logfilewriter.h"
 
 
@@ -46,9 +48,22 @@ int main(int argc, char* argv[])
     QCommandLineOption abortExecution({"d", "die-on-error"}, "Die when a problem occurs");
     QCommandLineOption noHash("no-hash", "Do not insert any hash into the resulting logfile");
 
+    QCommandLineOption copyGroups("copy-groups", "Copy the compressed data instead of reencoding every status. "
+                                  "This keeps the original timestamps and can not be combined with the cut options");
+    QCommandLineOption startTime("start", "Only keep the statuses after this time, in seconds since the start of the first log", "seconds");
+    QCommandLineOption endTime("end", "Only keep the statuses before this time, in seconds since the start of the first log", "seconds");
+    QCommandLineOption codec("codec", "Compression of the resulting log file, one of zlib, zstd and lz4. "
+                             "Logs using zstd or lz4 can not be read by older versions", "codec");
+    QCommandLineOption trainDictionary("train-dictionary", "Compress with a dictionary trained on the input logs, requires the zstd codec");
+
     parser.addOption(outputLog);
     parser.addOption(abortExecution);
     parser.addOption(noHash);
+    parser.addOption(copyGroups);
+    parser.addOption(startTime);
+    parser.addOption(endTime);
+    parser.addOption(codec);
+    parser.addOption(trainDictionary);
 
     QCommandLineOption flags({"f", "flags"}, "Flags for the logprocessor. This overwrites the other cut options", "flags", "0");
     QCommandLineOption cutHalt("cut-halt", "Remove halt sections");
@@ -113,6 +128,25 @@ int main(int argc, char* argv[])
             options |= O::CutGit;
     }
 
+    if (parser.isSet(trainDictionary) && parser.value(codec) != "zstd") {
+        std::cerr << "[ ERROR] " << "A dictionary can only be used with the zstd codec" << std::endl;
+        return 1;
+    }
+    LogCodec::Codec outputCodec = LogCodec::Zlib;
+    if (parser.isSet(codec)) {
+        bool found = false;
+        for (LogCodec::Codec c : {LogCodec::Zlib, LogCodec::Zstd, LogCodec::Lz4}) {
+            if (parser.value(codec) == LogCodec::name(c)) {
+                outputCodec = c;
+                found = true;
+            }
+        }
+        if (!found || !LogCodec::isSupported(outputCodec)) {
+            std::cerr << "[ ERROR] " << "Unsupported codec: " << parser.value(codec).toStdString() << std::endl;
+            return 1;
+        }
+    }
+
     std::cout << "[ DEBUG] " << parser.value(outputLog).toStdString() << std::endl;
     LogProcessor lp(
         parser.positionalArguments(),
@@ -121,6 +155,15 @@ int main(int argc, char* argv[])
         nullptr,
         parser.isSet(noHash)
     );
+    lp.setCopyGroups(parser.isSet(copyGroups));
+    if (parser.isSet(codec)) {
+        lp.setCompression(outputCodec, parser.isSet(trainDictionary));
+    }
+    if (parser.isSet(startTime) || parser.isSet(endTime)) {
+        const qint64 start = parser.isSet(startTime) ? qint64(parser.value(startTime).toDouble() * 1E9) : 0;
+        const qint64 end = parser.isSet(endTime) ? qint64(parser.value(endTime).toDouble() * 1E9) : std::numeric_limits<qint64>::max();
+        lp.setTimeRange(start, end);
+    }
     QObject::connect(&lp, &LogProcessor::progressUpdate, [](const QString& progress){
             std::cout << "[STATUS] " << progress.toStdString() << std::endl;
     });
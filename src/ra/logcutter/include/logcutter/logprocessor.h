@@ -22,15 +22,18 @@
 #define LOGPROCESSOR_H
 
 #include "protobuf/logfile.pb.h"
+#include "seshat/logcodec.h"
 
 #include <QThread>
 #include <QList>
 #include <QString>
 #include <QSemaphore>
+#include <limits>
 
 class SeqLogFileReader;
 class Exchanger;
 class LogFileWriter;
+class MappedLogFileReader;
 class Status;
 namespace amun
 {
@@ -62,6 +65,16 @@ public:
     LogProcessor(const LogProcessor&) = delete;
     LogProcessor& operator=(const LogProcessor&) = delete;
 
+    // only keeps the statuses in the range, the times are in nanoseconds relative to the start of the first log
+    void setTimeRange(qint64 start, qint64 end) { m_rangeStart = start; m_rangeEnd = end; }
+    // Copies the compressed packet groups instead of decoding and reencoding every status,
+    // which is only possible without cut options. The original timestamps are retained,
+    // thus concatenated logs must be in chronological order.
+    void setCopyGroups(bool copyGroups) { m_copyGroups = copyGroups; }
+    // Without a codec, the output uses zlib or the codec of the first log when copying groups.
+    // The dictionary is trained on statuses of the input logs and only used by zstd.
+    void setCompression(LogCodec::Codec codec, bool trainDictionary) { m_hasCodec = true; m_codec = codec; m_trainDictionary = trainDictionary; }
+
     void run() override;
 
 signals:
@@ -80,6 +93,9 @@ private:
     void reencode(SeqLogFileReader* reader, Exchanger* writer);
     void sendOutputSelected(LogFileWriter* writer);
     logfile::Uid calculateUid() const;
+    bool copyGroups();
+    bool inTimeRange(qint64 time) const;
+    QByteArray trainDictionary();
 
     QList<QString> m_inputFiles;
     QList<logfile::Uid> m_hashes;
@@ -89,6 +105,14 @@ private:
 
     int m_currentLog;
     bool m_ignoreHashing;
+    bool m_copyGroups = false;
+    bool m_hasCodec = false;
+    LogCodec::Codec m_codec = LogCodec::Zlib;
+    bool m_trainDictionary = false;
+    qint64 m_rangeStart = 0;
+    qint64 m_rangeEnd = std::numeric_limits<qint64>::max();
+    // time of the first status of the first log
+    qint64 m_firstTime = 0;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(LogProcessor::Options)
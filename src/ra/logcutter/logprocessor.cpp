@@ -22,13 +22,20 @@
 #include "seshat/seqlogfilereader.h"
 #include "seshat/logfilewriter.h"
 #include "seshat/logfilehasher.h"
+#include "seshat/loggroupcopier.h"
+#include "seshat/mappedlogfilereader.h"
 #include "protobuf/gamestate.pb.h"
 #include "protobuf/status.pb.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
 #include <QSemaphore>
 #include <QMutex>
 #include <QLinkedList>
 #include <QTemporaryFile>
 #include <QFlags>
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 class Exchanger {
 public:
@@ -128,6 +135,11 @@ LogProcessor::~LogProcessor()
 void LogProcessor::run()
 {
     m_currentLog = 1;
+    m_firstTime = 0;
+
+    if (m_copyGroups && copyGroups()) {
+        return;
+    }
 
     QList<SeqLogFileReader *> logreaders;
     for (int i = 0; i < m_inputFiles.size(); ++i) {
@@ -143,6 +155,9 @@ void LogProcessor::run()
     }
 
     LogFileWriter writer;
+    if (m_hasCodec) {
+        writer.setCompression(m_codec, trainDictionary());
+    }
     if (!writer.open(m_outputFile, m_ignoreHashing)) {
         emit error("Failed to output logfile: " + m_outputFile);
         qDeleteAll(logreaders);
@@ -318,6 +333,10 @@ qint64 LogProcessor::filterLog(SeqLogFileReader &reader, Exchanger *writer, Exch
         }
 
 
+        if (m_firstTime == 0) {
+            m_firstTime = status->time();
+        }
+
         // removed deleted time
         qint64 timeDelta = (lastTime != 0) ? status->time() - lastTime : 0;
         // remove time between log files
@@ -333,7 +352,8 @@ qint64 LogProcessor::filterLog(SeqLogFileReader &reader, Exchanger *writer, Exch
             lastGameState = status->game_state();
         }
 
-        if (skipStatus(lastGameState, isSimulated)) {
+        const bool outOfRange = !inTimeRange(status->time());
+        if (outOfRange || skipStatus(lastGameState, isSimulated)) {
             // the frame contains team settings, these MUST be retained
             if (status->has_team_yellow() || status->has_team_blue()) {
                 modStatus = Status(new amun::Status);
@@ -346,7 +366,10 @@ qint64 LogProcessor::filterLog(SeqLogFileReader &reader, Exchanger *writer, Exch
                 insertHashInfo(modStatus, loguid, currentFrame - 1);
             }
 
-            timeRemoved += timeDelta;
+            // the time before the start of the range is kept, like when copying groups
+            if (!outOfRange) {
+                timeRemoved += timeDelta;
+            }
             dump->transfer(status);
             continue;
         }
@@ -371,6 +394,194 @@ qint64 LogProcessor::filterLog(SeqLogFileReader &reader, Exchanger *writer, Exch
     return lastWrittenTime;
 }
 
+bool LogProcessor::inTimeRange(qint64 time) const
+{
+    // without a range, statuses with slightly unordered timestamps are kept as well
+    if (m_rangeStart == 0 && m_rangeEnd == std::numeric_limits<qint64>::max()) {
+        return true;
+    }
+    return time - m_firstTime >= m_rangeStart && time - m_firstTime <= m_rangeEnd;
+}
+
+// searches the last team settings before the packet,
+// only the team fields are parsed, the remaining fields are skipped
+static void findTeamSettings(const MappedLogFileReader &reader, int packet, Status &status)
+{
+    using google::protobuf::internal::WireFormatLite;
+
+    MappedLogFileReader::Decoder decoder(reader);
+    bool foundBlue = false;
+    bool foundYellow = false;
+    for (int group = reader.groupOfPacket(packet - 1); group >= 0 && !(foundBlue && foundYellow); group--) {
+        const QByteArray groupData = decoder.decompressGroup(group);
+        const int count = std::min(reader.packetCountOfGroup(group), packet - reader.firstPacketOfGroup(group));
+        for (int i = count - 1; i >= 0 && !(foundBlue && foundYellow); i--) {
+            const QByteArray data = reader.packetData(groupData, i);
+            google::protobuf::io::CodedInputStream stream(reinterpret_cast<const google::protobuf::uint8*>(data.constData()), data.size());
+            std::string blue, yellow;
+            while (google::protobuf::uint32 tag = stream.ReadTag()) {
+                const int field = WireFormatLite::GetTagFieldNumber(tag);
+                const bool isTeam = field == amun::Status::kTeamBlueFieldNumber || field == amun::Status::kTeamYellowFieldNumber;
+                if (isTeam && WireFormatLite::GetTagWireType(tag) == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+                    google::protobuf::uint32 length;
+                    std::string &team = field == amun::Status::kTeamBlueFieldNumber ? blue : yellow;
+                    if (!stream.ReadVarint32(&length) || !stream.ReadString(&team, int(length))) {
+                        break;
+                    }
+                } else if (!WireFormatLite::SkipField(&stream, tag)) {
+                    break;
+                }
+            }
+            if (!foundBlue && !blue.empty()) {
+                foundBlue = status->mutable_team_blue()->ParseFromString(blue);
+            }
+            if (!foundYellow && !yellow.empty()) {
+                foundYellow = status->mutable_team_yellow()->ParseFromString(yellow);
+            }
+        }
+    }
+}
+
+// samples statuses evenly distributed over all input logs
+QByteArray LogProcessor::trainDictionary()
+{
+    const int DICTIONARY_SAMPLES = 2000;
+
+    if (!m_trainDictionary || m_codec != LogCodec::Zstd) {
+        return QByteArray();
+    }
+    emit progressUpdate("Training compression dictionary");
+    QList<QByteArray> samples;
+    for (const QString &logfile : m_inputFiles) {
+        MappedLogFileReader reader;
+        if (!reader.open(logfile) || reader.packetCount() == 0) {
+            continue;
+        }
+        MappedLogFileReader::Decoder decoder(reader);
+        const int sampleCount = std::min(reader.packetCount(), DICTIONARY_SAMPLES / int(m_inputFiles.size()) + 1);
+        for (int i = 0; i < sampleCount; i++) {
+            const Status status = decoder.readStatus(int(qint64(i) * reader.packetCount() / sampleCount));
+            if (!status.isNull()) {
+                samples.append(QByteArray::fromStdString(status->SerializeAsString()));
+            }
+        }
+    }
+    const QByteArray dictionary = LogCodec::trainDictionary(samples);
+    if (dictionary.isEmpty()) {
+        emit progressUpdate("Could not train a compression dictionary, compressing without dictionary");
+    }
+    return dictionary;
+}
+
+// returns false if the groups can not be copied, the logs are reencoded instead
+bool LogProcessor::copyGroups()
+{
+    if (m_options != NoOptions) {
+        emit progressUpdate("Copying groups is not possible with cut options, reencoding the logs");
+        return false;
+    }
+
+    std::vector<std::unique_ptr<MappedLogFileReader>> readers;
+    for (const QString &logfile : m_inputFiles) {
+        readers.emplace_back(new MappedLogFileReader);
+        if (!readers.back()->open(logfile) || readers.back()->packetCount() == 0) {
+            emit progressUpdate(QString("Can not copy groups of %1, reencoding the logs").arg(logfile));
+            return false;
+        }
+    }
+
+    // the hashes are calculated like for logs without a hash, but the input logs are not modified
+    for (const auto &reader : readers) {
+        MappedLogFileReader::Decoder decoder(*reader);
+        const Status first = decoder.readStatus(0);
+        logfile::Uid hash;
+        if (!first.isNull() && first->has_log_id()) {
+            hash = first->log_id();
+        } else {
+            hash.add_parts()->set_hash(LogFileHasher::hash(*reader));
+        }
+        m_hashes.append(hash);
+    }
+    logfile::Uid resultingUid = calculateUid();
+    emit progressUpdate("Resulting Hash: " + QString::fromStdString(resultingUid.DebugString()));
+
+    if (m_ignoreHashing) {
+        emit progressUpdate("Clearing Hash ");
+        resultingUid.Clear();
+    }
+
+    // groups are only copied verbatim if their compression matches the output
+    const LogCodec::Codec codec = m_hasCodec ? m_codec : readers.front()->codec();
+    const QByteArray dictionary = m_hasCodec ? trainDictionary() : readers.front()->dictionary();
+    LogGroupCopier copier;
+    if (!copier.open(m_outputFile, codec, dictionary)) {
+        emit error(QString("Failed to output logfile %1: %2").arg(m_outputFile).arg(copier.errorMsg()));
+        return true;
+    }
+
+    m_firstTime = readers.front()->timings().front();
+    m_currentLog = 1;
+    for (const auto &reader : readers) {
+        const QList<qint64> &timings = reader->timings();
+        int firstPacket = std::partition_point(timings.begin(), timings.end(), [this](qint64 time) {
+            return time - m_firstTime < m_rangeStart;
+        }) - timings.begin();
+        const int endPacket = std::partition_point(timings.begin(), timings.end(), [this](qint64 time) {
+            return time - m_firstTime <= m_rangeEnd;
+        }) - timings.begin();
+        if (firstPacket >= endPacket) {
+            m_currentLog++;
+            continue;
+        }
+
+        // the status in front of the copied packets is reencoded
+        Status status(new amun::Status);
+        status->set_time(timings[firstPacket]);
+        bool replacesPacket = false;
+        if (firstPacket > 0) {
+            // the team settings MUST be retained
+            findTeamSettings(*reader, firstPacket, status);
+        } else {
+            // the log id of the input is replaced by the one of the output
+            MappedLogFileReader::Decoder decoder(*reader);
+            const Status first = decoder.readStatus(0);
+            if (!first.isNull() && first->has_log_id()) {
+                status = first;
+                status->clear_log_id();
+                firstPacket++;
+                replacesPacket = true;
+            }
+        }
+        if (resultingUid.parts_size() > 0) {
+            status->mutable_log_id()->CopyFrom(resultingUid);
+            resultingUid.Clear();
+        }
+        // The copied statuses can not get an original_frame_number without reencoding them. As their timestamps
+        // are not changed, unlike in filterLog, the timestamp already identifies the frame in the input log.
+        if (!status->has_original_frame_number()) {
+            status->set_original_frame_number(replacesPacket ? 0 : std::max(firstPacket - 1, 0));
+        }
+
+        const bool writeStatus = replacesPacket || status->has_team_blue() || status->has_team_yellow() || status->has_log_id();
+        if ((writeStatus && !copier.writeStatus(status)) || !copier.append(*reader, firstPacket, endPacket)) {
+            emit error(QString("Failed to copy logfile %1: %2").arg(reader->fileName()).arg(copier.errorMsg()));
+            copier.close();
+            return true;
+        }
+        emit progressUpdate(QString("Copied %1 frames of logfile %2 of %3").arg(endPacket - firstPacket).arg(m_currentLog).arg(readers.size()));
+        m_currentLog++;
+    }
+
+    if (!copier.close()) {
+        emit error(QString("Failed to write logfile %1: %2").arg(m_outputFile).arg(copier.errorMsg()));
+        return true;
+    }
+    const LogGroupCopier::Statistics statistics = copier.statistics();
+    emit progressUpdate(QString("Copied %1 groups, reencoded %2 groups").arg(statistics.copiedGroups).arg(statistics.reencodedGroups));
+    emit finishedProcessing();
+    return true;
+}
+
 void LogProcessor::removeDebugOutput(Status& status)
 {
     if (m_options & CutVisualizations) {
@@ -199,6 +199,8 @@ MainWindow::MainWindow(bool tournamentMode, bool isRa, bool broadcastUiCommands,
     connect(ui->actionUseLocation, SIGNAL(toggled(bool)), this, SLOT(useLogfileLocation(bool)));
     connect(ui->actionUseLocation, SIGNAL(toggled(bool)), m_logOpener, SLOT(useLogfileLocation(bool)));
     connect(ui->actionChangeLocation, SIGNAL(triggered()), SLOT(showDirectoryDialog()));
+    connect(ui->actionRecordWorldStateLog, SIGNAL(toggled(bool)), this, SLOT(recordWorldStateLog(bool)));
+    connect(ui->actionRecordLogSummary, SIGNAL(toggled(bool)), this, SLOT(recordLogSummary(bool)));
     connect(ui->exportVision, &QAction::triggered, this, &MainWindow::exportVisionLog);
     connect(ui->getLogUid, &QAction::triggered, this, &MainWindow::requestLogUid);
     connect(ui->openLogUidString, &QAction::triggered, this, &MainWindow::requestUidInsertWindow);
@@ -304,6 +306,8 @@ MainWindow::MainWindow(bool tournamentMode, bool isRa, bool broadcastUiCommands,
     ui->actionInputDevices->setChecked(s.value("InputDevices/Enabled").toBool());
     ui->actionAutoPause->setChecked(s.value("Simulator/AutoPause", true).toBool());
     ui->actionUseLocation->setChecked(s.value("LogWriter/UseLocation", true).toBool());
+    ui->actionRecordWorldStateLog->setChecked(s.value("LogWriter/WorldStateLog", false).toBool());
+    ui->actionRecordLogSummary->setChecked(s.value("LogWriter/Summary", false).toBool());
 
     ui->actionEnableTransceiver->setChecked(ui->actionSimulator->isChecked() ? m_transceiverSimulator : m_transceiverRealWorld);
     ui->actionChargeKicker->setChecked(ui->actionSimulator->isChecked() ? m_chargeSimulator : m_chargeRealWorld);
@@ -560,6 +564,8 @@ void MainWindow::saveConfig()
     s.setValue("Referee/Internal", ui->actionInternalReferee->isChecked());
     s.setValue("InputDevices/Enabled", ui->actionInputDevices->isChecked());
     s.setValue("LogWriter/UseLocation", ui->actionUseLocation->isChecked());
+    s.setValue("LogWriter/WorldStateLog", ui->actionRecordWorldStateLog->isChecked());
+    s.setValue("LogWriter/Summary", ui->actionRecordLogSummary->isChecked());
 
     m_logOpener->saveConfig();
 }
@@ -885,6 +891,20 @@ void MainWindow::useLogfileLocation(bool enable)
     sendCommand(command);
 }
 
+void MainWindow::recordWorldStateLog(bool enable)
+{
+    Command command(new amun::Command);
+    command->mutable_record()->set_world_state_log(enable);
+    sendCommand(command);
+}
+
+void MainWindow::recordLogSummary(bool enable)
+{
+    Command command(new amun::Command);
+    command->mutable_record()->set_log_summary(enable);
+    sendCommand(command);
+}
+
 void MainWindow::exportVisionLog()
 {
     QString filename = QFileDialog::getSaveFileName(this, "Save file location", "", "Vision log files (*.log)");
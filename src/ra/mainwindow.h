@@ -110,6 +110,8 @@ private slots:
     void setSpeed(int speed);
     void udpateSpeedActionsEnabled();
     void useLogfileLocation(bool enable);
+    void recordWorldStateLog(bool enable);
+    void recordLogSummary(bool enable);
     void exportVisionLog();
     void requestLogUid();
     void searchUid(QString uid);
@@ -0,0 +1,154 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+#include <clocale>
+#include <iostream>
+
+#include "simulationgame.h"
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("Simulation-batch-CLI");
+    app.setOrganizationName("ER-Force");
+
+    std::setlocale(LC_NUMERIC, "C");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs many simulated games in parallel, without ui and faster than real time");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption scenarioOption("scenarios", "File with one game per line: name key=value ..., unset keys use the command line values", "file");
+    QCommandLineOption gamesOption({"g", "games"}, "Number of games to run if no scenario file is given, defaults to one", "games", "1");
+    QCommandLineOption seedOption("seed", "Simulator seed of the first game, following games use increasing seeds. Defaults to one", "seed", "1");
+    QCommandLineOption blueOption("blue", "Blue strategy init script", "file");
+    QCommandLineOption blueEntryPointOption("blue-entrypoint", "Blue strategy entrypoint", "entrypoint");
+    QCommandLineOption yellowOption("yellow", "Yellow strategy init script", "file");
+    QCommandLineOption yellowEntryPointOption("yellow-entrypoint", "Yellow strategy entrypoint", "entrypoint");
+    QCommandLineOption autorefOption({"a", "autoref"}, "Autoref init script, the game is force started if missing", "file");
+    QCommandLineOption simulatorConfigOption({"s", "simulator-config"}, "Which simulator config to use (field size etc.), loaded from the config directory", "file");
+    QCommandLineOption realismOption("realism", "Simulator realism configuration (short file name without the .txt)", "realism");
+    QCommandLineOption robotsOption({"n", "num-robots"}, "Number of robots to load per team. Defaults to zero", "num-robots", "0");
+    QCommandLineOption generationOption("robot-generation", "Robot generation to create the robots of", "generation");
+    QCommandLineOption fidelityOption("fidelity", "Physics fidelity of the simulator, accurate, fast or kinematic. Compare the simulated_s and wall_s "
+                                      "columns of the results to see the speedup. Defaults to accurate", "fidelity", "accurate");
+    QCommandLineOption timeOption({"t", "simulation-time"}, "Number of seconds to simulate per game. Defaults to 300", "seconds", "300");
+    QCommandLineOption outputOption({"o", "output"}, "Directory for the logs of the games and the results", "directory");
+    QCommandLineOption jobsOption({"j", "jobs"}, "Number of games to run in parallel, defaults to the number of cores", "jobs");
+    parser.addOption(scenarioOption);
+    parser.addOption(gamesOption);
+    parser.addOption(seedOption);
+    parser.addOption(blueOption);
+    parser.addOption(blueEntryPointOption);
+    parser.addOption(yellowOption);
+    parser.addOption(yellowEntryPointOption);
+    parser.addOption(autorefOption);
+    parser.addOption(simulatorConfigOption);
+    parser.addOption(realismOption);
+    parser.addOption(robotsOption);
+    parser.addOption(generationOption);
+    parser.addOption(fidelityOption);
+    parser.addOption(timeOption);
+    parser.addOption(outputOption);
+    parser.addOption(jobsOption);
+
+    // parse command line
+    parser.process(app);
+
+    SimulationScenario defaults;
+    defaults.duration = parser.value(timeOption).toInt();
+    defaults.seed = parser.value(seedOption).toUInt();
+    defaults.blueStrategy = parser.value(blueOption);
+    defaults.blueEntryPoint = parser.value(blueEntryPointOption);
+    defaults.yellowStrategy = parser.value(yellowOption);
+    defaults.yellowEntryPoint = parser.value(yellowEntryPointOption);
+    defaults.autoref = parser.value(autorefOption);
+    defaults.simulatorConfig = parser.value(simulatorConfigOption);
+    defaults.realismConfig = parser.value(realismOption);
+    defaults.robotCount = parser.value(robotsOption).toInt();
+    defaults.robotGeneration = parser.value(generationOption);
+    defaults.fidelity = parser.value(fidelityOption);
+
+    std::vector<SimulationScenario> scenarios;
+    QString error;
+    if (parser.isSet(scenarioOption)) {
+        if (!SimulationScenario::readScenarioFile(parser.value(scenarioOption), defaults, scenarios, error)) {
+            qFatal("Error: %s", qPrintable(error));
+        }
+    } else {
+        bool ok = false;
+        const int games = parser.value(gamesOption).toInt(&ok);
+        if (!ok || games <= 0) {
+            qFatal("Error: invalid number of games");
+        }
+        // the command line values are validated like a scenario
+        for (int i = 0; i < games; i++) {
+            SimulationScenario scenario;
+            if (!SimulationScenario::parse(QString("game%1 seed=%2").arg(i).arg(defaults.seed + i), defaults, scenario, error)) {
+                qFatal("Error: %s", qPrintable(error));
+            }
+            scenarios.push_back(scenario);
+        }
+    }
+    if (scenarios.empty()) {
+        qFatal("Error: no games to run");
+    }
+
+    const QString outputDirectory = parser.value(outputOption);
+    if (!outputDirectory.isEmpty() && !QDir().mkpath(outputDirectory)) {
+        qFatal("Error: could not create %s", qPrintable(outputDirectory));
+    }
+
+    int jobs = QThread::idealThreadCount();
+    if (parser.isSet(jobsOption)) {
+        bool ok = false;
+        jobs = parser.value(jobsOption).toInt(&ok);
+        if (!ok || jobs <= 0) {
+            qFatal("Error: invalid number of jobs");
+        }
+    }
+
+    const auto results = SimulationGame::runParallel(scenarios, outputDirectory, jobs);
+
+    QString csv = SimulationResult::csvHeader() + "\n";
+    bool allSuccessful = true;
+    for (const SimulationResult &result : results) {
+        csv += result.toCsv() + "\n";
+        allSuccessful = allSuccessful && result.success;
+    }
+    std::cout << csv.toStdString();
+
+    if (!outputDirectory.isEmpty()) {
+        QFile resultFile(QDir(outputDirectory).filePath("results.csv"));
+        if (!resultFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            qFatal("Error: could not write the results");
+        }
+        QTextStream(&resultFile) << csv;
+    }
+
+    return allSuccessful ? 0 : 1;
+}
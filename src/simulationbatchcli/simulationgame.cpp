@@ -0,0 +1,540 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "simulationgame.h"
+
+#include "amun/commandconverter.h"
+#include "amun/optionsmanager.h"
+#include "core/configuration.h"
+#include "gamecontroller/internalgamecontroller.h"
+#include "gamecontroller/strategygamecontrollermediator.h"
+#include "internalreferee/internalreferee.h"
+#include "processor/processor.h"
+#include "protobuf/robot.h"
+#include "seshat/logfilewriter.h"
+#include "simulator/fastsimulator.h"
+#include "simulator/simulator.h"
+#include "strategy/script/compilerregistry.h"
+#include "strategy/strategy.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QRegExp>
+#include <QSet>
+#include <QTextStream>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+
+using camun::simulator::Simulator;
+
+// the strategy time of every game starts here, thus logs of games with the same seed are comparable
+static const qint64 GAME_START_TIME = 1000 * 1000 * 1000LL;
+
+// the fidelities are named like the values of SimulatorSetup::Fidelity, but in lower case
+static bool fidelityFromName(const QString &name, amun::SimulatorSetup::Fidelity &fidelity)
+{
+    return name == name.toLower() && amun::SimulatorSetup::Fidelity_Parse(name.toUpper().toStdString(), &fidelity);
+}
+
+bool SimulationScenario::parse(const QString &line, const SimulationScenario &defaults, SimulationScenario &scenario, QString &error)
+{
+    const QStringList parts = line.split(QRegExp("\\s+"), QString::SkipEmptyParts);
+    if (parts.isEmpty() || parts[0].contains('=')) {
+        error = QString("Scenario without name: %1").arg(line);
+        return false;
+    }
+
+    SimulationScenario result = defaults;
+    result.name = parts[0];
+    for (int i = 1; i < parts.size(); i++) {
+        const int separator = parts[i].indexOf('=');
+        if (separator <= 0) {
+            error = QString("Invalid scenario entry %1 in %2").arg(parts[i], result.name);
+            return false;
+        }
+        const QString key = parts[i].left(separator);
+        const QString value = parts[i].mid(separator + 1);
+        bool ok = true;
+        if (key == "seed") {
+            result.seed = value.toUInt(&ok);
+        } else if (key == "duration") {
+            result.duration = value.toInt(&ok);
+            ok = ok && result.duration > 0;
+        } else if (key == "blue") {
+            result.blueStrategy = value;
+        } else if (key == "blue-entrypoint") {
+            result.blueEntryPoint = value;
+        } else if (key == "yellow") {
+            result.yellowStrategy = value;
+        } else if (key == "yellow-entrypoint") {
+            result.yellowEntryPoint = value;
+        } else if (key == "autoref") {
+            result.autoref = value;
+        } else if (key == "simulator-config") {
+            result.simulatorConfig = value;
+        } else if (key == "realism") {
+            result.realismConfig = value;
+        } else if (key == "robots") {
+            result.robotCount = value.toInt(&ok);
+            ok = ok && result.robotCount >= 0;
+        } else if (key == "robot-generation") {
+            result.robotGeneration = value;
+        } else if (key == "fidelity") {
+            result.fidelity = value;
+        } else {
+            error = QString("Unknown scenario key %1 in %2").arg(key, result.name);
+            return false;
+        }
+        if (!ok) {
+            error = QString("Invalid value for %1 in %2").arg(key, result.name);
+            return false;
+        }
+    }
+
+    if (result.blueStrategy.isEmpty() && result.yellowStrategy.isEmpty()) {
+        error = QString("Scenario %1 runs no strategy").arg(result.name);
+        return false;
+    }
+    if (result.robotCount > 0 && result.robotGeneration.isEmpty()) {
+        error = QString("Scenario %1 has robots but no robot generation").arg(result.name);
+        return false;
+    }
+    amun::SimulatorSetup::Fidelity fidelity;
+    if (!fidelityFromName(result.fidelity, fidelity)) {
+        error = QString("Invalid fidelity %1 in %2, expected accurate, fast or kinematic").arg(result.fidelity, result.name);
+        return false;
+    }
+    scenario = result;
+    return true;
+}
+
+bool SimulationScenario::readScenarioFile(const QString &filename, const SimulationScenario &defaults,
+                                          std::vector<SimulationScenario> &scenarios, QString &error)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        error = QString("Could not open %1").arg(filename);
+        return false;
+    }
+
+    QSet<QString> names;
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        SimulationScenario scenario;
+        if (!parse(line, defaults, scenario, error)) {
+            return false;
+        }
+        // the name is used for the log file
+        if (names.contains(scenario.name)) {
+            error = QString("Duplicate scenario name %1").arg(scenario.name);
+            return false;
+        }
+        names.insert(scenario.name);
+        scenarios.push_back(scenario);
+    }
+    return true;
+}
+
+QString SimulationResult::csvHeader()
+{
+    return "\"name\",\"seed\",\"fidelity\",\"success\",\"simulated_s\",\"wall_s\",\"goals_yellow\",\"goals_blue\","
+           "\"game_events\",\"failed_strategy\",\"log\",\"error\"";
+}
+
+QString SimulationResult::toCsv() const
+{
+    return QString("\"%1\",%2,\"%3\",%4,%5,%6,%7,%8,%9,\"%10\",\"%11\",\"%12\"")
+            .arg(name)
+            .arg(seed)
+            .arg(fidelity)
+            .arg(success ? 1 : 0)
+            .arg(simulatedTime * 1E-9)
+            .arg(wallTime * 1E-9)
+            .arg(goalsYellow)
+            .arg(goalsBlue)
+            .arg(gameEvents)
+            .arg(failedStrategy)
+            .arg(logFile)
+            .arg(errorMsg);
+}
+
+SimulationGame::SimulationGame(const SimulationScenario &scenario, CompilerRegistry *compilerRegistry) :
+    m_scenario(scenario),
+    m_compilerRegistry(compilerRegistry)
+{ }
+
+SimulationGame::~SimulationGame() = default;
+
+bool SimulationGame::setup(QString &error)
+{
+    amun::SimulatorSetup simulatorSetup;
+    simulatorSetupSetDefault(simulatorSetup);
+    if (!m_scenario.simulatorConfig.isEmpty()
+            && !loadConfiguration("simulator/" + m_scenario.simulatorConfig, &simulatorSetup, false)) {
+        error = QString("Could not load simulator config %1").arg(m_scenario.simulatorConfig);
+        return false;
+    }
+    // the scenario has been validated when it was parsed
+    amun::SimulatorSetup::Fidelity fidelity = amun::SimulatorSetup::ACCURATE;
+    fidelityFromName(m_scenario.fidelity, fidelity);
+    simulatorSetup.set_fidelity(fidelity);
+
+    m_timer.setTime(GAME_START_TIME, 0);
+
+    m_simulator.reset(new Simulator(&m_timer, simulatorSetup, true));
+    // games with the same seed and scenario must produce the same simulation
+    m_simulator->setDeterministic(m_scenario.seed);
+    // runs without its own trigger, process is called once per tick
+    m_processor.reset(new Processor(&m_timer, true));
+    m_commandConverter.reset(new CommandConverter(&m_timer));
+    m_optionsManager.reset(new OptionsManager);
+    m_referee.reset(new InternalReferee);
+
+    const QString scripts[3] = { m_scenario.blueStrategy, m_scenario.yellowStrategy, m_scenario.autoref };
+    const StrategyType types[3] = { StrategyType::BLUE, StrategyType::YELLOW, StrategyType::AUTOREF };
+    for (int i = 0; i < 3; i++) {
+        if (scripts[i].isEmpty()) {
+            continue;
+        }
+        m_gameControllerConnection[i].reset(new StrategyGameControllerMediator(m_processor->getInternalGameController(), i == 2));
+        m_strategy[i].reset(new Strategy(&m_timer, types[i], nullptr, m_compilerRegistry, m_gameControllerConnection[i], i == 2));
+    }
+
+    connectStack();
+    return loadTeams(error);
+}
+
+// mirrors the connections of Amun, the objects all live on the calling thread, thus every call is direct
+void SimulationGame::connectStack()
+{
+    Simulator *simulator = m_simulator.get();
+    Processor *processor = m_processor.get();
+    CommandConverter *converter = m_commandConverter.get();
+
+    QObject::connect(simulator, &Simulator::gotPacket, processor, &Processor::handleVisionPacket);
+    QObject::connect(simulator, &Simulator::sendRealData, processor, &Processor::handleSimulatorExtraVision);
+    QObject::connect(simulator, &Simulator::sendRadioResponses, processor, &Processor::handleRadioResponses);
+    QObject::connect(simulator, &Simulator::sendSSLSimError, converter, &CommandConverter::handleSimulatorErrors);
+    QObject::connect(simulator, &Simulator::sendStatus, [this](const Status &status) { handleStatus(status); });
+
+    QObject::connect(processor, &Processor::sendRadioCommands, converter, &CommandConverter::handleRadioCommands);
+    QObject::connect(converter, &CommandConverter::sendSSLSim, simulator, &Simulator::handleRadioCommands);
+    QObject::connect(converter, &CommandConverter::sendStatus, [this](const Status &status) { handleStatus(status); });
+    QObject::connect(processor, &Processor::sendStatus, [this](const Status &status) { handleStatus(status); });
+    QObject::connect(processor, &Processor::setFlipped, simulator, &Simulator::setFlipped);
+
+    QObject::connect(m_optionsManager.get(), &OptionsManager::sendStatus, [this](const Status &status) { handleStatus(status); });
+    QObject::connect(m_referee.get(), &InternalReferee::sendCommand, [this](const Command &command) { handleCommand(command); });
+
+    for (auto &strategy : m_strategy) {
+        if (!strategy) {
+            continue;
+        }
+        QObject::connect(processor, &Processor::sendStrategyStatus, strategy.get(), &Strategy::handleStatus);
+        QObject::connect(m_optionsManager.get(), &OptionsManager::sendStatus, strategy.get(), &Strategy::handleStatus);
+        QObject::connect(processor, &Processor::setFlipped, strategy.get(), &Strategy::setFlipped);
+        QObject::connect(strategy.get(), &Strategy::sendStrategyCommands, processor, &Processor::handleStrategyCommands);
+        QObject::connect(strategy.get(), &Strategy::sendHalt, processor, &Processor::handleStrategyHalt);
+        QObject::connect(strategy.get(), &Strategy::gotCommand, [this](const Command &command) { handleCommand(command); });
+        QObject::connect(strategy.get(), &Strategy::sendStatus, [this](const Status &status) { m_pendingStatuses.push_back(status); });
+    }
+}
+
+bool SimulationGame::loadTeams(QString &error)
+{
+    if (m_scenario.robotCount == 0) {
+        return true;
+    }
+    robot::Generation generation;
+    if (!loadConfiguration("robots/" + m_scenario.robotGeneration, &generation, true)) {
+        error = QString("Could not load robot generation %1").arg(m_scenario.robotGeneration);
+        return false;
+    }
+
+    // same robot ids as in amun-cli
+    Command command(new amun::Command);
+    robot::Team *yellow = command->mutable_set_team_yellow();
+    robot::Team *blue = command->mutable_set_team_blue();
+    for (int i = 0; i < m_scenario.robotCount; i++) {
+        robot::Specs *yellowRobot = yellow->add_robot();
+        yellowRobot->CopyFrom(generation.default_());
+        yellowRobot->set_id(i);
+        robot::Specs *blueRobot = blue->add_robot();
+        blueRobot->CopyFrom(generation.default_());
+        blueRobot->set_id(i > 15 ? i : (15 - i));
+    }
+    handleCommand(command);
+
+    if (!m_scenario.realismConfig.isEmpty()) {
+        Command realism(new amun::Command);
+        if (!loadConfiguration("simulator-realism/" + m_scenario.realismConfig, realism->mutable_simulator()->mutable_realism_config(), true)) {
+            error = QString("Could not load realism config %1").arg(m_scenario.realismConfig);
+            return false;
+        }
+        handleCommand(realism);
+    }
+    return true;
+}
+
+static void addStrategyLoad(amun::CommandStrategy *strategy, const QString &initScript, const QString &entryPoint)
+{
+    strategy->set_enable_debug(true);
+    auto *load = strategy->mutable_load();
+    load->set_filename(QDir::current().absoluteFilePath(initScript).toStdString());
+    if (!entryPoint.isEmpty()) {
+        load->set_entry_point(entryPoint.toStdString());
+    }
+}
+
+void SimulationGame::startGame()
+{
+    Command command(new amun::Command);
+    command->mutable_simulator()->set_enable(true);
+    command->mutable_referee()->set_active(true);
+    command->mutable_transceiver()->set_enable(true);
+    command->mutable_transceiver()->set_charge(true);
+    if (m_strategy[0]) {
+        addStrategyLoad(command->mutable_strategy_blue(), m_scenario.blueStrategy, m_scenario.blueEntryPoint);
+    }
+    if (m_strategy[1]) {
+        addStrategyLoad(command->mutable_strategy_yellow(), m_scenario.yellowStrategy, m_scenario.yellowEntryPoint);
+    }
+    if (m_strategy[2]) {
+        addStrategyLoad(command->mutable_strategy_autoref(), m_scenario.autoref, {});
+    }
+    handleCommand(command);
+
+    // the autoref runs the game, otherwise it is started immediately
+    if (m_strategy[2]) {
+        m_referee->changeStage(SSL_Referee::NORMAL_FIRST_HALF);
+        m_referee->changeBlueKeeper(m_scenario.robotCount);
+        m_referee->changeYellowKeeper(0);
+        m_referee->enableInternalAutoref(true);
+        m_referee->changeCommand(m_strategy[0] ? SSL_Referee::PREPARE_KICKOFF_BLUE : SSL_Referee::PREPARE_KICKOFF_YELLOW);
+    } else {
+        m_referee->changeCommand(SSL_Referee::FORCE_START);
+    }
+}
+
+void SimulationGame::handleCommand(const Command &command)
+{
+    m_pendingCommands.push_back(command);
+}
+
+void SimulationGame::dispatchCommand(const Command &command)
+{
+    InternalGameController *gameController = m_processor->getInternalGameController();
+    if (command->has_referee()) {
+        const amun::CommandReferee referee = command->referee();
+        if (referee.has_use_internal_autoref() && m_strategy[2]) {
+            m_autorefEnabled = referee.use_internal_autoref();
+            m_strategy[2]->blockSignals(!m_autorefEnabled);
+            m_strategy[2]->setEnabled(m_autorefEnabled);
+        }
+        // the game controller lives in its own thread
+        const bool useGameController = m_autorefEnabled;
+        QMetaObject::invokeMethod(gameController, [gameController, referee, useGameController]() {
+            gameController->setEnabled(useGameController);
+            gameController->handleCommand(referee);
+        });
+    }
+
+    m_simulator->handleCommand(command);
+    m_processor->handleCommand(command);
+    m_commandConverter->handleCommand(command);
+    m_optionsManager->handleCommand(command);
+    for (auto &strategy : m_strategy) {
+        if (strategy) {
+            strategy->handleCommand(command);
+        }
+    }
+}
+
+void SimulationGame::handleStatus(const Status &status)
+{
+    status->set_time(m_timer.currentTime());
+    // the processor and the strategies measure their run time with the wall clock,
+    // which would make the logs of games with the same seed differ
+    status->clear_timing();
+
+    if (status->has_game_state()) {
+        const amun::GameState &gameState = status->game_state();
+        m_result.goalsYellow = gameState.yellow().score();
+        m_result.goalsBlue = gameState.blue().score();
+        if (gameState.game_event_2019_size() > 0) {
+            const std::string event = gameState.game_event_2019(gameState.game_event_2019_size() - 1).SerializeAsString();
+            if (event != m_lastGameEvent) {
+                m_lastGameEvent = event;
+                m_result.gameEvents++;
+            }
+        }
+    }
+
+    if (status->has_status_strategy() && status->status_strategy().status().state() == amun::StatusStrategy::FAILED
+            && m_result.failedStrategy.isEmpty()) {
+        switch (status->status_strategy().type()) {
+        case amun::StatusStrategyWrapper::BLUE:
+            m_result.failedStrategy = "blue";
+            break;
+        case amun::StatusStrategyWrapper::YELLOW:
+            m_result.failedStrategy = "yellow";
+            break;
+        default:
+            m_result.failedStrategy = "autoref";
+            break;
+        }
+    }
+
+    if (m_logFile) {
+        m_logFile->writeStatus(status);
+    }
+}
+
+void SimulationGame::flushPending()
+{
+    // The game controller thread handles the statuses of the processor asynchronously. Waiting until it has handled
+    // all of them delivers its answers in the same tick in every run, which keeps the games deterministic
+    InternalGameController *gameController = m_processor->getInternalGameController();
+    QMetaObject::invokeMethod(gameController, []() {}, Qt::BlockingQueuedConnection);
+    // there is no event loop, deliver the signals of the game controller thread here
+    QCoreApplication::sendPostedEvents();
+
+    while (!m_pendingCommands.empty() || !m_pendingStatuses.empty()) {
+        const std::vector<Command> commands = std::move(m_pendingCommands);
+        m_pendingCommands.clear();
+        for (const Command &command : commands) {
+            dispatchCommand(command);
+        }
+
+        const std::vector<Status> statuses = std::move(m_pendingStatuses);
+        m_pendingStatuses.clear();
+        for (const Status &status : statuses) {
+            m_optionsManager->handleStatus(status);
+            handleStatus(status);
+        }
+    }
+}
+
+bool SimulationGame::processTick()
+{
+    flushPending();
+    m_processor->process();
+    for (int i = 0; i < 3; i++) {
+        if (m_strategy[i] && (i != 2 || m_autorefEnabled)) {
+            m_strategy[i]->tryProcess();
+        }
+    }
+    flushPending();
+    return m_result.failedStrategy.isEmpty();
+}
+
+SimulationResult SimulationGame::run(const QString &logFile)
+{
+    const qint64 wallStart = Timer::systemTime();
+    m_result = SimulationResult();
+    m_result.name = m_scenario.name;
+    m_result.seed = m_scenario.seed;
+    m_result.fidelity = m_scenario.fidelity;
+
+    QString error;
+    if (!setup(error)) {
+        m_result.errorMsg = error;
+        return m_result;
+    }
+    if (!logFile.isEmpty()) {
+        m_logFile.reset(new LogFileWriter);
+        if (!m_logFile->open(logFile)) {
+            m_result.errorMsg = QString("Could not open log file %1").arg(logFile);
+            return m_result;
+        }
+        m_result.logFile = logFile;
+    }
+
+    startGame();
+    const qint64 startTime = m_timer.currentTime();
+    FastSimulator::goWhile(m_simulator.get(), &m_timer, startTime + m_scenario.duration * 1000 * 1000 * 1000LL,
+                           [this]() { return processTick(); });
+    m_result.simulatedTime = m_timer.currentTime() - startTime;
+
+    if (m_logFile) {
+        m_logFile->close();
+    }
+    m_result.wallTime = Timer::systemTime() - wallStart;
+    m_result.success = true;
+    return m_result;
+}
+
+void SimulationGame::prepareStrategies(const std::vector<SimulationScenario> &scenarios, CompilerRegistry *compilerRegistry)
+{
+    QSet<QString> scripts;
+    for (const SimulationScenario &scenario : scenarios) {
+        for (const QString &script : { scenario.blueStrategy, scenario.yellowStrategy, scenario.autoref }) {
+            if (!script.isEmpty()) {
+                scripts.insert(QDir::current().absoluteFilePath(script));
+            }
+        }
+    }
+
+    Timer timer;
+    timer.setTime(0, 1.0);
+    auto connection = std::make_shared<StrategyGameControllerMediator>(false);
+    for (const QString &script : scripts) {
+        Strategy strategy(&timer, StrategyType::YELLOW, nullptr, compilerRegistry, connection);
+        strategy.compileIfNecessary(script);
+        // process all outstanding events of the compiler before the games are started
+        QCoreApplication::processEvents();
+    }
+}
+
+std::vector<SimulationResult> SimulationGame::runParallel(const std::vector<SimulationScenario> &scenarios,
+                                                          const QString &outputDirectory, int threadCount)
+{
+    CompilerRegistry compilerRegistry;
+    prepareStrategies(scenarios, &compilerRegistry);
+
+    std::vector<SimulationResult> results(scenarios.size());
+    std::atomic<std::size_t> nextGame(0);
+
+    auto worker = [&]() {
+        for (std::size_t i = nextGame++; i < scenarios.size(); i = nextGame++) {
+            const QString logFile = outputDirectory.isEmpty() ? QString() : QDir(outputDirectory).filePath(scenarios[i].name + ".log");
+            SimulationGame game(scenarios[i], &compilerRegistry);
+            results[i] = game.run(logFile);
+        }
+    };
+
+    // QThreads are used as the strategies start timers, which requires an event dispatcher even if it never runs
+    threadCount = std::max(1, std::min(threadCount, int(scenarios.size())));
+    std::vector<std::unique_ptr<QThread>> threads;
+    threads.reserve(threadCount);
+    for (int i = 0; i < threadCount; i++) {
+        threads.emplace_back(QThread::create(worker));
+        threads.back()->start();
+    }
+    for (auto &thread : threads) {
+        thread->wait();
+    }
+    return results;
+}
@@ -0,0 +1,159 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef SIMULATIONGAME_H
+#define SIMULATIONGAME_H
+
+#include "core/timer.h"
+#include "protobuf/command.h"
+#include "protobuf/status.h"
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <vector>
+
+class CommandConverter;
+class CompilerRegistry;
+class InternalReferee;
+class LogFileWriter;
+class OptionsManager;
+class Processor;
+class Strategy;
+class StrategyGameControllerMediator;
+namespace camun {
+    namespace simulator {
+        class Simulator;
+    }
+}
+
+struct SimulationScenario
+{
+    QString name;
+    quint32 seed = 0;
+    // simulated time in seconds
+    int duration = 300;
+
+    // strategies which are not set are not run
+    QString blueStrategy;
+    QString blueEntryPoint;
+    QString yellowStrategy;
+    QString yellowEntryPoint;
+    QString autoref;
+
+    // short names of the configurations, the defaults are used if empty
+    QString simulatorConfig;
+    QString realismConfig;
+    int robotCount = 0;
+    QString robotGeneration;
+    // physics fidelity of the simulator, either accurate, fast or kinematic
+    QString fidelity = "accurate";
+
+    // parses a line of the form "name key=value ...", unset keys keep the value of defaults
+    static bool parse(const QString &line, const SimulationScenario &defaults, SimulationScenario &scenario, QString &error);
+    // empty lines and lines starting with # are ignored
+    static bool readScenarioFile(const QString &filename, const SimulationScenario &defaults,
+                                 std::vector<SimulationScenario> &scenarios, QString &error);
+};
+
+struct SimulationResult
+{
+    QString name;
+    quint32 seed = 0;
+    QString fidelity;
+    bool success = false;
+    QString errorMsg;
+    QString logFile;
+
+    // both in nanoseconds
+    qint64 simulatedTime = 0;
+    qint64 wallTime = 0;
+
+    int goalsYellow = 0;
+    int goalsBlue = 0;
+    int gameEvents = 0;
+    // the game ends as soon as one of the strategies fails
+    QString failedStrategy;
+
+    static QString csvHeader();
+    QString toCsv() const;
+};
+
+// One isolated simulator, processor and strategy stack.
+// Unlike a full Amun, no event loop is used: the simulator is stepped manually and
+// the processor and strategies are run every 10 ms of simulated time, all on the calling thread.
+// Every instance owns its Timer and seeds its simulator, thus multiple games can run in parallel
+// by using one instance per thread. Games with the same scenario write identical logs,
+// the wall clock timings are not logged.
+class SimulationGame
+{
+public:
+    // the compiler registry may be shared between games
+    SimulationGame(const SimulationScenario &scenario, CompilerRegistry *compilerRegistry);
+    ~SimulationGame();
+    SimulationGame(const SimulationGame&) = delete;
+    SimulationGame& operator=(const SimulationGame&) = delete;
+
+    // the log is only written if logFile is not empty
+    SimulationResult run(const QString &logFile);
+
+    // compiles the strategies once before the games are started, this also initializes v8 on the calling thread
+    static void prepareStrategies(const std::vector<SimulationScenario> &scenarios, CompilerRegistry *compilerRegistry);
+    // runs all games with the given number of threads, the result order matches the input order.
+    // The logs are written to outputDirectory if it is not empty
+    static std::vector<SimulationResult> runParallel(const std::vector<SimulationScenario> &scenarios,
+                                                     const QString &outputDirectory, int threadCount);
+
+private:
+    bool setup(QString &error);
+    void connectStack();
+    bool loadTeams(QString &error);
+    void startGame();
+    void handleCommand(const Command &command);
+    void handleStatus(const Status &status);
+    void dispatchCommand(const Command &command);
+    void flushPending();
+    bool processTick();
+
+private:
+    const SimulationScenario m_scenario;
+    Timer m_timer;
+    CompilerRegistry *m_compilerRegistry;
+    std::unique_ptr<camun::simulator::Simulator> m_simulator;
+    std::unique_ptr<Processor> m_processor;
+    std::unique_ptr<CommandConverter> m_commandConverter;
+    std::unique_ptr<OptionsManager> m_optionsManager;
+    std::unique_ptr<InternalReferee> m_referee;
+    // the strategies are destroyed before the processor, which owns the game controller
+    std::shared_ptr<StrategyGameControllerMediator> m_gameControllerConnection[3];
+    // blue, yellow and autoref, only created if the scenario runs them
+    std::unique_ptr<Strategy> m_strategy[3];
+    std::unique_ptr<LogFileWriter> m_logFile;
+
+    // commands and strategy statuses are only handled between the processing steps,
+    // handling them immediately could reload a strategy while it is running
+    std::vector<Command> m_pendingCommands;
+    std::vector<Status> m_pendingStatuses;
+
+    bool m_autorefEnabled = false;
+    SimulationResult m_result;
+    std::string m_lastGameEvent;
+};
+
+#endif // SIMULATIONGAME_H
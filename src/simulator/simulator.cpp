@@ -24,9 +24,12 @@
 #include <QNetworkDatagram>
 #include <QCommandLineParser>
 #include <QTime>
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <cstdarg>
+#include <memory>
+#include <vector>
 
 #include "protobuf/ssl_simulation_robot_control.pb.h"
 #include "protobuf/ssl_simulation_robot_feedback.pb.h"
@@ -45,6 +48,7 @@
 #include "core/sslprotocols.h"
 
 #include "ssl_robocup_server.h"
+#include "simulatorports.h"
 
 /**
  * Stand alone Erforce simulator
@@ -95,7 +99,7 @@ private:
 class SimulatorCommandAdaptor: public QObject {
     Q_OBJECT
 public:
-    SimulatorCommandAdaptor(Timer* timer, SSLVisionServer *vision);
+    SimulatorCommandAdaptor(Timer* timer, SSLVisionServer *vision, quint16 port);
 private slots:
     void handleDatagrams();
 
@@ -113,21 +117,23 @@ private:
     SSLVisionServer* m_visionServer; // unowned
 };
 
-SimulatorCommandAdaptor::SimulatorCommandAdaptor(Timer* timer, SSLVisionServer* vision):
+SimulatorCommandAdaptor::SimulatorCommandAdaptor(Timer* timer, SSLVisionServer* vision, quint16 port):
     m_server(this),
     m_senderAddress(QHostAddress::Null),
     m_senderPort(-1),
     m_timer(timer),
     m_visionServer(vision)
 {
-    m_server.bind(QHostAddress::Any, SSL_SIMULATION_CONTROL_PORT);
+    if (!m_server.bind(QHostAddress::Any, port)) {
+        log(stderr, "Could not bind simulator control port %d\n", port);
+    }
     connect(&m_server, &QUdpSocket::readyRead, this, &SimulatorCommandAdaptor::handleDatagrams);
 }
 
 class RobotCommandAdaptor: public QObject{
     Q_OBJECT
 public:
-    RobotCommandAdaptor(bool blue, Timer* timer);
+    RobotCommandAdaptor(bool blue, Timer* timer, quint16 port);
 
 private:
     void sendRobotRespose(const sslsim::RobotControlResponse& rcr);
@@ -151,13 +157,15 @@ private:
     Timer* m_timer; // unowned
 };
 
-RobotCommandAdaptor::RobotCommandAdaptor(bool blue, Timer* timer): m_is_blue(blue),
+RobotCommandAdaptor::RobotCommandAdaptor(bool blue, Timer* timer, quint16 port): m_is_blue(blue),
     m_server(this),
     m_senderAddress(QHostAddress::Null),
     m_senderPort(-1),
     m_timer(timer)
 {
-    m_server.bind(QHostAddress::Any, (blue)? SSL_SIMULATION_CONTROL_BLUE_PORT : SSL_SIMULATION_CONTROL_YELLOW_PORT);
+    if (!m_server.bind(QHostAddress::Any, port)) {
+        log(stderr, "Could not bind %s team control port %d\n", blue ? "blue" : "yellow", port);
+    }
     connect(&m_server, &QUdpSocket::readyRead, this, &RobotCommandAdaptor::handleDatagrams);
 }
 
@@ -583,6 +591,7 @@ void SSLVisionServer::setPort(int port) {
 
 using camun::simulator::Simulator;
 using camun::simulator::ErrorSource;
+using camun::simulator::RadioCommandRing;
 
 class SimProxy: public QObject {
     Q_OBJECT
@@ -593,13 +602,16 @@ signals:
     void sendRadioResponses(const QList<robot::RadioResponse> &responses); // out
     void gotPacket(const QByteArray &data, qint64 time, QString sender); // out
     void gotCommand(const Command &command); // internal
-    void handleRadioCommands(const SSLSimRobotControl& control, bool isBlue, qint64 processingStart); // in
 public slots:
     void handleCommand(const Command &command);
+    // called directly from the receive thread
+    void handleRadioCommands(const SSLSimRobotControl& control, bool isBlue, qint64 processingStart);
 
 private:
     Timer* m_timer;
     Simulator* m_sim = nullptr;
+    // owned by the proxy, a simulator which is replaced may still be deleted while a command arrives
+    std::shared_ptr<RadioCommandRing> m_radioCommands = std::make_shared<RadioCommandRing>();
     Command m_teamCommand{new amun::Command};
 };
 
@@ -631,10 +643,10 @@ void SimProxy::handleCommand(const Command &command) {
             m_sim->blockSignals(true);
             m_sim->deleteLater();
         }
-        m_sim = new Simulator(m_timer, command->simulator().simulator_setup());
+        // the new simulator continues with the commands which are still in the ring
+        m_sim = new Simulator(m_timer, command->simulator().simulator_setup(), false, m_radioCommands);
         connect(this, &SimProxy::gotCommand, m_sim, &Simulator::handleCommand);
         connect(m_sim, &Simulator::gotPacket, this, &SimProxy::gotPacket);
-        connect(this, &SimProxy::handleRadioCommands, m_sim, &Simulator::handleRadioCommands);
         connect(m_sim, &Simulator::sendSSLSimError, this, &SimProxy::sendSSLSimError);
         connect(m_sim, &Simulator::sendRadioResponses, this, &SimProxy::sendRadioResponses);
         auto* simCommand = m_teamCommand->mutable_simulator();
@@ -646,6 +658,45 @@ void SimProxy::handleCommand(const Command &command) {
     emit gotCommand(command);
 }
 
+void SimProxy::handleRadioCommands(const SSLSimRobotControl& control, bool isBlue, qint64 processingStart)
+{
+    // a full ring is reported to the team by the simulator
+    m_radioCommands->push(control, isBlue, processingStart);
+}
+
+// One independent simulation with its own ports, see simulatorPorts.
+// Instances only share threads, but no state
+struct SimulatorInstance {
+    SimulatorInstance(const SimulatorPorts &ports, const string &visionAddress);
+
+    Timer timer;
+    RobotCommandAdaptor blue;
+    RobotCommandAdaptor yellow;
+    SimProxy sim;
+    SSLVisionServer vision;
+    SimulatorCommandAdaptor commands;
+};
+
+SimulatorInstance::SimulatorInstance(const SimulatorPorts &ports, const string &visionAddress):
+    blue(true, &timer, ports.blue),
+    yellow(false, &timer, ports.yellow),
+    sim(&timer),
+    vision(ports.vision, visionAddress),
+    commands(&timer, &vision, ports.control)
+{
+    QObject::connect(&blue, &RobotCommandAdaptor::sendRadioCommands, &sim, &SimProxy::handleRadioCommands, Qt::DirectConnection);
+    QObject::connect(&sim, &SimProxy::sendRadioResponses, &blue, &RobotCommandAdaptor::handleRobotResponse);
+    QObject::connect(&yellow, &RobotCommandAdaptor::sendRadioCommands, &sim, &SimProxy::handleRadioCommands, Qt::DirectConnection);
+    QObject::connect(&sim, &SimProxy::sendRadioResponses, &yellow, &RobotCommandAdaptor::handleRobotResponse);
+
+    QObject::connect(&sim, &SimProxy::gotPacket, &vision, &SSLVisionServer::sendVisionData);
+    QObject::connect(&commands, &SimulatorCommandAdaptor::sendCommand, &sim, &SimProxy::handleCommand);
+
+    QObject::connect(&sim, &SimProxy::sendSSLSimError, &commands, &SimulatorCommandAdaptor::handleSimulatorError);
+    QObject::connect(&sim, &SimProxy::sendSSLSimError, &blue, &RobotCommandAdaptor::handleSimulatorError);
+    QObject::connect(&sim, &SimProxy::sendSSLSimError, &yellow, &RobotCommandAdaptor::handleSimulatorError);
+}
+
 #include "simulator.moc"
 
 
@@ -673,12 +724,44 @@ int main(int argc, char* argv[])
     QCommandLineOption geometryConfig({"g", "geometry"}, "The geometry file to load as default", "file", "2020");
     QCommandLineOption realismConfig("realism", "Simulator realism configuration (short file name without the .txt)", "realism", "Realistic");
     QCommandLineOption localhostConfig("localhost", "Use localhost as the output address for the simulator");
+    QCommandLineOption instancesOption("instances", "Number of independent simulations to run", "count", "1");
+    QCommandLineOption portStrideOption("port-stride", "Port offset between consecutive simulations", "offset", "10");
+    QCommandLineOption threadsOption("threads", "Number of threads shared by all simulations, defaults to the number of cores", "count");
     parser.addOption(geometryConfig);
     parser.addOption(realismConfig);
     parser.addOption(localhostConfig);
+    parser.addOption(instancesOption);
+    parser.addOption(portStrideOption);
+    parser.addOption(threadsOption);
 
     parser.process(app);
 
+    bool ok = false;
+    const int instanceCount = parser.value(instancesOption).toInt(&ok);
+    if (!ok || instanceCount < 1) {
+        log(stderr, "Invalid number of instances: %s\n", qPrintable(parser.value(instancesOption)));
+        exit(EXIT_FAILURE);
+    }
+    const int portStride = parser.value(portStrideOption).toInt(&ok);
+    if (!ok) {
+        log(stderr, "Invalid port stride: %s\n", qPrintable(parser.value(portStrideOption)));
+        exit(EXIT_FAILURE);
+    }
+    const QString portError = checkSimulatorPorts(instanceCount, portStride);
+    if (!portError.isEmpty()) {
+        log(stderr, "Invalid port stride %d: %s\n", portStride, qPrintable(portError));
+        exit(EXIT_FAILURE);
+    }
+    int threadCount = QThread::idealThreadCount();
+    if (parser.isSet(threadsOption)) {
+        threadCount = parser.value(threadsOption).toInt(&ok);
+        if (!ok || threadCount < 1) {
+            log(stderr, "Invalid number of threads: %s\n", qPrintable(parser.value(threadsOption)));
+            exit(EXIT_FAILURE);
+        }
+    }
+    threadCount = std::max(1, std::min(threadCount, instanceCount));
+
     auto* desc = sslsim::RobotSpecs::descriptor();
     int real_fields = desc->field_count();
     auto* desc2 = sslsim::RobotSpecErForce::descriptor();
@@ -696,26 +779,6 @@ int main(int argc, char* argv[])
         log(stdout, "%s)", msg.c_str());
     }
 
-    Timer timer;
-    RobotCommandAdaptor blue{true, &timer}, yellow{false, &timer};
-    SimProxy sim{&timer};
-    SSLVisionServer vision{SSL_SIMULATED_VISION_PORT, parser.isSet(localhostConfig) ? SSL_VISION_ADDRESS_LOCALHOST : SSL_VISION_ADDRESS};
-    SimulatorCommandAdaptor commands{&timer, &vision};
-
-    blue.connect(&blue, &RobotCommandAdaptor::sendRadioCommands, &sim, &SimProxy::handleRadioCommands);
-    blue.connect(&sim, &SimProxy::sendRadioResponses, &blue, &RobotCommandAdaptor::handleRobotResponse);
-    yellow.connect(&yellow, &RobotCommandAdaptor::sendRadioCommands, &sim, &SimProxy::handleRadioCommands);
-    yellow.connect(&sim, &SimProxy::sendRadioResponses, &yellow, &RobotCommandAdaptor::handleRobotResponse);
-
-
-    vision.connect(&sim, &SimProxy::gotPacket, &vision, &SSLVisionServer::sendVisionData);
-    commands.connect(&commands, &SimulatorCommandAdaptor::sendCommand, &sim, &SimProxy::handleCommand);
-
-
-    commands.connect(&sim, &SimProxy::sendSSLSimError, &commands, &SimulatorCommandAdaptor::handleSimulatorError);
-    blue.connect(&sim, &SimProxy::sendSSLSimError, &blue, &RobotCommandAdaptor::handleSimulatorError);
-    yellow.connect(&sim, &SimProxy::sendSSLSimError, &yellow, &RobotCommandAdaptor::handleSimulatorError);
-
     Command c{new amun::Command};
 
     // start with default robots, take ER-Force specs.
@@ -739,17 +802,53 @@ int main(int argc, char* argv[])
         exit(EXIT_FAILURE);
     }
 
-    emit commands.sendCommand(c);
+    const string visionAddress = parser.isSet(localhostConfig) ? SSL_VISION_ADDRESS_LOCALHOST : SSL_VISION_ADDRESS;
 
+    // all network sockets share one receive thread, the simulations are distributed over the worker threads
     QThread rcv_thread;
+    std::vector<std::unique_ptr<QThread>> workerThreads;
+    for (int i = 0; i < threadCount; i++) {
+        workerThreads.emplace_back(new QThread);
+    }
+
+    std::vector<std::unique_ptr<SimulatorInstance>> instances;
+    for (int i = 0; i < instanceCount; i++) {
+        const SimulatorPorts ports = simulatorPorts(i, portStride);
+        instances.emplace_back(new SimulatorInstance(ports, visionAddress));
+        SimulatorInstance &instance = *instances.back();
+
+        instance.blue.moveToThread(&rcv_thread);
+        instance.yellow.moveToThread(&rcv_thread);
+        instance.vision.moveToThread(&rcv_thread);
+        instance.commands.moveToThread(&rcv_thread);
+        instance.sim.moveToThread(workerThreads[i % threadCount].get());
+
+        if (instanceCount > 1) {
+            log(stdout, "Simulation %d: control port %d, blue port %d, yellow port %d, vision port %d\n", i,
+                ports.control, ports.blue, ports.yellow, ports.vision);
+        }
+    }
 
-    blue.moveToThread(&rcv_thread);
-    yellow.moveToThread(&rcv_thread);
-    vision.moveToThread(&rcv_thread);
-    commands.moveToThread(&rcv_thread);
+    rcv_thread.start();
+    for (auto &thread : workerThreads) {
+        thread->start();
+    }
 
+    // the proxies modify the command, every simulation needs its own copy.
+    // The command is queued, thus the simulator is created in its worker thread
+    for (auto &instance : instances) {
+        Command instanceCommand{new amun::Command};
+        instanceCommand->CopyFrom(*c);
+        emit instance->commands.sendCommand(instanceCommand);
+    }
 
-    rcv_thread.start();
+    const int result = app.exec();
 
-    return app.exec();
+    rcv_thread.quit();
+    rcv_thread.wait();
+    for (auto &thread : workerThreads) {
+        thread->quit();
+        thread->wait();
+    }
+    return result;
 }
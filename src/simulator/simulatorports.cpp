@@ -0,0 +1,65 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "simulatorports.h"
+#include "core/sslprotocols.h"
+#include <map>
+#include <utility>
+
+SimulatorPorts simulatorPorts(int instance, int portStride)
+{
+    const int offset = instance * portStride;
+    return SimulatorPorts {
+        SSL_SIMULATION_CONTROL_PORT + offset,
+        SSL_SIMULATION_CONTROL_BLUE_PORT + offset,
+        SSL_SIMULATION_CONTROL_YELLOW_PORT + offset,
+        SSL_SIMULATED_VISION_PORT + offset
+    };
+}
+
+QString checkSimulatorPorts(int instanceCount, int portStride)
+{
+    // the vision ports are shifted by the same stride as the control ports,
+    // for large strides or instance counts they can reach the control ports of another simulation
+    std::map<int, std::pair<int, QString>> usedPorts;
+    for (int i = 0; i < instanceCount; i++) {
+        const SimulatorPorts ports = simulatorPorts(i, portStride);
+        const std::pair<int, QString> assignments[] = {
+            {ports.control, "control"},
+            {ports.blue, "blue team control"},
+            {ports.yellow, "yellow team control"},
+            {ports.vision, "vision"}
+        };
+        for (const auto &assignment : assignments) {
+            const int port = assignment.first;
+            if (port < 1 || port > 65535) {
+                return QString("The %1 port %2 of simulation %3 is not a valid port")
+                        .arg(assignment.second).arg(port).arg(i);
+            }
+            const auto it = usedPorts.find(port);
+            if (it != usedPorts.end()) {
+                return QString("The %1 port %2 of simulation %3 is already the %4 port of simulation %5")
+                        .arg(assignment.second).arg(port).arg(i).arg(it->second.second).arg(it->second.first);
+            }
+            usedPorts[port] = {i, assignment.second};
+        }
+    }
+    return QString();
+}
@@ -0,0 +1,41 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef SIMULATORPORTS_H
+#define SIMULATORPORTS_H
+
+#include <QString>
+
+// network ports of one simulation hosted by the simulator-cli
+struct SimulatorPorts
+{
+    int control;
+    int blue;
+    int yellow;
+    int vision;
+};
+
+// the first simulation uses the standard ports, simulation i shifts all of them by i * portStride
+SimulatorPorts simulatorPorts(int instance, int portStride);
+// checks the ports of all simulations, returns an error message if a port is used twice
+// or is not a valid port number and an empty string otherwise
+QString checkSimulatorPorts(int instanceCount, int portStride);
+
+#endif // SIMULATORPORTS_H
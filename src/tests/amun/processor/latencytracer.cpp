@@ -0,0 +1,103 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "processor/latencytracer.h"
+#include "protobuf/status.pb.h"
+
+TEST(LatencyTracer, StageDurations) {
+    LatencyTracer tracer;
+    tracer.frameQueued(100, 1000);
+    tracer.processingStarted(1500);
+    tracer.trackingFinished(1700);
+    tracer.radioCommandsSent(2000);
+
+    ASSERT_EQ(tracer.history().size(), 1u);
+    const LatencyTracer::Trace &trace = tracer.history().front();
+    ASSERT_EQ(trace.id, 0u);
+    ASSERT_EQ(LatencyTracer::stageDuration(trace, LatencyTracer::ReceiveToQueue), 100);
+    ASSERT_EQ(LatencyTracer::stageDuration(trace, LatencyTracer::QueueToProcessing), 500);
+    ASSERT_EQ(LatencyTracer::stageDuration(trace, LatencyTracer::Tracking), 200);
+    ASSERT_EQ(LatencyTracer::stageDuration(trace, LatencyTracer::Controller), 300);
+    ASSERT_EQ(LatencyTracer::stageDuration(trace, LatencyTracer::Total), 1100);
+}
+
+TEST(LatencyTracer, FramesDuringProcessing) {
+    LatencyTracer tracer;
+    tracer.frameQueued(0, 1000);
+    tracer.processingStarted(1500);
+    // arrives while the first frame is processed
+    tracer.frameQueued(0, 1600);
+    tracer.trackingFinished(1700);
+    tracer.radioCommandsSent(2000);
+    ASSERT_EQ(tracer.history().size(), 1u);
+
+    tracer.processingStarted(2500);
+    tracer.trackingFinished(2600);
+    tracer.radioCommandsSent(2700);
+    ASSERT_EQ(tracer.history().size(), 2u);
+    ASSERT_EQ(tracer.history().back().id, 1u);
+    ASSERT_EQ(tracer.history().back().processingStart, 2500);
+}
+
+TEST(LatencyTracer, HistoryLimit) {
+    LatencyTracer tracer(10);
+    for (int i = 0; i < 25; i++) {
+        tracer.frameQueued(0, i);
+        tracer.processingStarted(i);
+        tracer.trackingFinished(i);
+        tracer.radioCommandsSent(i);
+    }
+    ASSERT_EQ(tracer.history().size(), 10u);
+    ASSERT_EQ(tracer.history().front().id, 15u);
+}
+
+TEST(LatencyTracer, Histograms) {
+    LatencyTracer tracer;
+    amun::Timing empty;
+    tracer.fillHistograms(&empty);
+    ASSERT_EQ(empty.vision_latency_size(), 0);
+
+    // total latencies of 1 to 100 ms
+    for (int i = 1; i <= 100; i++) {
+        tracer.frameQueued(0, 0);
+        tracer.processingStarted(0);
+        tracer.trackingFinished(0);
+        tracer.radioCommandsSent(i * 1000 * 1000);
+    }
+
+    amun::Timing timing;
+    tracer.fillHistograms(&timing);
+    ASSERT_EQ(timing.vision_latency_size(), int(LatencyTracer::StageCount));
+    const amun::LatencyHistogram &total = timing.vision_latency(LatencyTracer::Total);
+    ASSERT_EQ(total.stage(), "total");
+    ASSERT_EQ(total.samples(), 100u);
+    ASSERT_NEAR(total.p50(), 0.051, 1E-6);
+    ASSERT_NEAR(total.p99(), 0.1, 1E-6);
+    ASSERT_NEAR(total.max(), 0.1, 1E-6);
+}
+
+TEST(LatencyTracer, WallClockDuration) {
+    ASSERT_EQ(LatencyTracer::wallClockDuration(1000, 1), 1000);
+    // a replay with double speed advances the timer twice as fast
+    ASSERT_EQ(LatencyTracer::wallClockDuration(1000, 2), 500);
+    ASSERT_EQ(LatencyTracer::wallClockDuration(1000, 0.5), 2000);
+    ASSERT_EQ(LatencyTracer::wallClockDuration(1000, 0), 0);
+}
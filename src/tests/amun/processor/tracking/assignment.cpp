@@ -0,0 +1,63 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "tracking/assignment.h"
+#include <limits>
+
+TEST(Assignment, Empty) {
+    ASSERT_TRUE(solveAssignment({}, 0, 3, 1).empty());
+    ASSERT_EQ(solveAssignment({}, 2, 0, 1), std::vector<int>({-1, -1}));
+}
+
+TEST(Assignment, PrefersGlobalOptimum) {
+    // greedy assignment of the first row would take column 0 and force the second row to the expensive column
+    const std::vector<float> costs = {
+        1, 2,
+        1.5f, 10
+    };
+    ASSERT_EQ(solveAssignment(costs, 2, 2, 100), std::vector<int>({1, 0}));
+}
+
+TEST(Assignment, Gating) {
+    const std::vector<float> costs = {
+        0.1f, 5,
+        0.2f, std::numeric_limits<float>::infinity()
+    };
+    // the second row can not take the first column, it stays unassigned rather than using the gated pair
+    ASSERT_EQ(solveAssignment(costs, 2, 2, 1), std::vector<int>({0, -1}));
+    // only the closer row gets the single column
+    ASSERT_EQ(solveAssignment({0.6f, 0.5f}, 2, 1, 1), std::vector<int>({-1, 0}));
+}
+
+TEST(Assignment, Rectangular) {
+    const std::vector<float> costs = {
+        3, 1, 2,
+        1, 3, 2
+    };
+    ASSERT_EQ(solveAssignment(costs, 2, 3, 10), std::vector<int>({1, 0}));
+
+    const std::vector<float> transposed = {
+        3, 1,
+        1, 3,
+        2, 2
+    };
+    ASSERT_EQ(solveAssignment(transposed, 3, 2, 10), std::vector<int>({1, 0, -1}));
+}
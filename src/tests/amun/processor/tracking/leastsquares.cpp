@@ -0,0 +1,105 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "tracking/leastsquares.h"
+
+#include <Eigen/QR>
+#include <vector>
+
+static const float GRAVITY = 9.81f;
+
+struct ChipSystem {
+    Eigen::MatrixXf rows;
+    Eigen::VectorXf values;
+};
+
+// builds the system used by FlyFilter::calcPinv for a chip seen by a single camera
+static ChipSystem chipSystem(int frames, float noise)
+{
+    const Eigen::Vector3f cam(0.5f, -1.0f, 4.0f);
+    const Eigen::Vector3f start(1.0f, 0.5f, 0.0f);
+    const Eigen::Vector3f speed(2.0f, 1.0f, 3.5f);
+
+    ChipSystem system;
+    system.rows = Eigen::MatrixXf::Zero(2 * frames, 6);
+    system.values = Eigen::VectorXf::Zero(2 * frames);
+    for (int i = 0; i < frames; i++) {
+        const float t = i / 60.0f;
+        const Eigen::Vector3f pos = start + speed * t - Eigen::Vector3f(0, 0, 0.5f * GRAVITY * t * t);
+        // projection of the ball onto the ground as seen by the camera
+        const float lambda = cam.z() / (cam.z() - pos.z());
+        const float sign = (i % 2 == 0) ? 1 : -1;
+        const float x = cam.x() + (pos.x() - cam.x()) * lambda + sign * noise;
+        const float y = cam.y() + (pos.y() - cam.y()) * lambda - sign * noise;
+        const float alpha = (x - cam.x()) / cam.z();
+        const float beta = (y - cam.y()) / cam.z();
+
+        system.rows.row(2 * i) << alpha, alpha * t, 1, t, 0, 0;
+        system.values(2 * i) = 0.5f * GRAVITY * alpha * t * t + x;
+        system.rows.row(2 * i + 1) << beta, beta * t, 0, 0, 1, t;
+        system.values(2 * i + 1) = 0.5f * GRAVITY * beta * t * t + y;
+    }
+    return system;
+}
+
+TEST(LeastSquares, MatchesBatchSolver) {
+    for (float noise : {0.0f, 0.002f}) {
+        const ChipSystem system = chipSystem(60, noise);
+
+        LeastSquares<6> equations;
+        for (int i = 0; i < system.rows.rows(); i++) {
+            equations.addRow(system.rows.row(i), system.values(i));
+
+            // the reconstruction is done for every new frame
+            if (i % 2 == 1 && i >= 7) {
+                const Eigen::VectorXf batch = system.rows.topRows(i + 1).colPivHouseholderQr().solve(system.values.head(i + 1));
+                const Eigen::VectorXf incremental = equations.solve().cast<float>();
+                ASSERT_TRUE(incremental.isApprox(batch, 1E-3f)) << "frame " << i / 2 << "\n" << incremental << "\n" << batch;
+            }
+        }
+        ASSERT_EQ(equations.rows(), 120);
+
+        const Eigen::Matrix<double, 6, 1> solution = equations.solve();
+        // z0, vz, x0, vx, y0, vy
+        ASSERT_NEAR(solution(0), 0, 0.02);
+        ASSERT_NEAR(solution(1), 3.5, 0.05);
+        ASSERT_NEAR(solution(2), 1.0, 0.01);
+        ASSERT_NEAR(solution(3), 2.0, 0.05);
+        ASSERT_NEAR(solution(4), 0.5, 0.01);
+        ASSERT_NEAR(solution(5), 1.0, 0.05);
+    }
+}
+
+TEST(LeastSquares, SquaredError) {
+    const ChipSystem system = chipSystem(40, 0.003f);
+    LeastSquares<6> equations;
+    for (int i = 0; i < system.rows.rows(); i++) {
+        equations.addRow(system.rows.row(i), system.values(i));
+    }
+
+    const Eigen::Matrix<double, 6, 1> solution = equations.solve();
+    const Eigen::VectorXd residual = system.rows.cast<double>() * solution - system.values.cast<double>();
+    ASSERT_NEAR(equations.squaredError(solution), residual.squaredNorm(), 1E-6);
+
+    equations.clear();
+    ASSERT_EQ(equations.rows(), 0);
+    ASSERT_EQ(equations.squaredError(solution), 0);
+}
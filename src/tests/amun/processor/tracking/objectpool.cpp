@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "tracking/objectpool.h"
+
+#include <vector>
+
+namespace {
+    struct Counted {
+        explicit Counted(int value) : value(value) { instances++; }
+        ~Counted() { instances--; }
+        int value;
+        static int instances;
+    };
+    int Counted::instances = 0;
+}
+
+TEST(ObjectPool, ReusesSlots) {
+    ObjectPool<Counted> pool(2);
+    ASSERT_EQ(pool.freeSlots(), 2);
+
+    Counted *a = pool.create(1);
+    Counted *b = pool.create(2);
+    ASSERT_EQ(pool.freeSlots(), 0);
+    ASSERT_EQ(a->value, 1);
+    ASSERT_EQ(b->value, 2);
+    ASSERT_EQ(Counted::instances, 2);
+
+    pool.destroy(a);
+    ASSERT_EQ(pool.freeSlots(), 1);
+    ASSERT_EQ(Counted::instances, 1);
+
+    Counted *c = pool.create(3);
+    ASSERT_EQ(c, a);
+    ASSERT_EQ(c->value, 3);
+
+    pool.destroy(b);
+    pool.destroy(c);
+    ASSERT_EQ(pool.freeSlots(), 2);
+    ASSERT_EQ(Counted::instances, 0);
+}
+
+TEST(ObjectPool, HeapFallback) {
+    ObjectPool<Counted> pool(1);
+    std::vector<Counted*> objects;
+    for (int i = 0; i < 5; i++) {
+        objects.push_back(pool.create(i));
+    }
+    ASSERT_EQ(pool.freeSlots(), 0);
+    ASSERT_EQ(Counted::instances, 5);
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQ(objects[i]->value, i);
+    }
+
+    for (Counted *object : objects) {
+        pool.destroy(object);
+    }
+    ASSERT_EQ(pool.freeSlots(), 1);
+    ASSERT_EQ(Counted::instances, 0);
+
+    pool.destroy(nullptr);
+    ASSERT_EQ(pool.freeSlots(), 1);
+}
@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "seshat/backlogwriter.h"
+#include "seshat/logfileindex.h"
+#include "seshat/logfilereader.h"
+
+#include <QDataStream>
+#include <QFile>
+
+const static QString filename("temp_unittest_backlogwriter.log");
+
+TEST(BacklogWriter, KeepsTheNewestGroups) {
+    class DeleteFile {
+    public:
+        ~DeleteFile() {
+            QFile::remove(filename);
+            QFile::remove(LogFileIndex::indexFilename(filename));
+        }
+    };
+    DeleteFile del;
+
+    // one second holds 570 statuses
+    BacklogWriter writer(1);
+    for (int i = 0;i<1050;i++) {
+        Status status(new amun::Status);
+        status->set_time(1000 + i);
+        if (i == 0) {
+            robot::Specs *specs = status->mutable_team_blue()->add_robot();
+            specs->set_generation(2020);
+            specs->set_year(2020);
+            specs->set_id(3);
+        }
+        writer.handleStatus(status);
+    }
+    // the oldest groups are dropped completely
+    ASSERT_LE(writer.packetCount(), 570);
+    ASSERT_EQ(writer.packetCount() % 100, 50);
+    ASSERT_GT(writer.usedBytes(), 0);
+
+    std::shared_ptr<StatusSource> source = writer.makeStatusSource();
+    const int count = source->packetCount();
+    ASSERT_EQ(count, writer.packetCount());
+    for (int i : {0, 99, 100, count - 51, count - 50, count - 1}) {
+        ASSERT_EQ(source->readStatus(i)->time(), 1000 + 1050 - count + i);
+    }
+
+    writer.saveBacklog(filename, false);
+    {
+        // saved as a zlib compressed version 2 log
+        QFile file(filename);
+        ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_4_6);
+        QString header;
+        int version;
+        stream >> header >> version;
+        ASSERT_EQ(version, 2);
+    }
+    LogFileReader reader;
+    ASSERT_TRUE(reader.open(filename)) << reader.errorMsg().toStdString();
+    ASSERT_TRUE(reader.readStatus(0)->has_log_id());
+    // the team of the dropped status is kept
+    bool hasTeam = false;
+    for (int i = 0;i<reader.packetCount() - count;i++) {
+        const Status status = reader.readStatus(i);
+        hasTeam = hasTeam || (status->has_team_blue() && status->team_blue().robot_size() == 1);
+    }
+    ASSERT_TRUE(hasTeam);
+    ASSERT_EQ(reader.readStatus(reader.packetCount() - 1)->time(), 1000 + 1049);
+    ASSERT_EQ(reader.readStatus(reader.packetCount() - count)->time(), 1000 + 1050 - count);
+
+    writer.clear();
+    ASSERT_EQ(writer.packetCount(), 0);
+}
@@ -0,0 +1,94 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "seshat/boundedqueue.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST(BoundedQueue, KeepsOrder) {
+    BoundedQueue<int> queue(4);
+    std::thread producer([&queue] {
+        for (int i = 0;i<1000;i++) {
+            queue.push(int(i));
+        }
+        queue.close();
+    });
+
+    std::vector<int> received;
+    int value;
+    while (queue.pop(value)) {
+        received.push_back(value);
+    }
+    producer.join();
+
+    ASSERT_EQ(received.size(), 1000u);
+    for (int i = 0;i<1000;i++) {
+        ASSERT_EQ(received[i], i);
+    }
+}
+
+TEST(BoundedQueue, ReportsBackpressure) {
+    BoundedQueue<int> queue(2);
+    ASSERT_FALSE(queue.push(1));
+    ASSERT_FALSE(queue.push(2));
+    ASSERT_EQ(queue.size(), 2u);
+
+    std::thread consumer([&queue] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        int value;
+        queue.pop(value);
+    });
+    // has to wait for the consumer
+    ASSERT_TRUE(queue.push(3));
+    consumer.join();
+
+    // remaining values are available after closing
+    queue.close();
+    int value;
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(value, 2);
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(value, 3);
+    ASSERT_FALSE(queue.pop(value));
+
+    queue.reopen();
+    ASSERT_FALSE(queue.push(4));
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(value, 4);
+}
+
+TEST(BoundedQueue, TryPush) {
+    BoundedQueue<std::vector<int>> queue(1);
+    std::vector<int> first{1, 2};
+    ASSERT_TRUE(queue.tryPush(first));
+    std::vector<int> second{3};
+    ASSERT_FALSE(queue.tryPush(second));
+    // a rejected value is kept by the caller
+    ASSERT_EQ(second, std::vector<int>{3});
+
+    std::vector<int> value;
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(value, (std::vector<int>{1, 2}));
+    ASSERT_TRUE(queue.tryPush(second));
+    ASSERT_EQ(queue.size(), 1u);
+}
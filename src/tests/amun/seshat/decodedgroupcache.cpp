@@ -0,0 +1,137 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "seshat/decodedgroupcache.h"
+#include "seshat/logfileindex.h"
+#include "seshat/logfilewriter.h"
+#include "seshat/mappedlogfilereader.h"
+
+#include <QFile>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+const static QString filename("temp_unittest_decodedgroupcache.log");
+
+class DeleteCacheLog {
+public:
+    DeleteCacheLog() {
+        LogFileWriter writer;
+        writer.open(filename);
+        for (int i = 0;i<1000;i++) {
+            Status status(new amun::Status);
+            status->set_time(1000 + i);
+            writer.writeStatus(status);
+        }
+        writer.close();
+    }
+    ~DeleteCacheLog() {
+        QFile::remove(filename);
+        QFile::remove(LogFileIndex::indexFilename(filename));
+    }
+};
+
+static bool waitForCachedGroups(const DecodedGroupCache &cache, int groups)
+{
+    for (int i = 0;i<200 && cache.cachedGroups() < groups;i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return cache.cachedGroups() >= groups;
+}
+
+TEST(DecodedGroupCache, ReadsAndPrefetches) {
+    DeleteCacheLog log;
+    MappedLogFileReader reader;
+    ASSERT_TRUE(reader.open(filename));
+
+    DecodedGroupCache cache(reader, 64 * 1024 * 1024, 2);
+    ASSERT_EQ(cache.readStatus(450)->time(), 1450);
+    ASSERT_EQ(cache.readStatus(451)->time(), 1451);
+    ASSERT_EQ(cache.statistics().misses, 1);
+    ASSERT_EQ(cache.statistics().hits, 1);
+    // the two following groups are prefetched
+    ASSERT_TRUE(waitForCachedGroups(cache, 3));
+
+    ASSERT_EQ(cache.readStatus(550)->time(), 1550);
+    ASSERT_EQ(cache.readStatus(650)->time(), 1650);
+    ASSERT_EQ(cache.statistics().misses, 1);
+    ASSERT_TRUE(waitForCachedGroups(cache, 5));
+
+    // scrubbing backwards prefetches the previous groups
+    ASSERT_EQ(cache.readStatus(350)->time(), 1350);
+    ASSERT_TRUE(waitForCachedGroups(cache, 8));
+    ASSERT_EQ(cache.readStatus(250)->time(), 1250);
+    ASSERT_EQ(cache.readStatus(150)->time(), 1150);
+    ASSERT_EQ(cache.statistics().misses, 2);
+
+    ASSERT_TRUE(cache.readStatus(1000).isNull());
+    ASSERT_TRUE(cache.readStatus(-1).isNull());
+}
+
+TEST(DecodedGroupCache, EvictsLeastRecentlyUsed) {
+    DeleteCacheLog log;
+    MappedLogFileReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    MappedLogFileReader::Decoder decoder(reader);
+    const std::size_t groupSize = decoder.decompressGroup(1).size();
+
+    DecodedGroupCache cache(reader, groupSize * 2, 0);
+    for (int i = 0;i<1000;i++) {
+        ASSERT_EQ(cache.readStatus(i)->time(), 1000 + i);
+        ASSERT_LE(cache.cachedBytes(), groupSize * 2);
+    }
+    ASSERT_EQ(cache.cachedGroups(), 2);
+
+    // the last two groups are still cached
+    const qint64 misses = cache.statistics().misses;
+    cache.readStatus(850);
+    ASSERT_EQ(cache.statistics().misses, misses);
+    cache.readStatus(50);
+    ASSERT_EQ(cache.statistics().misses, misses + 1);
+}
+
+TEST(DecodedGroupCache, ConcurrentReadsDecodeOnce) {
+    DeleteCacheLog log;
+    MappedLogFileReader reader;
+    ASSERT_TRUE(reader.open(filename));
+
+    // without prefetching, every miss is a decompression
+    DecodedGroupCache cache(reader, 64 * 1024 * 1024, 0);
+    std::vector<std::thread> threads;
+    std::atomic<int> errors(0);
+    for (int t = 0;t<8;t++) {
+        threads.emplace_back([&cache, &errors] {
+            for (int i = 0;i<300;i++) {
+                const Status status = cache.readStatus(i);
+                if (status.isNull() || status->time() != 1000 + i) {
+                    errors++;
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(errors, 0);
+    ASSERT_EQ(cache.statistics().misses, 3);
+    ASSERT_EQ(cache.statistics().hits, 8 * 300 - 3);
+}
@@ -0,0 +1,161 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "seshat/logcodec.h"
+#include "seshat/logfileindex.h"
+#include "seshat/logfilewriter.h"
+#include "seshat/seqlogfilereader.h"
+
+#include <QDataStream>
+#include <QFile>
+
+static QList<LogCodec::Codec> supportedCodecs()
+{
+    QList<LogCodec::Codec> codecs;
+    for (LogCodec::Codec codec : {LogCodec::Zlib, LogCodec::Zstd, LogCodec::Lz4}) {
+        if (LogCodec::isSupported(codec)) {
+            codecs.append(codec);
+        }
+    }
+    return codecs;
+}
+
+static QByteArray serializedStatus(qint64 time)
+{
+    Status status(new amun::Status);
+    status->set_time(time);
+    status->mutable_world_state()->set_time(time);
+    status->mutable_world_state()->mutable_ball()->set_p_x(time * 0.001f);
+    status->mutable_world_state()->mutable_ball()->set_p_y(1.5f);
+    QByteArray data;
+    data.resize(status->ByteSize());
+    status->SerializeToArray(data.data(), data.size());
+    return data;
+}
+
+TEST(LogCodec, RoundTrip) {
+    QByteArray data;
+    for (int i = 0;i<200;i++) {
+        data.append(serializedStatus(1000 + i));
+    }
+
+    for (LogCodec::Codec codec : supportedCodecs()) {
+        LogCodec compressor(codec);
+        LogCodec decompressor(codec);
+        const QByteArray compressed = compressor.compress(data);
+        ASSERT_FALSE(compressed.isEmpty()) << LogCodec::name(codec).toStdString();
+        ASSERT_LT(compressed.size(), data.size());
+        ASSERT_EQ(decompressor.uncompress(compressed), data);
+        // the contexts are reused
+        ASSERT_EQ(decompressor.uncompress(compressor.compress(data.left(100))), data.left(100));
+
+        // corrupt data must not crash
+        ASSERT_TRUE(decompressor.uncompress(compressed.left(compressed.size() / 2)).isEmpty());
+        ASSERT_TRUE(decompressor.uncompress(QByteArray()).isEmpty());
+        if (codec != LogCodec::Zlib) {
+            // the size prefix is not trusted
+            QByteArray hugePrefix = compressed;
+            hugePrefix[0] = char(0x7f);
+            ASSERT_TRUE(decompressor.uncompress(hugePrefix).isEmpty());
+        }
+    }
+}
+
+TEST(LogCodec, Dictionary) {
+    if (!LogCodec::isSupported(LogCodec::Zstd)) {
+        return;
+    }
+    QList<QByteArray> samples;
+    for (int i = 0;i<1000;i++) {
+        samples.append(serializedStatus(i * 17));
+    }
+    const QByteArray dictionary = LogCodec::trainDictionary(samples, 4096);
+    if (dictionary.isEmpty()) {
+        // too few samples to train a dictionary
+        return;
+    }
+
+    LogCodec compressor(LogCodec::Zstd, dictionary);
+    LogCodec decompressor(LogCodec::Zstd, dictionary);
+    const QByteArray data = serializedStatus(123456);
+    ASSERT_EQ(decompressor.uncompress(compressor.compress(data)), data);
+    // the dictionary is required
+    LogCodec withoutDictionary(LogCodec::Zstd);
+    ASSERT_TRUE(withoutDictionary.uncompress(compressor.compress(data)).isEmpty());
+}
+
+TEST(LogCodec, LogFile) {
+    const QString filename("temp_unittest_logcodec.log");
+    class DeleteFile {
+    public:
+        DeleteFile(const QString &name) : m_name(name) {}
+        ~DeleteFile() {
+            QFile::remove(m_name);
+            QFile::remove(LogFileIndex::indexFilename(m_name));
+        }
+    private:
+        QString m_name;
+    };
+    DeleteFile del(filename);
+
+    // zlib compressed logs stay readable by older versions
+    {
+        LogFileWriter writer;
+        ASSERT_TRUE(writer.open(filename));
+        writer.close();
+        QFile file(filename);
+        ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_4_6);
+        QString name;
+        int version;
+        stream >> name >> version;
+        ASSERT_EQ(version, 2);
+    }
+
+    for (LogCodec::Codec codec : supportedCodecs()) {
+        LogFileWriter writer;
+        writer.setCompression(codec);
+        ASSERT_TRUE(writer.open(filename));
+        for (int i = 0;i<250;i++) {
+            Status status(new amun::Status);
+            status->set_time(1000 + i);
+            writer.writeStatus(status);
+        }
+        writer.close();
+
+        SeqLogFileReader reader;
+        ASSERT_TRUE(reader.open(filename)) << reader.errorMsg().toStdString();
+        for (int i = 0;i<250;i++) {
+            const Status status = reader.readStatus();
+            ASSERT_FALSE(status.isNull());
+            ASSERT_EQ(status->time(), 1000 + i);
+        }
+        ASSERT_TRUE(reader.atEnd());
+    }
+
+    // files can only be written with codecs that are known to the reader
+    if (!LogCodec::isSupported(LogCodec::Lz4)) {
+        LogFileWriter writer;
+        writer.setCompression(LogCodec::Lz4);
+        ASSERT_FALSE(writer.open(filename));
+    }
+}
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "seshat/logfilecatalogue.h"
+#include "seshat/logfilewriter.h"
+
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QTemporaryDir>
+
+static logfile::Uid writeCatalogueTestLog(const QString &name, int packets, qint64 startTime)
+{
+    LogFileWriter writer;
+    EXPECT_TRUE(writer.open(name));
+    for (int i = 0;i<packets;i++) {
+        Status status(new amun::Status);
+        status->set_time(startTime + i * 1000);
+        writer.writeStatus(status);
+    }
+    writer.close();
+    return writer.getHash();
+}
+
+TEST(LogFileCatalogue, ScansIncrementally) {
+    QTemporaryDir directory;
+    ASSERT_TRUE(directory.isValid());
+    QTemporaryDir cache;
+    ASSERT_TRUE(cache.isValid());
+    const QDir dir(directory.path());
+
+    const logfile::Uid first = writeCatalogueTestLog(dir.filePath("a.log"), 150, 1000);
+    const logfile::Uid second = writeCatalogueTestLog(dir.filePath("b.log"), 150, 5000);
+    {
+        QFile invalid(dir.filePath("c.log"));
+        ASSERT_TRUE(invalid.open(QIODevice::WriteOnly));
+        invalid.write("not a log");
+    }
+
+    const QStringList files = dir.entryList(QDir::Files | QDir::Hidden);
+    QList<LogFileCatalogue::Entry> entries = LogFileCatalogue::scanDirectory(directory.path(), 2, cache.path());
+    ASSERT_EQ(entries.size(), 3);
+    ASSERT_TRUE(QFile::exists(LogFileCatalogue::catalogueFilename(directory.path(), cache.path())));
+    // the scanned directory is not modified
+    ASSERT_EQ(dir.entryList(QDir::Files | QDir::Hidden), files);
+    ASSERT_EQ(entries[0].filename, dir.absoluteFilePath("a.log"));
+    ASSERT_EQ(entries[0].state, LogFileCatalogue::Entry::HasLogId);
+    ASSERT_EQ(entries[0].uid.SerializeAsString(), first.SerializeAsString());
+    ASSERT_EQ(entries[1].state, LogFileCatalogue::Entry::HasLogId);
+    ASSERT_EQ(entries[1].uid.SerializeAsString(), second.SerializeAsString());
+    ASSERT_EQ(entries[2].state, LogFileCatalogue::Entry::Unreadable);
+    ASSERT_FALSE(entries[2].error.isEmpty());
+
+    // the catalogue is read again
+    QList<LogFileCatalogue::Entry> cached = LogFileCatalogue::scanDirectory(directory.path(), 2, cache.path());
+    ASSERT_EQ(cached.size(), 3);
+    for (int i = 0;i<3;i++) {
+        ASSERT_EQ(cached[i].filename, entries[i].filename);
+        ASSERT_EQ(cached[i].state, entries[i].state);
+        ASSERT_EQ(cached[i].uid.SerializeAsString(), entries[i].uid.SerializeAsString());
+        ASSERT_EQ(cached[i].error, entries[i].error);
+    }
+
+    // modified and removed logs are updated
+    const logfile::Uid replaced = writeCatalogueTestLog(dir.filePath("b.log"), 250, 9000);
+    ASSERT_TRUE(QFile::remove(dir.filePath("c.log")));
+    entries = LogFileCatalogue::scanDirectory(directory.path(), 2, cache.path());
+    ASSERT_EQ(entries.size(), 2);
+    ASSERT_EQ(entries[1].uid.SerializeAsString(), replaced.SerializeAsString());
+}
+
+TEST(LogFileCatalogue, WithoutCache) {
+    QTemporaryDir directory;
+    ASSERT_TRUE(directory.isValid());
+    const QDir dir(directory.path());
+    const logfile::Uid uid = writeCatalogueTestLog(dir.filePath("a.log"), 150, 1000);
+
+    const QStringList files = dir.entryList(QDir::Files | QDir::Hidden);
+    const QList<LogFileCatalogue::Entry> entries = LogFileCatalogue::scanDirectory(directory.path(), 1, QString());
+    ASSERT_EQ(entries.size(), 1);
+    ASSERT_EQ(entries[0].uid.SerializeAsString(), uid.SerializeAsString());
+    ASSERT_TRUE(LogFileCatalogue::catalogueFilename(directory.path(), QString()).isEmpty());
+    ASSERT_EQ(dir.entryList(QDir::Files | QDir::Hidden), files);
+}
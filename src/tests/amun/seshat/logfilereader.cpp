@@ -19,12 +19,20 @@
  ***************************************************************************/
 
 #include "gtest/gtest.h"
+#include "seshat/logfileindex.h"
 #include "seshat/logfilereader.h"
 #include "seshat/logfilewriter.h"
 
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTemporaryDir>
 #include <QTimer>
 #include <QDebug>
+#include <random>
+#include <vector>
 
 const static QString filename("temp_unittest_logfilereader.log");
 
@@ -60,3 +68,191 @@ TEST(LogfileReader, TimestampZeroIsInvalid) {
     writer.close();
     ASSERT_FALSE(reader.open(filename));
 }
+
+static void writeTestLog(const QString &name, int packets, qint64 startTime)
+{
+    LogFileWriter writer;
+    ASSERT_TRUE(writer.open(name));
+    for (int i = 0;i<packets;i++) {
+        Status status(new amun::Status);
+        status->set_time(startTime + i * 1000);
+        writer.writeStatus(status);
+    }
+    writer.close();
+}
+
+TEST(LogfileReader, WriterStatistics) {
+    QTemporaryDir directory;
+    ASSERT_TRUE(directory.isValid());
+    const QString filename = directory.filePath("statistics.log");
+
+    LogFileWriter writer;
+    ASSERT_TRUE(writer.open(filename));
+    for (int i = 0;i<1050;i++) {
+        Status status(new amun::Status);
+        status->set_time(1000 + i);
+        writer.writeStatus(status);
+    }
+    // the completed groups are readable while the log is written
+    std::shared_ptr<StatusSource> source = writer.makeStatusSource();
+    ASSERT_LE(source->packetCount(), 1000);
+    writer.close();
+
+    const LogFileWriter::Statistics statistics = writer.statistics();
+    ASSERT_EQ(statistics.writtenStatuses, 1050);
+    ASSERT_EQ(statistics.droppedStatuses, 0);
+
+    LogFileReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    ASSERT_EQ(reader.packetCount(), 1050);
+    ASSERT_EQ(reader.readStatus(1049)->time(), 2049);
+}
+
+TEST(LogfileReader, PersistentIndex) {
+    QStandardPaths::setTestModeEnabled(true);
+    QTemporaryDir directory;
+    ASSERT_TRUE(directory.isValid());
+    const QString filename = directory.filePath("indexed.log");
+    const QString otherFilename = directory.filePath("other.log");
+
+    writeTestLog(filename, 250, 1000);
+    // the writer creates the index, which is kept outside of the log directory
+    ASSERT_TRUE(QFile::exists(LogFileIndex::indexFilename(filename)));
+    ASSERT_EQ(QDir(directory.path()).entryList(QDir::Files), QStringList{"indexed.log"});
+
+    LogFileReader indexed;
+    ASSERT_TRUE(indexed.open(filename));
+    const QList<qint64> timings = indexed.timings();
+
+    // scan without index, which recreates the index
+    QFile::remove(LogFileIndex::indexFilename(filename));
+    LogFileReader scanned;
+    ASSERT_TRUE(scanned.open(filename));
+    ASSERT_TRUE(QFile::exists(LogFileIndex::indexFilename(filename)));
+    ASSERT_EQ(QDir(directory.path()).entryList(QDir::Files), QStringList{"indexed.log"});
+    ASSERT_EQ(timings, scanned.timings());
+    ASSERT_EQ(indexed.packetCount(), scanned.packetCount());
+    for (int i : {0, 1, 99, 100, 137, 249}) {
+        ASSERT_EQ(indexed.readStatus(i)->time(), scanned.readStatus(i)->time());
+        ASSERT_EQ(indexed.readStatus(i)->time(), timings[i]);
+    }
+
+    // an index that does not belong to the log is ignored
+    writeTestLog(otherFilename, 120, 5000);
+    QFile::remove(LogFileIndex::indexFilename(otherFilename));
+    ASSERT_TRUE(QFile::copy(LogFileIndex::indexFilename(filename), LogFileIndex::indexFilename(otherFilename)));
+    LogFileReader other;
+    ASSERT_TRUE(other.open(otherFilename));
+    ASSERT_EQ(other.packetCount(), 120);
+    ASSERT_EQ(other.readStatus(119)->time(), 5000 + 119 * 1000);
+}
+
+TEST(LogfileReader, IndexChecksGroups) {
+    QStandardPaths::setTestModeEnabled(true);
+    QTemporaryDir directory;
+    ASSERT_TRUE(directory.isValid());
+    const QString filename = directory.filePath("modified.log");
+
+    // incompressible packets, so that the middle of the log is not part of the fingerprint
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> character('a', 'z');
+    LogFileWriter writer;
+    ASSERT_TRUE(writer.open(filename));
+    for (int i = 0;i<300;i++) {
+        Status status(new amun::Status);
+        status->set_time(1000 + i * 1000);
+        amun::DebugValues *debug = status->add_debug();
+        debug->set_source(amun::StrategyBlue);
+        amun::StatusLog *log = debug->add_log();
+        log->set_timestamp(status->time());
+        std::string text(2000, ' ');
+        for (char &c : text) {
+            c = char(character(random));
+        }
+        log->set_text(text);
+        writer.writeStatus(status);
+    }
+    writer.close();
+    ASSERT_TRUE(QFile::exists(LogFileIndex::indexFilename(filename)));
+
+    // change the first timestamp of the second group in place, which keeps the size of the log
+    const qint64 originalTime = 1000 + 100 * 1000;
+    QByteArray original;
+    QByteArray modified;
+    {
+        QDataStream originalStream(&original, QIODevice::WriteOnly);
+        originalStream << originalTime;
+        QDataStream modifiedStream(&modified, QIODevice::WriteOnly);
+        modifiedStream << originalTime + 1;
+    }
+    const QDateTime lastModified = QFileInfo(filename).lastModified();
+    QFile file(filename);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    const qint64 size = file.size();
+    const QByteArray content = file.readAll();
+    const int position = content.indexOf(original);
+    ASSERT_GT(position, 64 * 1024);
+    ASSERT_LT(position, size - 64 * 1024);
+    ASSERT_TRUE(file.seek(position));
+    ASSERT_EQ(file.write(modified), modified.size());
+    file.close();
+    // neither size nor modification time show the change
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.setFileTime(lastModified, QFileDevice::FileModificationTime));
+    file.close();
+    ASSERT_EQ(QFileInfo(filename).lastModified(), lastModified);
+
+    // the stale index is ignored
+    LogFileReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    ASSERT_EQ(reader.packetCount(), 300);
+    ASSERT_EQ(reader.timings()[100], originalTime + 1);
+}
+
+TEST(LogfileReader, GroupCacheMatchesSequentialReader) {
+    QTemporaryDir directory;
+    ASSERT_TRUE(directory.isValid());
+    const QString filename = directory.filePath("cached.log");
+
+    LogFileWriter writer;
+    ASSERT_TRUE(writer.open(filename));
+    for (int i = 0;i<350;i++) {
+        Status status(new amun::Status);
+        status->set_time(1000 + i * 1000);
+        status->mutable_world_state()->set_time(status->time());
+        status->mutable_world_state()->mutable_ball()->set_p_x(i * 0.01f);
+        status->mutable_world_state()->mutable_ball()->set_p_y(-i * 0.02f);
+        writer.writeStatus(status);
+    }
+    writer.close();
+
+    std::vector<std::string> expected;
+    SeqLogFileReader sequential;
+    ASSERT_TRUE(sequential.open(filename));
+    while (!sequential.atEnd()) {
+        const Status status = sequential.readStatus();
+        ASSERT_FALSE(status.isNull());
+        expected.push_back(status->SerializeAsString());
+    }
+    ASSERT_EQ(expected.size(), 350u);
+
+    // scrub forwards, backwards and across groups, which reads through the decoded group cache
+    LogFileReader reader;
+    ASSERT_TRUE(reader.open(filename));
+    reader.setGroupCacheSize(1024 * 1024);
+    std::vector<int> packets;
+    for (int i = 0;i<350;i++) {
+        packets.push_back(i);
+    }
+    for (int i = 349;i>=0;i-=3) {
+        packets.push_back(i);
+    }
+    for (int i : {0, 349, 100, 99, 250, 1, 200}) {
+        packets.push_back(i);
+    }
+    for (int packet : packets) {
+        const Status status = reader.readStatus(packet);
+        ASSERT_FALSE(status.isNull()) << packet;
+        ASSERT_EQ(status->SerializeAsString(), expected[packet]) << packet;
+    }
+}
@@ -0,0 +1,167 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "seshat/logfileindex.h"
+#include "seshat/logfilereader.h"
+#include "seshat/logfilewriter.h"
+#include "seshat/loggroupcopier.h"
+#include "seshat/mappedlogfilereader.h"
+#include "seshat/seqlogfilereader.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QStringList>
+
+const static QString inputFilename("temp_unittest_loggroupcopier_in.log");
+const static QString otherFilename("temp_unittest_loggroupcopier_other.log");
+const static QString outputFilename("temp_unittest_loggroupcopier_out.log");
+
+class DeleteCopierLogs {
+public:
+    ~DeleteCopierLogs() {
+        for (const QString &file : {inputFilename, otherFilename, outputFilename}) {
+            QFile::remove(file);
+            QFile::remove(LogFileIndex::indexFilename(file));
+        }
+    }
+};
+
+static void writeCopierTestLog(const QString &name, int packets, qint64 startTime)
+{
+    LogFileWriter writer;
+    ASSERT_TRUE(writer.open(name));
+    for (int i = 0;i<packets;i++) {
+        Status status(new amun::Status);
+        status->set_time(startTime + i * 1000);
+        writer.writeStatus(status);
+    }
+    writer.close();
+}
+
+static int logVersion(const QString &name)
+{
+    QFile file(name);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_6);
+    QString header;
+    int version = -1;
+    stream >> header >> version;
+    return version;
+}
+
+TEST(LogGroupCopier, CopiesInnerGroupsVerbatim) {
+    DeleteCopierLogs del;
+    writeCopierTestLog(inputFilename, 1050, 1000);
+
+    MappedLogFileReader input;
+    ASSERT_TRUE(input.open(inputFilename));
+    LogGroupCopier copier;
+    ASSERT_TRUE(copier.open(outputFilename, input.codec(), input.dictionary()));
+    ASSERT_TRUE(copier.append(input, 150, 950));
+    ASSERT_TRUE(copier.close());
+
+    // only the groups at the boundaries are partially copied
+    const LogGroupCopier::Statistics statistics = copier.statistics();
+    ASSERT_EQ(statistics.copiedGroups, 7);
+    ASSERT_EQ(statistics.reencodedGroups, 2);
+    ASSERT_EQ(statistics.packets, 800);
+    // the first group is only partially filled
+    ASSERT_EQ(logVersion(outputFilename), 4);
+
+    LogFileReader indexed;
+    ASSERT_TRUE(indexed.open(outputFilename)) << indexed.errorMsg().toStdString();
+    ASSERT_EQ(indexed.packetCount(), 800);
+    for (int i : {0, 49, 50, 51, 399, 749, 750, 799}) {
+        ASSERT_EQ(indexed.readStatus(i)->time(), input.timings()[150 + i]);
+    }
+
+    // the partially filled group in the middle must also be accepted without the index
+    QFile::remove(LogFileIndex::indexFilename(outputFilename));
+    LogFileReader scanned;
+    ASSERT_TRUE(scanned.open(outputFilename)) << scanned.errorMsg().toStdString();
+    ASSERT_EQ(scanned.timings(), indexed.timings());
+
+    SeqLogFileReader sequential;
+    ASSERT_TRUE(sequential.open(outputFilename));
+    int count = 0;
+    while (!sequential.atEnd()) {
+        const Status status = sequential.readStatus();
+        ASSERT_FALSE(status.isNull());
+        ASSERT_EQ(status->time(), input.timings()[150 + count]);
+        count++;
+    }
+    ASSERT_EQ(count, 800);
+
+    // only full zlib groups, which is readable by older versions
+    ASSERT_EQ(input.codec(), LogCodec::Zlib);
+    ASSERT_TRUE(copier.open(outputFilename, input.codec(), input.dictionary()));
+    ASSERT_TRUE(copier.append(input, 100, 300));
+    ASSERT_TRUE(copier.close());
+    ASSERT_EQ(copier.statistics().copiedGroups, 2);
+    ASSERT_EQ(logVersion(outputFilename), 2);
+    LogFileReader versionTwo;
+    ASSERT_TRUE(versionTwo.open(outputFilename)) << versionTwo.errorMsg().toStdString();
+    ASSERT_EQ(versionTwo.packetCount(), 200);
+    ASSERT_EQ(versionTwo.readStatus(199)->time(), input.timings()[299]);
+
+    // other codecs need the header of version 3
+    if (LogCodec::isSupported(LogCodec::Zstd)) {
+        ASSERT_TRUE(copier.open(outputFilename, LogCodec::Zstd));
+        ASSERT_TRUE(copier.append(input, 100, 300));
+        ASSERT_TRUE(copier.close());
+        ASSERT_EQ(logVersion(outputFilename), 3);
+    }
+}
+
+TEST(LogGroupCopier, Concatenation) {
+    DeleteCopierLogs del;
+    writeCopierTestLog(inputFilename, 250, 1000);
+    writeCopierTestLog(otherFilename, 120, 1000 + 300 * 1000);
+
+    MappedLogFileReader first;
+    ASSERT_TRUE(first.open(inputFilename));
+    MappedLogFileReader second;
+    ASSERT_TRUE(second.open(otherFilename));
+
+    LogGroupCopier copier;
+    ASSERT_TRUE(copier.open(outputFilename, first.codec(), first.dictionary()));
+    Status status(new amun::Status);
+    status->set_time(500);
+    status->mutable_team_blue();
+    ASSERT_TRUE(copier.writeStatus(status));
+    ASSERT_TRUE(copier.append(first, 0, first.packetCount()));
+    ASSERT_TRUE(copier.append(second, 0, second.packetCount()));
+    // the packets must stay in chronological order
+    ASSERT_FALSE(copier.append(first, 0, 10));
+    ASSERT_TRUE(copier.close());
+
+    LogFileReader reader;
+    ASSERT_TRUE(reader.open(outputFilename)) << reader.errorMsg().toStdString();
+    ASSERT_EQ(reader.packetCount(), 1 + 250 + 120);
+    ASSERT_TRUE(reader.readStatus(0)->has_team_blue());
+    ASSERT_EQ(reader.readStatus(1)->time(), 1000);
+    ASSERT_EQ(reader.readStatus(250)->time(), 1000 + 249 * 1000);
+    ASSERT_EQ(reader.readStatus(251)->time(), 1000 + 300 * 1000);
+    ASSERT_EQ(reader.readStatus(370)->time(), 1000 + 419 * 1000);
+}
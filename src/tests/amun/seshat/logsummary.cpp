@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "seshat/logfilewriter.h"
+#include "seshat/logsummary.h"
+
+#include <QFile>
+
+class DeleteFile {
+public:
+    DeleteFile(const QString &name) : m_name(name) {}
+    ~DeleteFile() { QFile::remove(m_name); }
+private:
+    QString m_name;
+};
+
+static Status ballStatus(qint64 time, float x)
+{
+    Status status(new amun::Status);
+    status->set_time(time);
+    world::State *state = status->mutable_world_state();
+    state->set_time(time);
+    world::Ball *ball = state->mutable_ball();
+    ball->set_p_x(x);
+    ball->set_p_y(-x);
+    ball->set_v_x(0);
+    ball->set_v_y(0);
+    return status;
+}
+
+static Status gameStatus(qint64 time, SSL_Referee::Stage stage, amun::GameState::State state, int yellowScore, int blueScore)
+{
+    Status status(new amun::Status);
+    status->set_time(time);
+    amun::GameState *gameState = status->mutable_game_state();
+    gameState->set_stage(stage);
+    gameState->set_state(state);
+    gameState->mutable_yellow()->set_score(yellowScore);
+    gameState->mutable_blue()->set_score(blueScore);
+    return status;
+}
+
+static Status strategyStatus(qint64 time, amun::StatusStrategy::STATE state)
+{
+    Status status(new amun::Status);
+    status->set_time(time);
+    status->mutable_status_strategy()->set_type(amun::StatusStrategyWrapper::BLUE);
+    status->mutable_status_strategy()->mutable_status()->set_state(state);
+    return status;
+}
+
+TEST(LogSummary, Events) {
+    LogSummaryBuilder builder;
+    builder.addStatus(gameStatus(10, SSL_Referee::NORMAL_FIRST_HALF, amun::GameState::Halt, 0, 0));
+    builder.addStatus(gameStatus(20, SSL_Referee::NORMAL_FIRST_HALF, amun::GameState::Halt, 0, 0));
+    builder.addStatus(gameStatus(30, SSL_Referee::NORMAL_FIRST_HALF, amun::GameState::Game, 0, 0));
+    builder.addStatus(gameStatus(40, SSL_Referee::NORMAL_FIRST_HALF, amun::GameState::Game, 0, 1));
+    builder.addStatus(strategyStatus(50, amun::StatusStrategy::RUNNING));
+    builder.addStatus(strategyStatus(60, amun::StatusStrategy::FAILED));
+    builder.addStatus(strategyStatus(70, amun::StatusStrategy::FAILED));
+    builder.addStatus(gameStatus(80, SSL_Referee::NORMAL_HALF_TIME, amun::GameState::Game, 0, 1));
+
+    const QList<LogSummary::Event> &events = builder.summary().events;
+    ASSERT_EQ(events.size(), 7);
+    ASSERT_EQ(events[0].type, LogSummary::EventType::Stage);
+    ASSERT_EQ(events[1].type, LogSummary::EventType::GameState);
+    ASSERT_EQ(events[1].value, amun::GameState::Halt);
+    ASSERT_EQ(events[2].type, LogSummary::EventType::Score);
+    ASSERT_EQ(events[3].time, 30);
+    ASSERT_EQ(events[3].value, amun::GameState::Game);
+    ASSERT_EQ(events[4].type, LogSummary::EventType::Score);
+    ASSERT_EQ(events[4].detail, 1);
+    ASSERT_EQ(events[5].type, LogSummary::EventType::StrategyFailed);
+    ASSERT_EQ(events[5].time, 60);
+    ASSERT_EQ(events[5].value, amun::StatusStrategyWrapper::BLUE);
+    ASSERT_EQ(events[6].type, LogSummary::EventType::Stage);
+    ASSERT_EQ(events[6].value, SSL_Referee::NORMAL_HALF_TIME);
+
+    builder.clear();
+    ASSERT_TRUE(builder.summary().events.isEmpty());
+}
+
+TEST(LogSummary, WrittenByLogFileWriter) {
+    const QString filename("temp_unittest_logsummary.log");
+    DeleteFile delLog(filename);
+    DeleteFile delIndex(filename + ".index");
+    DeleteFile delSummary(LogSummary::filenameForLog(filename));
+
+    LogFileWriter writer;
+    writer.setWriteSummary(true);
+    ASSERT_TRUE(writer.open(filename));
+    // 10 seconds at 100 Hz
+    const qint64 start = 1000000000LL;
+    for (int i = 0;i<1000;i++) {
+        ASSERT_TRUE(writer.writeStatus(ballStatus(start + i * 10000000LL, i * 0.001f)));
+    }
+    writer.close();
+
+    LogSummary summary;
+    ASSERT_TRUE(LogSummary::read(filename, summary));
+    ASSERT_TRUE(summary.events.isEmpty());
+    ASSERT_EQ(summary.ball.size(), 10);
+    for (int i = 0;i<summary.ball.size();i++) {
+        ASSERT_EQ(summary.ball[i].time, start + i * LogSummary::BALL_SAMPLE_INTERVAL);
+        ASSERT_FLOAT_EQ(summary.ball[i].x, i * 0.1f);
+        ASSERT_FLOAT_EQ(summary.ball[i].y, -i * 0.1f);
+    }
+
+    // recreating the summary from the log yields the same result
+    LogSummary::remove(filename);
+    ASSERT_TRUE(LogSummary::create(filename));
+    LogSummary created;
+    ASSERT_TRUE(LogSummary::read(filename, created));
+    ASSERT_EQ(created.ball.size(), summary.ball.size());
+
+    // the summary is optional
+    writer.setWriteSummary(false);
+    ASSERT_TRUE(writer.open(filename));
+    writer.writeStatus(ballStatus(start, 0));
+    writer.close();
+    ASSERT_FALSE(QFile::exists(LogSummary::filenameForLog(filename)));
+}
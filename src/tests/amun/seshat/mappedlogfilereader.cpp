@@ -0,0 +1,138 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "seshat/logfilehasher.h"
+#include "seshat/logfileindex.h"
+#include "seshat/logfilereader.h"
+#include "seshat/logfilewriter.h"
+#include "seshat/mappedlogfilereader.h"
+#include "seshat/seqlogfilereader.h"
+
+#include <QFile>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+const static QString filename("temp_unittest_mappedlogfilereader.log");
+
+class DeleteMappedLog {
+public:
+    ~DeleteMappedLog() {
+        QFile::remove(filename);
+        QFile::remove(LogFileIndex::indexFilename(filename));
+    }
+};
+
+static void writeMappedTestLog(int packets)
+{
+    LogFileWriter writer;
+    ASSERT_TRUE(writer.open(filename));
+    for (int i = 0;i<packets;i++) {
+        Status status(new amun::Status);
+        status->set_time(1000 + i);
+        status->mutable_world_state()->set_time(1000 + i);
+        writer.writeStatus(status);
+    }
+    writer.close();
+}
+
+TEST(MappedLogFileReader, MatchesLogFileReader) {
+    DeleteMappedLog del;
+    writeMappedTestLog(350);
+
+    MappedLogFileReader mapped;
+    ASSERT_TRUE(mapped.open(filename)) << mapped.errorMsg().toStdString();
+    LogFileReader reader;
+    ASSERT_TRUE(reader.open(filename));
+
+    ASSERT_EQ(mapped.packetCount(), 350);
+    ASSERT_EQ(mapped.groupCount(), 4);
+    ASSERT_EQ(mapped.timings(), reader.timings());
+    ASSERT_EQ(mapped.groupOfPacket(0), 0);
+    ASSERT_EQ(mapped.groupOfPacket(349), 3);
+    ASSERT_EQ(mapped.groupOfPacket(350), -1);
+    ASSERT_EQ(mapped.packetCountOfGroup(3), 50);
+
+    MappedLogFileReader::Decoder decoder(mapped);
+    for (int i : {0, 1, 99, 100, 249, 137, 349}) {
+        const Status status = decoder.readStatus(i);
+        ASSERT_FALSE(status.isNull());
+        ASSERT_EQ(status->time(), reader.readStatus(i)->time());
+    }
+    ASSERT_TRUE(decoder.readStatus(350).isNull());
+
+    SeqLogFileReader seqReader;
+    ASSERT_TRUE(seqReader.open(filename));
+    ASSERT_EQ(LogFileHasher::hash(mapped), LogFileHasher::hash(seqReader));
+}
+
+TEST(MappedLogFileReader, ConcurrentDecoding) {
+    DeleteMappedLog del;
+    writeMappedTestLog(1000);
+
+    MappedLogFileReader mapped;
+    ASSERT_TRUE(mapped.open(filename));
+
+    std::atomic<int> nextGroup(0);
+    std::atomic<int> errors(0);
+    std::atomic<int> decoded(0);
+    auto worker = [&]() {
+        MappedLogFileReader::Decoder decoder(mapped);
+        QList<Status> statuses;
+        for (int group = nextGroup++; group < mapped.groupCount(); group = nextGroup++) {
+            if (!decoder.readGroup(group, statuses)) {
+                errors++;
+                continue;
+            }
+            for (int i = 0;i<statuses.size();i++) {
+                const int packet = mapped.firstPacketOfGroup(group) + i;
+                if (statuses[i].isNull() || statuses[i]->time() != mapped.timings()[packet]) {
+                    errors++;
+                }
+                decoded++;
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 0;i<4;i++) {
+        threads.emplace_back(worker);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(errors, 0);
+    ASSERT_EQ(decoded, 1000);
+}
+
+TEST(MappedLogFileReader, TruncatedLog) {
+    DeleteMappedLog del;
+    writeMappedTestLog(250);
+
+    QFile file(filename);
+    ASSERT_TRUE(file.resize(file.size() - 10));
+
+    // the incomplete last group is skipped
+    MappedLogFileReader mapped;
+    ASSERT_TRUE(mapped.open(filename));
+    ASSERT_EQ(mapped.packetCount(), 200);
+    MappedLogFileReader::Decoder decoder(mapped);
+    ASSERT_EQ(decoder.readStatus(199)->time(), 1199);
+}
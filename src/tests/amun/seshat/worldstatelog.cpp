@@ -0,0 +1,115 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "seshat/worldstatelog.h"
+
+#include <QFile>
+
+static Status worldStatus(int frame)
+{
+    Status status(new amun::Status);
+    status->set_time(1000 + frame);
+    world::State *state = status->mutable_world_state();
+    state->set_time(1000 + frame);
+    if (frame % 3 != 0) {
+        world::Ball *ball = state->mutable_ball();
+        ball->set_p_x(frame * 0.01f);
+        ball->set_p_y(-1);
+        ball->set_v_x(2);
+        ball->set_v_y(frame * 0.1f);
+    }
+    for (int i = 0;i<frame % 4;i++) {
+        world::Robot *robot = state->add_yellow();
+        robot->set_id(i);
+        robot->set_p_x(i);
+        robot->set_p_y(frame);
+        robot->set_phi(0.5f);
+        robot->set_v_x(0);
+        robot->set_v_y(0);
+        robot->set_omega(i * 0.25f);
+    }
+    world::Robot *robot = state->add_blue();
+    robot->set_id(7);
+    robot->set_p_x(frame);
+    robot->set_p_y(0);
+    robot->set_phi(1);
+    robot->set_v_x(1);
+    robot->set_v_y(2);
+    robot->set_omega(3);
+    return status;
+}
+
+TEST(WorldStateLog, RoundTrip) {
+    const QString filename("temp_unittest_worldstatelog.log.world");
+    class DeleteFile {
+    public:
+        DeleteFile(const QString &name) : m_name(name) {}
+        ~DeleteFile() { QFile::remove(m_name); }
+    private:
+        QString m_name;
+    };
+    DeleteFile del(filename);
+
+    const int frames = 2500;
+    WorldStateLogWriter writer;
+    ASSERT_TRUE(writer.open(filename));
+    for (int i = 0;i<frames;i++) {
+        writer.writeStatus(worldStatus(i));
+    }
+    // statuses without world state are ignored
+    Status other(new amun::Status);
+    other->set_time(5000);
+    writer.writeStatus(other);
+    writer.close();
+
+    WorldStateLogReader reader;
+    ASSERT_TRUE(reader.open(filename)) << reader.errorMsg().toStdString();
+    ASSERT_EQ(reader.chunkCount(), 3);
+    ASSERT_EQ(reader.chunkStartTime(1), 2000);
+    ASSERT_EQ(reader.chunkEndTime(2), 1000 + frames - 1);
+
+    WorldStateColumns columns;
+    ASSERT_TRUE(reader.readAll(columns));
+    ASSERT_EQ(columns.frameCount(), frames);
+
+    WorldStateColumns expected;
+    for (int i = 0;i<frames;i++) {
+        expected.addState(worldStatus(i)->world_state());
+    }
+    ASSERT_EQ(columns.time, expected.time);
+    ASSERT_EQ(columns.ball.valid, expected.ball.valid);
+    ASSERT_EQ(columns.ball.p_x, expected.ball.p_x);
+    ASSERT_EQ(columns.ball.v_y, expected.ball.v_y);
+    ASSERT_EQ(columns.yellow.firstRobot, expected.yellow.firstRobot);
+    ASSERT_EQ(columns.yellow.robotCount, expected.yellow.robotCount);
+    ASSERT_EQ(columns.yellow.id, expected.yellow.id);
+    ASSERT_EQ(columns.yellow.p_y, expected.yellow.p_y);
+    ASSERT_EQ(columns.yellow.omega, expected.yellow.omega);
+    ASSERT_EQ(columns.blue.firstRobot, expected.blue.firstRobot);
+    ASSERT_EQ(columns.blue.p_x, expected.blue.p_x);
+
+    // frame 1234 has two yellow robots
+    const int first = columns.yellow.firstRobot[1234];
+    ASSERT_EQ(columns.yellow.robotCount[1234], 2);
+    ASSERT_EQ(columns.yellow.id[first + 1], 1u);
+    ASSERT_EQ(columns.yellow.p_y[first + 1], 1234.0f);
+    ASSERT_EQ(columns.ball.valid[1233], 0);
+}
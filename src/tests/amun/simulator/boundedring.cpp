@@ -0,0 +1,82 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "simulator/boundedring.h"
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST(BoundedRing, RejectsWhenFull) {
+    BoundedRing<int> ring(3);
+    ASSERT_EQ(ring.capacity(), 4u);
+    for (int i = 0;i<4;i++) {
+        ASSERT_TRUE(ring.push(int(i)));
+    }
+    ASSERT_FALSE(ring.push(4));
+
+    int value;
+    ASSERT_TRUE(ring.pop(value));
+    ASSERT_EQ(value, 0);
+    // the freed slot can be reused
+    ASSERT_TRUE(ring.push(5));
+    for (int expected : {1, 2, 3, 5}) {
+        ASSERT_TRUE(ring.pop(value));
+        ASSERT_EQ(value, expected);
+    }
+    ASSERT_FALSE(ring.pop(value));
+}
+
+TEST(BoundedRing, KeepsOrderPerProducer) {
+    const int PRODUCERS = 4;
+    const int VALUES = 10000;
+    BoundedRing<std::pair<int, int>> ring(16);
+
+    std::vector<std::thread> producers;
+    for (int p = 0;p<PRODUCERS;p++) {
+        producers.emplace_back([&ring, p] {
+            for (int i = 0;i<VALUES;i++) {
+                while (!ring.push(std::make_pair(p, i))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(PRODUCERS, 0);
+    bool ordered = true;
+    int received = 0;
+    std::pair<int, int> value;
+    while (received < PRODUCERS * VALUES) {
+        if (!ring.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && value.second == next[value.first];
+        next[value.first] = value.second + 1;
+        received++;
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    ASSERT_TRUE(ordered);
+    ASSERT_FALSE(ring.pop(value));
+}
@@ -30,10 +30,13 @@
 #include "protobuf/ssl_wrapper.pb.h"
 #include "visionlog/visionlogwriter.h"
 
+#include <QDataStream>
 #include <QObject>
 #include <QQuaternion>
+#include <QStringList>
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include <cmath>
 
 constexpr const float SHOOT_LINEAR_MAX = 8.0f;
@@ -113,6 +116,10 @@ public:
     }
 
     void loadRobots(int blue, int yellow) {
+        emit test.sendCommand(robotsCommand(blue, yellow));
+    }
+
+    static Command robotsCommand(int blue, int yellow) {
         Command c{new amun::Command};
 
         robot::Specs fourteen;
@@ -156,7 +163,7 @@ public:
         };
         addTeam(teamBlue, blue);
         addTeam(teamYellow, yellow);
-        emit test.sendCommand(c);
+        return c;
     }
 
     SimTester test;
@@ -248,6 +255,34 @@ TEST_F(FastSimulatorTest, VisionRate) {
     ASSERT_GE(test.m_counter, exp_packets * 0.8);
 }
 
+TEST_F(FastSimulatorTest, StopsEarly) {
+    QObject::disconnect(s, &Simulator::sendRealData, &test, &SimTester::handleSimulatorTruthRaw);
+    const qint64 start = t.currentTime();
+    int calls = 0;
+    ASSERT_TRUE(FastSimulator::goWhile(s, &t, start + 1e9, [&calls]() {
+        return ++calls < 10;
+    }));
+    ASSERT_EQ(calls, 10);
+    // the callback is called at the start and every 10 ms
+    ASSERT_EQ(t.currentTime(), start + 90 * 1000 * 1000);
+}
+
+TEST_F(FastSimulatorTest, VisionDelay) {
+    QObject::disconnect(s, &Simulator::sendRealData, &test, &SimTester::handleSimulatorTruthRaw);
+    int packets = 0;
+    test.handleDetectionWrapper = [this, &packets](const SSL_WrapperPacket &wrapper, qint64 time) {
+        ASSERT_TRUE(wrapper.has_detection());
+        // the packets are received exactly at the time they claim to be sent
+        ASSERT_EQ(time, std::llround(wrapper.detection().t_sent() * 1E9));
+        // and delivered in the first simulation step after that
+        ASSERT_LE(time, t.currentTime());
+        ASSERT_GT(time + 5 * 1000 * 1000, t.currentTime());
+        packets++;
+    };
+    FastSimulator::goDelta(s, &t, 1e8);
+    ASSERT_GT(packets, 0);
+}
+
 TEST_F(FastSimulatorTest, OriginString) {
     QObject::disconnect(s, &Simulator::sendRealData, &test, &SimTester::handleSimulatorTruthRaw);
     FastSimulator::goDelta(s, &t, 5e8); // 500 millisecond
@@ -766,6 +801,8 @@ TEST_F(FastSimulatorTest, TeleportRobotAfterMove) {
 
     // send same teleport command as above again
     emit this->test.sendCommand(teleportCommand);
+    // wait for the vision delay
+    FastSimulator::goDelta(s, &t, 5e7);
 
     test.handleSimulatorTruth = [&desiredPos] (auto truth) {
         ASSERT_EQ(truth.blue_robots_size(), 1);
@@ -777,6 +814,459 @@ TEST_F(FastSimulatorTest, TeleportRobotAfterMove) {
     FastSimulator::goDelta(s, &t, 1e8); // 100 millisecond
 }
 
+TEST_F(FastSimulatorTest, SnapshotRestore) {
+    loadRobots(2, 2);
+
+    // some realism to make the result depend on the random generators
+    Command realismCommand(new amun::Command);
+    auto realism = realismCommand->mutable_simulator()->mutable_realism_config();
+    realism->set_stddev_ball_p(0.01);
+    realism->set_stddev_robot_p(0.01);
+    realism->set_missing_ball_detections(0.1);
+    realism->set_command_delay(5 * 1000 * 1000);
+    emit this->test.sendCommand(realismCommand);
+
+    SSLSimRobotControl control{new sslsim::RobotControl};
+    auto* cmd = control->add_robot_commands();
+    cmd->set_id(0);
+    cmd->set_dribbler_speed(1000);
+    auto* localVel = cmd->mutable_move_command()->mutable_local_velocity();
+    localVel->set_forward(1);
+    localVel->set_left(0.5);
+    localVel->set_angular(1);
+    auto callback = [&control, this]() {
+        emit this->test.sendSSLRadioCommand(control, true, 0);
+        emit this->test.sendSSLRadioCommand(control, false, 0);
+    };
+    FastSimulator::goDeltaCallback(s, &t, 5e8, callback);
+
+    const QByteArray snapshot = s->snapshot();
+    const qint64 snapshotTime = t.currentTime();
+    ASSERT_EQ(s->time(), snapshotTime);
+
+    QList<world::SimulatorState> truths;
+    QStringList packets;
+    test.handleSimulatorTruth = [&truths](const world::SimulatorState &truth) {
+        truths.append(truth);
+    };
+    test.handleDetectionWrapper = [&packets](const SSL_WrapperPacket &wrapper, qint64) {
+        packets.append(QString::fromStdString(wrapper.DebugString()));
+    };
+    FastSimulator::goDeltaCallback(s, &t, 5e8, callback);
+    ASSERT_GT(truths.size(), 0);
+    ASSERT_GT(packets.size(), 0);
+    const QList<world::SimulatorState> uninterruptedTruths = truths;
+
+    // every branch started from the snapshot must continue identically
+    QList<world::SimulatorState> firstTruths;
+    QStringList firstPackets;
+    for (int branch = 0; branch < 2; branch++) {
+        ASSERT_TRUE(s->restore(snapshot));
+        ASSERT_EQ(s->time(), snapshotTime);
+        ASSERT_EQ(s->snapshot(), snapshot);
+        t.setTime(s->time(), 0);
+
+        truths.clear();
+        packets.clear();
+        FastSimulator::goDeltaCallback(s, &t, 5e8, callback);
+        if (branch == 0) {
+            firstTruths = truths;
+            firstPackets = packets;
+        } else {
+            ASSERT_EQ(truths.size(), firstTruths.size());
+            for (int i = 0; i < truths.size(); i++) {
+                ASSERT_EQ(truths[i].SerializeAsString(), firstTruths[i].SerializeAsString());
+            }
+            ASSERT_EQ(packets, firstPackets);
+        }
+    }
+
+    // the contact caches of the bullet solver are not part of the snapshot,
+    // so the restored run only follows the uninterrupted run closely
+    ASSERT_EQ(firstTruths.size(), uninterruptedTruths.size());
+    for (int i = 0; i < firstTruths.size(); i++) {
+        const world::SimulatorState &restored = firstTruths[i];
+        const world::SimulatorState &original = uninterruptedTruths[i];
+        ASSERT_EQ(restored.time(), original.time());
+        ASSERT_NEAR(restored.ball().p_x(), original.ball().p_x(), 1e-2);
+        ASSERT_NEAR(restored.ball().p_y(), original.ball().p_y(), 1e-2);
+        ASSERT_EQ(restored.blue_robots_size(), original.blue_robots_size());
+        for (int r = 0; r < restored.blue_robots_size(); r++) {
+            ASSERT_EQ(restored.blue_robots(r).id(), original.blue_robots(r).id());
+            ASSERT_NEAR(restored.blue_robots(r).p_x(), original.blue_robots(r).p_x(), 1e-2);
+            ASSERT_NEAR(restored.blue_robots(r).p_y(), original.blue_robots(r).p_y(), 1e-2);
+        }
+        ASSERT_EQ(restored.yellow_robots_size(), original.yellow_robots_size());
+        for (int r = 0; r < restored.yellow_robots_size(); r++) {
+            ASSERT_EQ(restored.yellow_robots(r).id(), original.yellow_robots(r).id());
+            ASSERT_NEAR(restored.yellow_robots(r).p_x(), original.yellow_robots(r).p_x(), 1e-2);
+            ASSERT_NEAR(restored.yellow_robots(r).p_y(), original.yellow_robots(r).p_y(), 1e-2);
+        }
+    }
+
+    // damaged snapshots are rejected without modifying the simulator
+    const QByteArray current = s->snapshot();
+    ASSERT_FALSE(s->restore(QByteArray()));
+    ASSERT_FALSE(s->restore(snapshot.left(snapshot.size() - 1)));
+    ASSERT_FALSE(s->restore(snapshot.left(snapshot.size() / 2)));
+    ASSERT_FALSE(s->restore(snapshot + QByteArray(1, 0)));
+    ASSERT_EQ(s->snapshot(), current);
+}
+
+TEST_F(FastSimulatorTest, SnapshotRestoreKinematic) {
+    // without the bullet solver the restored run must match the uninterrupted run exactly
+    amun::SimulatorSetup setup;
+    loadConfiguration("cpptests/simulator-2020", &setup, false);
+    setup.set_fidelity(amun::SimulatorSetup::KINEMATIC);
+    createSimulator(setup);
+    loadRobots(2, 2);
+
+    Command realismCommand(new amun::Command);
+    auto realism = realismCommand->mutable_simulator()->mutable_realism_config();
+    realism->set_stddev_ball_p(0.01);
+    realism->set_stddev_robot_p(0.01);
+    realism->set_missing_ball_detections(0.1);
+    realism->set_command_delay(5 * 1000 * 1000);
+    emit this->test.sendCommand(realismCommand);
+
+    SSLSimRobotControl control{new sslsim::RobotControl};
+    auto* cmd = control->add_robot_commands();
+    cmd->set_id(0);
+    auto* localVel = cmd->mutable_move_command()->mutable_local_velocity();
+    localVel->set_forward(1);
+    localVel->set_left(0.5);
+    localVel->set_angular(1);
+    auto callback = [&control, this]() {
+        emit this->test.sendSSLRadioCommand(control, true, 0);
+        emit this->test.sendSSLRadioCommand(control, false, 0);
+    };
+    FastSimulator::goDeltaCallback(s, &t, 5e8, callback);
+
+    const QByteArray snapshot = s->snapshot();
+    QStringList truths;
+    QStringList packets;
+    test.handleSimulatorTruth = [&truths](const world::SimulatorState &truth) {
+        truths.append(QString::fromStdString(truth.DebugString()));
+    };
+    test.handleDetectionWrapper = [&packets](const SSL_WrapperPacket &wrapper, qint64) {
+        packets.append(QString::fromStdString(wrapper.DebugString()));
+    };
+    FastSimulator::goDeltaCallback(s, &t, 5e8, callback);
+    ASSERT_GT(truths.size(), 0);
+    ASSERT_GT(packets.size(), 0);
+    const QStringList uninterruptedTruths = truths;
+    const QStringList uninterruptedPackets = packets;
+
+    ASSERT_TRUE(s->restore(snapshot));
+    t.setTime(s->time(), 0);
+    truths.clear();
+    packets.clear();
+    FastSimulator::goDeltaCallback(s, &t, 5e8, callback);
+    ASSERT_EQ(truths, uninterruptedTruths);
+    ASSERT_EQ(packets, uninterruptedPackets);
+}
+
+TEST_F(FastSimulatorTest, DeterministicRuns) {
+    // records everything the simulator sends, runs with the same seed must match bit by bit
+    auto runScenario = [this](uint32_t seed) {
+        amun::SimulatorSetup setup;
+        loadConfiguration("cpptests/simulator-2020", &setup, false);
+        createSimulator(setup);
+        s->setDeterministic(seed);
+        loadRobots(2, 2);
+
+        Command realismCommand(new amun::Command);
+        auto realism = realismCommand->mutable_simulator()->mutable_realism_config();
+        realism->set_stddev_ball_p(0.01);
+        realism->set_stddev_robot_p(0.01);
+        realism->set_stddev_robot_phi(0.01);
+        realism->set_missing_ball_detections(0.1);
+        realism->set_robot_command_loss(0.1);
+        realism->set_robot_response_loss(0.1);
+        realism->set_command_delay(5 * 1000 * 1000);
+        emit this->test.sendCommand(realismCommand);
+
+        QByteArray log;
+        QDataStream stream(&log, QIODevice::WriteOnly);
+        QObject::connect(s, &Simulator::gotPacket, [&stream](const QByteArray &data, qint64 time, QString) {
+            stream << data << time;
+        });
+        QObject::connect(s, &Simulator::sendRealData, [&stream](const QByteArray &data) {
+            stream << data;
+        });
+        QObject::connect(s, &Simulator::sendRadioResponses, [&stream](const QList<robot::RadioResponse> &responses) {
+            for (const robot::RadioResponse &response : responses) {
+                stream << QByteArray::fromStdString(response.SerializeAsString());
+            }
+        });
+        QObject::connect(s, &Simulator::sendStatus, [&stream](const Status &status) {
+            stream << QByteArray::fromStdString(status->SerializeAsString());
+        });
+
+        SSLSimRobotControl control{new sslsim::RobotControl};
+        auto* cmd = control->add_robot_commands();
+        cmd->set_id(1);
+        cmd->set_dribbler_speed(1000);
+        auto* localVel = cmd->mutable_move_command()->mutable_local_velocity();
+        localVel->set_forward(1);
+        localVel->set_left(0.5);
+        localVel->set_angular(1);
+        auto callback = [&control, this]() {
+            // both teams use the same processing start, the order must not matter
+            emit this->test.sendSSLRadioCommand(control, false, t.currentTime());
+            emit this->test.sendSSLRadioCommand(control, true, t.currentTime());
+        };
+        FastSimulator::goDeltaCallback(s, &t, 1e9, callback);
+        return log;
+    };
+
+    const QByteArray firstRun = runScenario(4711);
+    ASSERT_GT(firstRun.size(), 0);
+    ASSERT_EQ(runScenario(4711), firstRun);
+    // the random generators must actually influence the result
+    ASSERT_NE(runScenario(4712), firstRun);
+}
+
+TEST_F(FastSimulatorTest, MultipleInstancesAreIsolated) {
+    // the simulator-cli hosts several simulations in one process, they must not influence each other
+    auto runScenario = [this](bool withOther) {
+        amun::SimulatorSetup setup;
+        loadConfiguration("cpptests/simulator-2020", &setup, false);
+        createSimulator(setup);
+        s->setDeterministic(4711);
+        loadRobots(2, 2);
+
+        Command realismCommand(new amun::Command);
+        auto realism = realismCommand->mutable_simulator()->mutable_realism_config();
+        realism->set_stddev_ball_p(0.01);
+        realism->set_stddev_robot_p(0.01);
+        realism->set_missing_ball_detections(0.1);
+        realism->set_robot_command_loss(0.1);
+        emit this->test.sendCommand(realismCommand);
+
+        QByteArray log;
+        QDataStream stream(&log, QIODevice::WriteOnly);
+        QObject::connect(s, &Simulator::gotPacket, [&stream](const QByteArray &data, qint64 time, QString) {
+            stream << data << time;
+        });
+        QObject::connect(s, &Simulator::sendRealData, [&stream](const QByteArray &data) {
+            stream << data;
+        });
+
+        // a second simulation with a different seed, other commands and its own timer
+        Timer otherTimer;
+        otherTimer.setScaling(0);
+        otherTimer.setTime(1234, 0);
+        Simulator other{&otherTimer, setup, true};
+        other.setDeterministic(42);
+        Command enableCommand{new amun::Command};
+        enableCommand->mutable_simulator()->set_enable(true);
+        other.handleCommand(enableCommand);
+        other.handleCommand(robotsCommand(2, 2));
+        other.handleCommand(realismCommand);
+
+        SSLSimRobotControl control{new sslsim::RobotControl};
+        auto* cmd = control->add_robot_commands();
+        cmd->set_id(1);
+        auto* localVel = cmd->mutable_move_command()->mutable_local_velocity();
+        localVel->set_forward(1);
+        localVel->set_left(0.5);
+        localVel->set_angular(1);
+
+        SSLSimRobotControl otherControl{new sslsim::RobotControl};
+        auto* otherCmd = otherControl->add_robot_commands();
+        otherCmd->set_id(1);
+        otherCmd->set_kick_speed(3);
+        auto* otherVel = otherCmd->mutable_move_command()->mutable_local_velocity();
+        otherVel->set_forward(-1);
+        otherVel->set_left(0);
+        otherVel->set_angular(-2);
+
+        auto callback = [&, this]() {
+            emit this->test.sendSSLRadioCommand(control, true, t.currentTime());
+            if (withOther) {
+                other.handleRadioCommands(otherControl, true, otherTimer.currentTime());
+                other.handleRadioCommands(otherControl, false, otherTimer.currentTime());
+                FastSimulator::goDelta(&other, &otherTimer, 1e7);
+            }
+        };
+        FastSimulator::goDeltaCallback(s, &t, 1e9, callback);
+        return log;
+    };
+
+    const QByteArray alone = runScenario(false);
+    ASSERT_GT(alone.size(), 0);
+    ASSERT_EQ(runScenario(true), alone);
+}
+
+TEST_F(FastSimulatorTest, DroppedRadioCommandsAreReported) {
+    QStringList blueErrors;
+    QObject::connect(s, &Simulator::sendSSLSimError, [&blueErrors](const QList<SSLSimError> &errors, ErrorSource source) {
+        for (const SSLSimError &error : errors) {
+            if (source == ErrorSource::BLUE) {
+                blueErrors.append(QString::fromStdString(error->code()));
+            }
+        }
+    });
+
+    // more commands than the ring can hold without a simulator tick in between
+    SSLSimRobotControl control{new sslsim::RobotControl};
+    const int capacity = RadioCommandRing().capacity();
+    for (int i = 0; i < capacity + 10; i++) {
+        emit test.sendSSLRadioCommand(control, true, t.currentTime());
+    }
+    FastSimulator::goDelta(s, &t, 1e7);
+    ASSERT_EQ(s->radioCommandStatistics().receivedCommands, capacity);
+    ASSERT_EQ(s->radioCommandStatistics().droppedCommands, 10);
+    ASSERT_EQ(blueErrors.count("RADIO_COMMANDS_DROPPED"), 1);
+
+    // the drops are only reported once
+    FastSimulator::goDelta(s, &t, 1e7);
+    ASSERT_EQ(blueErrors.count("RADIO_COMMANDS_DROPPED"), 1);
+}
+
+TEST_F(FastSimulatorTest, RadioCommandRingOutlivesSimulator) {
+    // the simulator-cli keeps the ring while a simulator is replaced
+    auto ring = std::make_shared<RadioCommandRing>(4);
+    amun::SimulatorSetup setup;
+    loadConfiguration("cpptests/simulator-2020", &setup, false);
+    SSLSimRobotControl control{new sslsim::RobotControl};
+
+    std::unique_ptr<Simulator> first(new Simulator(&t, setup, true, ring));
+    for (int i = 0; i < 6; i++) {
+        ring->push(control, i % 2 == 0, t.currentTime());
+    }
+    ASSERT_EQ(first->radioCommandStatistics().droppedCommands, 2);
+    first.reset();
+    // the producers may still push while no simulator exists
+    ASSERT_FALSE(ring->push(control, true, t.currentTime()));
+
+    Simulator second(&t, setup, true, ring);
+    QStringList errors;
+    QObject::connect(&second, &Simulator::sendSSLSimError, [&errors](const QList<SSLSimError> &simErrors, ErrorSource) {
+        for (const SSLSimError &error : simErrors) {
+            errors.append(QString::fromStdString(error->code()));
+        }
+    });
+    Command enableCommand{new amun::Command};
+    enableCommand->mutable_simulator()->set_enable(true);
+    second.handleCommand(enableCommand);
+
+    // the pending commands are taken over, the drops before the replacement are not reported again
+    FastSimulator::goDelta(&second, &t, 1e7);
+    ASSERT_EQ(second.radioCommandStatistics().receivedCommands, 4);
+    ASSERT_EQ(errors.count("RADIO_COMMANDS_DROPPED"), 0);
+
+    for (int i = 0; i < 5; i++) {
+        ring->push(control, true, t.currentTime());
+    }
+    FastSimulator::goDelta(&second, &t, 1e7);
+    ASSERT_EQ(second.radioCommandStatistics().receivedCommands, 8);
+    ASSERT_EQ(errors.count("RADIO_COMMANDS_DROPPED"), 1);
+}
+
+TEST_F(FastSimulatorTest, FastFidelity) {
+    amun::SimulatorSetup setup;
+    loadConfiguration("cpptests/simulator-2020", &setup, false);
+    setup.set_fidelity(amun::SimulatorSetup::FAST);
+    createSimulator(setup);
+    loadRobots(1, 0);
+
+    // the coarser physics must still keep resting objects in place
+    bool init = false;
+    float rx = 0, ry = 0, bx = 0, by = 0;
+    test.handleSimulatorTruth = [&](const world::SimulatorState &truth) {
+        ASSERT_EQ(truth.blue_robots_size(), 1);
+        ASSERT_TRUE(truth.has_ball());
+        if (!init) {
+            rx = truth.blue_robots(0).p_x();
+            ry = truth.blue_robots(0).p_y();
+            bx = truth.ball().p_x();
+            by = truth.ball().p_y();
+            init = true;
+        } else {
+            ASSERT_LE(std::abs(truth.blue_robots(0).p_x() - rx), 1e-2);
+            ASSERT_LE(std::abs(truth.blue_robots(0).p_y() - ry), 1e-2);
+            ASSERT_LE(std::abs(truth.ball().p_x() - bx), 1e-2);
+            ASSERT_LE(std::abs(truth.ball().p_y() - by), 1e-2);
+        }
+    };
+    FastSimulator::goDelta(s, &t, 1e9);
+
+    SSLSimRobotControl control{new sslsim::RobotControl};
+    auto* cmd = control->add_robot_commands();
+    cmd->set_id(0);
+    cmd->mutable_move_command()->mutable_local_velocity()->set_forward(-1);
+    cmd->mutable_move_command()->mutable_local_velocity()->set_left(0);
+    cmd->mutable_move_command()->mutable_local_velocity()->set_angular(0);
+    auto callback = [&control, this]() {
+        emit this->test.sendSSLRadioCommand(control, true, 0);
+    };
+    test.handleSimulatorTruth = [](const world::SimulatorState &) {};
+    FastSimulator::goDeltaCallback(s, &t, 5e8, callback);
+
+    // and the robot controller must still reach the commanded speed
+    int checked = 0;
+    test.handleSimulatorTruth = [&checked](const world::SimulatorState &truth) {
+        ASSERT_EQ(truth.blue_robots_size(), 1);
+        const world::SimRobot &robot = truth.blue_robots(0);
+        ASSERT_NEAR(std::sqrt(robot.v_x() * robot.v_x() + robot.v_y() * robot.v_y()), 1, 5e-2);
+        checked++;
+    };
+    FastSimulator::goDeltaCallback(s, &t, 5e8, callback);
+    ASSERT_GT(checked, 0);
+}
+
+TEST_F(FastSimulatorTest, KinematicFidelity) {
+    amun::SimulatorSetup setup;
+    loadConfiguration("cpptests/simulator-2020", &setup, false);
+    setup.set_fidelity(amun::SimulatorSetup::KINEMATIC);
+    createSimulator(setup);
+    loadRobots(1, 0);
+    FastSimulator::goDelta(s, &t, 1e8);
+
+    // the rolling ball must follow the published straight_two_phase model
+    const float BALL_SPEED = 2;
+    Command command{new amun::Command};
+    sslsim::TeleportBall* teleport = command->mutable_simulator()->mutable_ssl_control()->mutable_teleport_ball();
+    coordinates::toVision(Vector(0, 0), *teleport);
+    teleport->set_z(0);
+    coordinates::toVisionVelocity(Vector(0, BALL_SPEED), *teleport);
+    teleport->set_vz(0);
+    emit test.sendCommand(command);
+
+    SSLSimRobotControl control{new sslsim::RobotControl};
+    auto* cmd = control->add_robot_commands();
+    cmd->set_id(0);
+    cmd->mutable_move_command()->mutable_local_velocity()->set_forward(-1);
+    cmd->mutable_move_command()->mutable_local_velocity()->set_left(0);
+    cmd->mutable_move_command()->mutable_local_velocity()->set_angular(0);
+    auto callback = [&control, this]() {
+        emit this->test.sendSSLRadioCommand(control, true, 0);
+    };
+
+    float robotSpeed = 0;
+    world::SimBall ball;
+    test.handleSimulatorTruth = [&robotSpeed, &ball](const world::SimulatorState &truth) {
+        ASSERT_EQ(truth.blue_robots_size(), 1);
+        const world::SimRobot &robot = truth.blue_robots(0);
+        robotSpeed = std::sqrt(robot.v_x() * robot.v_x() + robot.v_y() * robot.v_y());
+        ball = truth.ball();
+    };
+    FastSimulator::goDeltaCallback(s, &t, 1e9, callback);
+    // the robot controller reaches the commanded speed
+    ASSERT_NEAR(robotSpeed, 1, 1e-2);
+
+    FastSimulator::goDelta(s, &t, 4e9);
+    const float switchSpeed = BALL_SPEED * 0.69f;
+    const float slideDistance = (BALL_SPEED * BALL_SPEED - switchSpeed * switchSpeed) / (2 * 3.9f);
+    const float rollDistance = switchSpeed * switchSpeed / (2 * 0.35f);
+    ASSERT_EQ(ball.v_x(), 0);
+    ASSERT_EQ(ball.v_y(), 0);
+    ASSERT_NEAR(ball.p_x(), 0, 1e-3);
+    ASSERT_NEAR(ball.p_y(), slideDistance + rollDistance, 2e-2);
+}
+
 TEST_F(FastSimulatorTest, GeometryReflection) {
     amun::SimulatorSetup setup;
     setup.add_camera_setup()->CopyFrom(createDefaultCamera(2, 5, 3.3, 5));
@@ -867,6 +1357,9 @@ TEST_F(FastSimulatorTest, InvisibleBall) {
         teleportBall->set_vy(0);
         emit this->test.sendCommand(command);
     }
+    // skip the packets from before the teleport, which are still delayed
+    test.handleDetectionWrapper = [] (auto, auto) {};
+    FastSimulator::goDelta(s, &t, 5e7);
     test.handleDetectionWrapper = [] (auto wrapper, auto) {
         if (!wrapper.has_detection()) {
             return;
@@ -902,8 +1395,9 @@ TEST_F(FastSimulatorTest, CameraOverlap) {
         teleportBall->set_vy(0);
         emit this->test.sendCommand(command);
 
+        // longer than the vision delay
         this->test.handleDetectionWrapper = [](auto, auto){};
-        FastSimulator::goDelta(s, &t, 3e7);
+        FastSimulator::goDelta(s, &t, 5e7);
 
         std::set<int> foundCameras;
         this->test.handleDetectionWrapper = [&foundCameras] (auto wrapper, auto) {
@@ -939,6 +1433,15 @@ TEST_F(FastSimulatorTest, CameraOverlap) {
     checkCameras(Vector(2, 0.49), {0, 2});
     checkCameras(Vector(2, -0.51), {2});
     checkCameras(Vector(2, -0.49), {0, 2});
+
+    // the camera assignment must follow overlap changes
+    Command overlapCommand(new amun::Command);
+    overlapCommand->mutable_simulator()->mutable_realism_config()->set_camera_overlap(0.1f);
+    emit this->test.sendCommand(overlapCommand);
+
+    checkCameras(Vector(2, 0.49), {0});
+    checkCameras(Vector(2, 0.05), {0, 2});
+    checkCameras(Vector(30, -30), {2});
 }
 
 TEST_F(ShootTest, ShootSpeed) {
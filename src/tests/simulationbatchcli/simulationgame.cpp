@@ -0,0 +1,146 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "simulationgame.h"
+#include "config/config.h"
+#include "seshat/logfilereader.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+static SimulationScenario scenario(const QString &line)
+{
+    SimulationScenario defaults;
+    defaults.blueStrategy = QString::fromStdString(ERFORCE_STRATEGYDIR) + "lua/demo/init.lua";
+    defaults.blueEntryPoint = "Demo";
+    defaults.robotCount = 2;
+    defaults.robotGeneration = "generation_2020";
+    defaults.duration = 2;
+
+    SimulationScenario result;
+    QString error;
+    EXPECT_TRUE(SimulationScenario::parse(line, defaults, result, error)) << error.toStdString();
+    return result;
+}
+
+TEST(SimulationGame, ParsesScenarios) {
+    const SimulationScenario parsed = scenario("kick seed=7 duration=5 fidelity=kinematic robots=3");
+    ASSERT_EQ(parsed.name, "kick");
+    ASSERT_EQ(parsed.seed, 7u);
+    ASSERT_EQ(parsed.duration, 5);
+    ASSERT_EQ(parsed.fidelity, "kinematic");
+    ASSERT_EQ(parsed.robotCount, 3);
+    ASSERT_EQ(parsed.blueEntryPoint, "Demo");
+
+    SimulationScenario invalid;
+    QString error;
+    ASSERT_FALSE(SimulationScenario::parse("game fidelity=exact", scenario("defaults"), invalid, error));
+    ASSERT_FALSE(SimulationScenario::parse("game duration=0", scenario("defaults"), invalid, error));
+    ASSERT_FALSE(SimulationScenario::parse("game unknown=1", scenario("defaults"), invalid, error));
+    ASSERT_FALSE(SimulationScenario::parse("seed=1", scenario("defaults"), invalid, error));
+}
+
+TEST(SimulationGame, RunsSeededGames) {
+    int argc = 1;
+    char name[] = "cpptests";
+    char *argv[] = {name, nullptr};
+    QCoreApplication app(argc, argv);
+
+    QTemporaryDir directory;
+    ASSERT_TRUE(directory.isValid());
+
+    const std::vector<SimulationScenario> scenarios = {
+        scenario("accurate-game seed=7"),
+        scenario("fast-game seed=7 fidelity=fast"),
+        scenario("kinematic-game seed=7 fidelity=kinematic")
+    };
+    const std::vector<SimulationResult> results = SimulationGame::runParallel(scenarios, directory.path(), 2);
+    ASSERT_EQ(results.size(), scenarios.size());
+
+    const int columns = SimulationResult::csvHeader().split(',').size();
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const SimulationResult &result = results[i];
+        // the results keep the order of the scenarios
+        ASSERT_EQ(result.name, scenarios[i].name);
+        ASSERT_TRUE(result.success) << result.errorMsg.toStdString();
+        ASSERT_EQ(result.seed, 7u);
+        ASSERT_EQ(result.fidelity, scenarios[i].fidelity);
+        ASSERT_TRUE(result.failedStrategy.isEmpty()) << result.failedStrategy.toStdString();
+        ASSERT_GE(result.simulatedTime, 2 * 1000 * 1000 * 1000LL);
+        ASSERT_GT(result.wallTime, 0);
+
+        ASSERT_EQ(result.logFile, QDir(directory.path()).filePath(scenarios[i].name + ".log"));
+        LogFileReader log;
+        ASSERT_TRUE(log.open(result.logFile)) << log.errorMsg().toStdString();
+        ASSERT_GT(log.packetCount(), 0);
+
+        const QString csv = result.toCsv();
+        ASSERT_EQ(csv.split(',').size(), columns);
+        ASSERT_TRUE(csv.startsWith(QString("\"%1\",7,\"%2\",1,").arg(scenarios[i].name, scenarios[i].fidelity))) << csv.toStdString();
+    }
+}
+
+TEST(SimulationGame, ReportsSetupErrors) {
+    SimulationScenario invalid = scenario("missing-config simulator-config=does_not_exist");
+    SimulationGame game(invalid, nullptr);
+    const SimulationResult result = game.run(QString());
+    ASSERT_FALSE(result.success);
+    ASSERT_FALSE(result.errorMsg.isEmpty());
+    ASSERT_TRUE(result.toCsv().startsWith("\"missing-config\",0,\"accurate\",0,"));
+}
+
+TEST(SimulationGame, SameSeedWritesIdenticalLogs) {
+    int argc = 1;
+    char name[] = "cpptests";
+    char *argv[] = {name, nullptr};
+    QCoreApplication app(argc, argv);
+
+    QTemporaryDir directory;
+    ASSERT_TRUE(directory.isValid());
+
+    // both games run at the same time on different threads
+    const std::vector<SimulationScenario> scenarios = {
+        scenario("first seed=11 duration=3"),
+        scenario("second seed=11 duration=3")
+    };
+    const std::vector<SimulationResult> results = SimulationGame::runParallel(scenarios, directory.path(), 2);
+    ASSERT_EQ(results.size(), 2u);
+    ASSERT_TRUE(results[0].success) << results[0].errorMsg.toStdString();
+    ASSERT_TRUE(results[1].success) << results[1].errorMsg.toStdString();
+
+    QFile first(results[0].logFile);
+    QFile second(results[1].logFile);
+    ASSERT_TRUE(first.open(QIODevice::ReadOnly));
+    ASSERT_TRUE(second.open(QIODevice::ReadOnly));
+    const QByteArray firstData = first.readAll();
+    ASSERT_GT(firstData.size(), 0);
+    ASSERT_TRUE(firstData == second.readAll());
+
+    LogFileReader log;
+    ASSERT_TRUE(log.open(results[0].logFile));
+    for (int i = 0; i < log.packetCount(); i++) {
+        const Status status = log.readStatus(i);
+        ASSERT_FALSE(status.isNull());
+        ASSERT_FALSE(status->has_timing()) << i;
+    }
+}
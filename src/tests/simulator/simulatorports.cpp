@@ -0,0 +1,66 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "simulatorports.h"
+#include "core/sslprotocols.h"
+
+#include <set>
+
+TEST(SimulatorPorts, FirstInstanceUsesStandardPorts) {
+    const SimulatorPorts ports = simulatorPorts(0, 10);
+    ASSERT_EQ(ports.control, SSL_SIMULATION_CONTROL_PORT);
+    ASSERT_EQ(ports.blue, SSL_SIMULATION_CONTROL_BLUE_PORT);
+    ASSERT_EQ(ports.yellow, SSL_SIMULATION_CONTROL_YELLOW_PORT);
+    ASSERT_EQ(ports.vision, SSL_SIMULATED_VISION_PORT);
+    // the stride does not matter for a single simulation
+    ASSERT_TRUE(checkSimulatorPorts(1, 0).isEmpty());
+}
+
+TEST(SimulatorPorts, InstancesUseDistinctPorts) {
+    const int instanceCount = 28;
+    ASSERT_TRUE(checkSimulatorPorts(instanceCount, 10).isEmpty());
+
+    std::set<int> ports;
+    for (int i = 0; i < instanceCount; i++) {
+        const SimulatorPorts instance = simulatorPorts(i, 10);
+        for (int port : {instance.control, instance.blue, instance.yellow, instance.vision}) {
+            ASSERT_TRUE(ports.insert(port).second);
+        }
+    }
+}
+
+TEST(SimulatorPorts, DetectsCollisions) {
+    // the yellow port of the first simulation is the control port of the second one
+    ASSERT_FALSE(checkSimulatorPorts(2, 2).isEmpty());
+    ASSERT_FALSE(checkSimulatorPorts(2, 0).isEmpty());
+    ASSERT_TRUE(checkSimulatorPorts(2, 3).isEmpty());
+    // the vision port of simulation 28 is the control port of the first simulation
+    ASSERT_FALSE(checkSimulatorPorts(29, 10).isEmpty());
+    // the vision and control ports of different simulations collide for this stride
+    ASSERT_EQ(simulatorPorts(1, 280).vision, simulatorPorts(0, 280).control);
+    ASSERT_FALSE(checkSimulatorPorts(2, 280).isEmpty());
+}
+
+TEST(SimulatorPorts, DetectsInvalidPorts) {
+    ASSERT_TRUE(checkSimulatorPorts(56, 1000).isEmpty());
+    ASSERT_FALSE(checkSimulatorPorts(57, 1000).isEmpty());
+    ASSERT_FALSE(checkSimulatorPorts(2, -10300).isEmpty());
+}
@@ -0,0 +1,182 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "trackingreplayengine.h"
+#include "simulator/fastsimulator.h"
+#include "simulator/simulator.h"
+#include "core/configuration.h"
+#include "core/coordinates.h"
+#include "core/timer.h"
+#include "core/vector.h"
+#include "protobuf/command.h"
+#include "protobuf/ssl_wrapper.pb.h"
+#include "protobuf/status.h"
+#include "seshat/logfilewriter.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+// Writes a log in which the yellow robot shoots a ball that rolls towards it.
+// Every status contains one vision packet, like the logs recorded by the processor.
+static void writeShotLog(const QString &filename, float kickAngle)
+{
+    Timer timer;
+    timer.setScaling(0);
+    timer.setTime(1234, 0);
+
+    amun::SimulatorSetup setup;
+    loadConfiguration("cpptests/simulator-2020", &setup, false);
+    camun::simulator::Simulator simulator(&timer, setup, true);
+    simulator.seedPRGN(14986);
+
+    robot::Generation specs;
+    loadConfiguration("cpptests/robots-generation-2020", &specs, true);
+    Command robotCommand(new amun::Command);
+    auto robot = robotCommand->mutable_set_team_yellow()->add_robot();
+    robot->CopyFrom(specs.default_());
+    robot->set_id(0);
+    simulator.handleCommand(robotCommand);
+
+    Command enableCommand(new amun::Command);
+    enableCommand->mutable_simulator()->set_enable(true);
+    enableCommand->mutable_transceiver()->set_charge(true);
+    RealismConfigErForce realismConfig;
+    loadConfiguration("cpptests/realism-realistic", &realismConfig, false);
+    realismConfig.set_dribbler_ball_detections(0);
+    enableCommand->mutable_simulator()->mutable_realism_config()->CopyFrom(realismConfig);
+    simulator.handleCommand(enableCommand);
+
+    Command teleportCommand(new amun::Command);
+    sslsim::SimulatorControl *control = teleportCommand->mutable_simulator()->mutable_ssl_control();
+    sslsim::TeleportRobot *teleportRobot = control->add_teleport_robot();
+    teleportRobot->mutable_id()->set_id(0);
+    teleportRobot->mutable_id()->set_team(gameController::Team::YELLOW);
+    coordinates::toVision(Vector(0, 0), *teleportRobot);
+    teleportRobot->set_orientation(0);
+    sslsim::TeleportBall *teleportBall = control->mutable_teleport_ball();
+    coordinates::toVision(Vector(0, 0.15), *teleportBall);
+    teleportBall->set_z(0);
+    coordinates::toVisionVelocity(Vector(0, -0.4), *teleportBall);
+    teleportBall->set_vz(0);
+    simulator.handleCommand(teleportCommand);
+
+    LogFileWriter writer;
+    ASSERT_TRUE(writer.open(filename));
+    QObject::connect(&simulator, &camun::simulator::Simulator::gotPacket, [&writer](const QByteArray &data, qint64 time, QString) {
+        SSL_WrapperPacket wrapper;
+        ASSERT_TRUE(wrapper.ParseFromArray(data.data(), data.size()));
+
+        Status status(new amun::Status);
+        status->set_time(time);
+        world::State *worldState = status->mutable_world_state();
+        worldState->set_time(time);
+        worldState->add_vision_frames()->CopyFrom(wrapper);
+        worldState->add_vision_frame_times(time);
+        writer.writeStatus(status);
+    });
+
+    SSLSimRobotControl shot(new sslsim::RobotControl);
+    sslsim::RobotCommand *command = shot->add_robot_commands();
+    command->set_id(0);
+    command->set_kick_speed(4);
+    command->set_kick_angle(kickAngle);
+    FastSimulator::goDeltaCallback(&simulator, &timer, 2e9, [&simulator, &shot]() {
+        simulator.handleRadioCommands(shot, false, 0);
+    });
+    writer.close();
+}
+
+static bool sameTrackingResult(const TrackingReplayStatistics &a, const TrackingReplayStatistics &b)
+{
+    return a.logFile == b.logFile && a.success == b.success && a.statusCount == b.statusCount
+            && a.visionFrameCount == b.visionFrameCount && a.trackingFrameCount == b.trackingFrameCount
+            && a.flightDetections == b.flightDetections && a.maxBallFilters == b.maxBallFilters
+            && a.maxRobotFilters == b.maxRobotFilters && a.averageBallFilters == b.averageBallFilters
+            && a.averageRobotFilters == b.averageRobotFilters;
+}
+
+TEST(TrackingReplayEngine, ReplaysShots) {
+    QTemporaryDir directory;
+    ASSERT_TRUE(directory.isValid());
+    const QString chipLog = directory.filePath("chip.log");
+    const QString flatLog = directory.filePath("flat.log");
+    writeShotLog(chipLog, 45);
+    writeShotLog(flatLog, 0);
+
+    world::BallModel ballModel;
+    loadConfiguration("cpptests/ballmodel", &ballModel, false);
+    TrackingReplayEngine engine(ballModel, false);
+
+    const TrackingReplayStatistics chip = engine.run(chipLog);
+    ASSERT_TRUE(chip.success);
+    ASSERT_EQ(chip.errorMsg, QString());
+    // every status contains a world state, but not every vision packet a detection
+    ASSERT_EQ(chip.trackingFrameCount, chip.statusCount);
+    ASSERT_GT(chip.visionFrameCount, 0);
+    ASSERT_LE(chip.visionFrameCount, chip.trackingFrameCount);
+    ASSERT_EQ(chip.trackingResets, 0);
+    ASSERT_GE(chip.maxBallFilters, 1);
+    ASSERT_GE(chip.maxRobotFilters, 1);
+    ASSERT_GE(chip.flightDetections, 1);
+
+    const TrackingReplayStatistics flat = engine.run(flatLog);
+    ASSERT_TRUE(flat.success);
+    ASSERT_GE(flat.maxBallFilters, 1);
+    ASSERT_EQ(flat.flightDetections, 0);
+
+    // the parallel replay returns the same results in the order of the files
+    const QStringList files = TrackingReplayEngine::collectLogFiles({directory.path()});
+    ASSERT_EQ(files, QStringList({chipLog, flatLog}));
+    const std::vector<TrackingReplayStatistics> results = TrackingReplayEngine::runParallel(files, ballModel, false, 2);
+    ASSERT_EQ(results.size(), std::size_t(2));
+    ASSERT_TRUE(sameTrackingResult(results[0], chip));
+    ASSERT_TRUE(sameTrackingResult(results[1], flat));
+}
+
+TEST(TrackingReplayEngine, MissingLog) {
+    world::BallModel ballModel;
+    TrackingReplayEngine engine(ballModel, false);
+    const TrackingReplayStatistics stats = engine.run("temp_unittest_missing_trackingreplay.log");
+    ASSERT_FALSE(stats.success);
+    ASSERT_FALSE(stats.errorMsg.isEmpty());
+    ASSERT_EQ(stats.trackingFrameCount, 0);
+}
+
+TEST(TrackingReplayEngine, CorruptLog) {
+    QTemporaryDir directory;
+    ASSERT_TRUE(directory.isValid());
+    const QString filename = directory.filePath("corrupt.log");
+    writeShotLog(filename, 0);
+
+    // damage the compressed data in the middle of the log, the replay must stop instead of hanging
+    QFile file(filename);
+    ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+    ASSERT_TRUE(file.seek(file.size() / 2));
+    file.write(QByteArray(16, char(0xff)));
+    file.close();
+
+    world::BallModel ballModel;
+    loadConfiguration("cpptests/ballmodel", &ballModel, false);
+    TrackingReplayEngine engine(ballModel, false);
+    const TrackingReplayStatistics stats = engine.run(filename);
+    ASSERT_FALSE(stats.success);
+    ASSERT_FALSE(stats.errorMsg.isEmpty());
+}
@@ -20,14 +20,13 @@
 
 #include <QCoreApplication>
 #include <QCommandLineParser>
+#include <QThread>
 #include <clocale>
 #include <QtGlobal>
 #include <iostream>
 
-#include "processor/trackingreplay.h"
-#include "protobuf/status.h"
-#include "seshat/logfilereader.h"
-#include "core/timer.h"
+#include "trackingreplayengine.h"
+#include "core/configuration.h"
 
 int main(int argc, char* argv[])
 {
@@ -41,50 +40,50 @@ int main(int argc, char* argv[])
     parser.setApplicationDescription("Command line interface for tracking replay on ER-Force logs");
     parser.addHelpOption();
     parser.addVersionOption();
-    parser.addPositionalArgument("logfile", "Log file to read");
+    parser.addPositionalArgument("logfiles", "Log files or directories containing log files to read", "logfiles...");
 
-//    QCommandLineOption asBlueOption({"b", "as-blue"}, "Run as blue strategy, defaults to yellow");
-//    parser.addOption(asBlueOption);
+    QCommandLineOption jobsOption({"j", "jobs"}, "Number of logs to process in parallel, defaults to the number of cores", "jobs");
+    parser.addOption(jobsOption);
+    QCommandLineOption globalAssignmentOption("global-assignment", "Assign detections to filters with a global nearest neighbour solver");
+    parser.addOption(globalAssignmentOption);
 
     // parse command line
     parser.process(app);
 
-    int argCount = parser.positionalArguments().size();
-    if (argCount != 1) {
+    if (parser.positionalArguments().isEmpty()) {
         parser.showHelp(1);
     }
 
-    qRegisterMetaType<Status>("Status");
-    qRegisterMetaType<Command>("Command");
-
-    Timer timer;
-    timer.setTime(0, 0);
-    TrackingReplay replay(&timer);
+    const QStringList files = TrackingReplayEngine::collectLogFiles(parser.positionalArguments());
+    if (files.isEmpty()) {
+        qFatal("Error: no log files found");
+    }
 
-    bool wasFlying = false;
-    int flyCount = 0;
-    replay.connect(&replay, &TrackingReplay::gotStatus, [&wasFlying, &flyCount](const Status &status) {
-        if (status->has_world_state() && status->world_state().has_ball()) {
-            bool flying = status->world_state().ball().p_z() != 0.0f;
-            if (flying && !wasFlying) {
-                flyCount++;
-            }
-            wasFlying = flying;
+    int jobs = QThread::idealThreadCount();
+    if (parser.isSet(jobsOption)) {
+        bool ok = false;
+        jobs = parser.value(jobsOption).toInt(&ok);
+        if (!ok || jobs <= 0) {
+            qFatal("Error: invalid number of jobs");
         }
-    });
-
-    LogFileReader logfile;
-    const QStringList arguments = parser.positionalArguments();
-    if (!logfile.open(arguments.first())) {
-        qFatal("Error: could not open logfile");
     }
 
-    for (int i = 0;i<logfile.packetCount();i++) {
-        const Status &status = logfile.readStatus(i);
-        replay.handleStatus(status);
-    }
+    // default ball model with the values used in the tracking before the global ball model was used
+    // necessary for correct tracking replay of older logs
+    world::BallModel ballModel;
+    loadConfiguration("field-properties/simulator", &ballModel, false);
+    ballModel.set_slow_deceleration(0.4f);
+    ballModel.set_z_damping(0.55f);
+    ballModel.set_xy_damping(0.7f);
+
+    const auto results = TrackingReplayEngine::runParallel(files, ballModel, parser.isSet(globalAssignmentOption), jobs);
 
-    std::cout <<flyCount<<std::endl;
+    bool allSuccessful = true;
+    std::cout << TrackingReplayStatistics::csvHeader().toStdString() << std::endl;
+    for (const TrackingReplayStatistics &stats : results) {
+        std::cout << stats.toCsv().toStdString() << std::endl;
+        allSuccessful = allSuccessful && stats.success;
+    }
 
-    return 0;
+    return allSuccessful ? 0 : 1;
 }
@@ -0,0 +1,277 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "trackingreplayengine.h"
+
+#include "core/timer.h"
+#include "protobuf/ssl_wrapper.pb.h"
+#include "seshat/seqlogfilereader.h"
+#include "tracking/tracker.h"
+#include "tracking/worldparameters.h"
+#include <QDirIterator>
+#include <QFileInfo>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+static const QString VISION_SENDER_NAME = "replay";
+
+QString TrackingReplayStatistics::csvHeader()
+{
+    return "\"log\",\"status\",\"vision_frames\",\"tracking_frames\",\"resets\",\"flights\","
+           "\"max_ball_filters\",\"avg_ball_filters\",\"max_robot_filters\",\"avg_robot_filters\","
+           "\"ball_spawned_per_min\",\"ball_invalidated_per_min\",\"robot_spawned_per_min\",\"robot_invalidated_per_min\","
+           "\"total_tracking_s\",\"avg_frame_ms\",\"p99_frame_ms\",\"max_frame_ms\",\"error\"";
+}
+
+QString TrackingReplayStatistics::toCsv() const
+{
+    return QString("\"%1\",%2,%3,%4,%5,%6,%7,%8,%9,%10,%11,%12,%13,%14,%15,%16,%17,%18,\"%19\"")
+            .arg(logFile)
+            .arg(statusCount)
+            .arg(visionFrameCount)
+            .arg(trackingFrameCount)
+            .arg(trackingResets)
+            .arg(flightDetections)
+            .arg(maxBallFilters)
+            .arg(averageBallFilters)
+            .arg(maxRobotFilters)
+            .arg(averageRobotFilters)
+            .arg(ballFiltersSpawnedPerMinute)
+            .arg(ballFiltersInvalidatedPerMinute)
+            .arg(robotFiltersSpawnedPerMinute)
+            .arg(robotFiltersInvalidatedPerMinute)
+            .arg(totalTrackingTime * 1E-9)
+            .arg(averageFrameTime() * 1E-6)
+            .arg(p99FrameTime * 1E-6)
+            .arg(maxFrameTime * 1E-6)
+            .arg(errorMsg);
+}
+
+TrackingReplayEngine::TrackingReplayEngine(const world::BallModel &defaultBallModel, bool globalAssignment) :
+    m_defaultBallModel(defaultBallModel),
+    m_globalAssignment(globalAssignment),
+    m_worldParameters(new WorldParameters(false, true))
+{
+    reset();
+}
+
+TrackingReplayEngine::~TrackingReplayEngine() = default;
+
+void TrackingReplayEngine::reset()
+{
+    if (m_tracker) {
+        const Tracker::FilterStatistics &stats = m_tracker->filterStatistics();
+        m_previousFilterStatistics.ballFiltersSpawned += stats.ballFiltersSpawned;
+        m_previousFilterStatistics.ballFiltersInvalidated += stats.ballFiltersInvalidated;
+        m_previousFilterStatistics.robotFiltersSpawned += stats.robotFiltersSpawned;
+        m_previousFilterStatistics.robotFiltersInvalidated += stats.robotFiltersInvalidated;
+    }
+
+    // the tracker keeps its ball model and transmission delay across resets, start from scratch instead
+    m_tracker.reset(new Tracker(false, false, m_worldParameters.get()));
+    m_tracker->setBallModel(m_defaultBallModel);
+
+    amun::CommandTracking command;
+    command.set_global_assignment(m_globalAssignment);
+    m_tracker->handleCommand(command, 0);
+    m_worldParameters->reset();
+    m_lastTime = 0;
+    m_wasFlying = false;
+}
+
+TrackingReplayStatistics TrackingReplayEngine::run(const QString &filename)
+{
+    TrackingReplayStatistics stats;
+    stats.logFile = filename;
+
+    reset();
+    m_ballFilterSum = 0;
+    m_robotFilterSum = 0;
+    m_previousFilterStatistics = Tracker::FilterStatistics();
+    m_replayedTime = 0;
+
+    SeqLogFileReader reader;
+    if (!reader.open(filename)) {
+        stats.errorMsg = reader.errorMsg();
+        return stats;
+    }
+
+    std::vector<qint64> frameTimes;
+    while (!reader.atEnd()) {
+        const Status status = reader.readStatus();
+        if (status.isNull()) {
+            // the reader does not advance past a corrupt group
+            stats.errorMsg = reader.errorMsg().isEmpty() ? QString("Could not read status %1").arg(stats.statusCount)
+                                                         : reader.errorMsg();
+            break;
+        }
+        handleStatus(status, stats, frameTimes);
+    }
+    // include the statistics of the last tracker
+    reset();
+
+    if (stats.trackingFrameCount > 0) {
+        stats.averageBallFilters = double(m_ballFilterSum) / stats.trackingFrameCount;
+        stats.averageRobotFilters = double(m_robotFilterSum) / stats.trackingFrameCount;
+
+        const std::size_t p99Index = std::min(frameTimes.size() - 1, frameTimes.size() * 99 / 100);
+        std::nth_element(frameTimes.begin(), frameTimes.begin() + p99Index, frameTimes.end());
+        stats.p99FrameTime = frameTimes[p99Index];
+    }
+
+    const double minutes = std::max(m_replayedTime, qint64(1)) / 60E9;
+    stats.ballFiltersSpawnedPerMinute = m_previousFilterStatistics.ballFiltersSpawned / minutes;
+    stats.ballFiltersInvalidatedPerMinute = m_previousFilterStatistics.ballFiltersInvalidated / minutes;
+    stats.robotFiltersSpawnedPerMinute = m_previousFilterStatistics.robotFiltersSpawned / minutes;
+    stats.robotFiltersInvalidatedPerMinute = m_previousFilterStatistics.robotFiltersInvalidated / minutes;
+
+    stats.success = stats.errorMsg.isEmpty();
+    return stats;
+}
+
+void TrackingReplayEngine::handleStatus(const Status &status, TrackingReplayStatistics &stats, std::vector<qint64> &frameTimes)
+{
+    stats.statusCount++;
+
+    if (status->has_geometry() && status->geometry().has_ball_model()) {
+        m_tracker->setBallModel(status->geometry().ball_model());
+    }
+
+    if (!status->has_world_state()) {
+        return;
+    }
+    const world::State &loggedState = status->world_state();
+    const qint64 time = loggedState.time();
+
+    // logs may be concatenated, the tracking can not go back in time
+    if (time < m_lastTime) {
+        reset();
+        stats.trackingResets++;
+    }
+    if (m_lastTime != 0) {
+        m_replayedTime += time - m_lastTime;
+    }
+    m_lastTime = time;
+
+    if (loggedState.has_vision_transmission_delay()) {
+        amun::CommandTracking command;
+        command.set_vision_transmission_delay(loggedState.vision_transmission_delay());
+        m_tracker->handleCommand(command, time);
+    }
+
+    for (int i = 0; i < loggedState.vision_frames_size(); i++) {
+        const SSL_WrapperPacket &wrapper = loggedState.vision_frames(i);
+        const qint64 visionTime = i < loggedState.vision_frame_times_size() ? loggedState.vision_frame_times(i) : time;
+
+        // camera calibrations are passed on directly instead of via the WorldParameters signal
+        if (wrapper.has_geometry()) {
+            for (const auto &calib : wrapper.geometry().calib()) {
+                m_tracker->updateCamera(calib, VISION_SENDER_NAME);
+            }
+        }
+        if (wrapper.has_detection()) {
+            m_tracker->queuePacket(wrapper.detection(), visionTime);
+            stats.visionFrameCount++;
+        }
+    }
+
+    const qint64 trackingStart = Timer::systemTime();
+    m_tracker->process(time);
+    world::State worldState;
+    m_tracker->worldState(&worldState, time, true);
+    const qint64 frameTime = Timer::systemTime() - trackingStart;
+
+    stats.trackingFrameCount++;
+    stats.totalTrackingTime += frameTime;
+    stats.maxFrameTime = std::max(stats.maxFrameTime, frameTime);
+    frameTimes.push_back(frameTime);
+
+    const int ballFilters = m_tracker->ballFilterCount();
+    const int robotFilters = m_tracker->robotFilterCount();
+    stats.maxBallFilters = std::max(stats.maxBallFilters, ballFilters);
+    stats.maxRobotFilters = std::max(stats.maxRobotFilters, robotFilters);
+    m_ballFilterSum += ballFilters;
+    m_robotFilterSum += robotFilters;
+
+    if (worldState.has_ball()) {
+        const bool flying = worldState.ball().p_z() != 0.0f;
+        if (flying && !m_wasFlying) {
+            stats.flightDetections++;
+        }
+        m_wasFlying = flying;
+    }
+
+    // the logged radio commands were generated after tracking this world state,
+    // they take effect in the tracking after the radio command delay
+    if (status->radio_command_size() > 0) {
+        const qint64 commandDelay = std::max<qint64>(loggedState.radio_command_delay(), 1);
+        const QList<robot::RadioCommand> commands(status->radio_command().begin(), status->radio_command().end());
+        m_tracker->queueRadioCommands(commands, time + commandDelay);
+    }
+}
+
+QStringList TrackingReplayEngine::collectLogFiles(const QStringList &paths)
+{
+    QStringList result;
+    for (const QString &path : paths) {
+        const QFileInfo info(path);
+        if (!info.isDir()) {
+            result.append(path);
+            continue;
+        }
+
+        QStringList directoryFiles;
+        QDirIterator it(path, {"*.log"}, QDir::Files, QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
+        while (it.hasNext()) {
+            directoryFiles.append(it.next());
+        }
+        // keep the output stable between runs
+        directoryFiles.sort();
+        result.append(directoryFiles);
+    }
+    return result;
+}
+
+std::vector<TrackingReplayStatistics> TrackingReplayEngine::runParallel(const QStringList &files, const world::BallModel &defaultBallModel,
+                                                                       bool globalAssignment, int threadCount)
+{
+    std::vector<TrackingReplayStatistics> results(files.size());
+    std::atomic<int> nextFile(0);
+
+    auto worker = [&]() {
+        TrackingReplayEngine engine(defaultBallModel, globalAssignment);
+        for (int i = nextFile++; i < files.size(); i = nextFile++) {
+            results[i] = engine.run(files[i]);
+        }
+    };
+
+    threadCount = std::max(1, std::min(threadCount, int(files.size())));
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (int i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return results;
+}
@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   Robotics Erlangen e.V.                                                *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef TRACKINGREPLAYENGINE_H
+#define TRACKINGREPLAYENGINE_H
+
+#include "protobuf/status.h"
+#include "protobuf/world.pb.h"
+#include "tracking/tracker.h"
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <vector>
+
+class WorldParameters;
+
+struct TrackingReplayStatistics
+{
+    QString logFile;
+    bool success = false;
+    QString errorMsg;
+
+    qint64 statusCount = 0;
+    qint64 visionFrameCount = 0;
+    // number of tracker iterations, one per logged world state
+    qint64 trackingFrameCount = 0;
+    int trackingResets = 0;
+
+    int flightDetections = 0;
+
+    int maxBallFilters = 0;
+    double averageBallFilters = 0;
+    int maxRobotFilters = 0;
+    double averageRobotFilters = 0;
+    double ballFiltersSpawnedPerMinute = 0;
+    double ballFiltersInvalidatedPerMinute = 0;
+    double robotFiltersSpawnedPerMinute = 0;
+    double robotFiltersInvalidatedPerMinute = 0;
+
+    // tracking time per frame, in nanoseconds
+    qint64 totalTrackingTime = 0;
+    qint64 maxFrameTime = 0;
+    qint64 p99FrameTime = 0;
+
+    double averageFrameTime() const { return trackingFrameCount > 0 ? double(totalTrackingTime) / trackingFrameCount : 0; }
+
+    static QString csvHeader();
+    QString toCsv() const;
+};
+
+// Replays the vision data of a log through a standalone tracker.
+// Unlike TrackingReplay no Processor, event loop or signals are involved,
+// the log is read sequentially and processed as fast as possible.
+// Every instance is independent, thus multiple logs can be processed in parallel
+// by using one engine per thread.
+class TrackingReplayEngine
+{
+public:
+    TrackingReplayEngine(const world::BallModel &defaultBallModel, bool globalAssignment);
+    ~TrackingReplayEngine();
+    TrackingReplayEngine(const TrackingReplayEngine&) = delete;
+    TrackingReplayEngine& operator=(const TrackingReplayEngine&) = delete;
+
+    TrackingReplayStatistics run(const QString &filename);
+
+    // finds all log files in the given files and directories (recursively)
+    static QStringList collectLogFiles(const QStringList &paths);
+    // processes all files with the given number of threads, the result order matches the input order
+    static std::vector<TrackingReplayStatistics> runParallel(const QStringList &files, const world::BallModel &defaultBallModel,
+                                                             bool globalAssignment, int threadCount);
+
+private:
+    void reset();
+    void handleStatus(const Status &status, TrackingReplayStatistics &stats, std::vector<qint64> &frameTimes);
+
+private:
+    const world::BallModel m_defaultBallModel;
+    const bool m_globalAssignment;
+    std::unique_ptr<WorldParameters> m_worldParameters;
+    std::unique_ptr<Tracker> m_tracker;
+
+    qint64 m_lastTime = 0;
+    // log time covered by the replay, excluding jumps between concatenated logs
+    qint64 m_replayedTime = 0;
+    bool m_wasFlying = false;
+    qint64 m_ballFilterSum = 0;
+    qint64 m_robotFilterSum = 0;
+    // filter statistics of trackers that were replaced due to a reset
+    Tracker::FilterStatistics m_previousFilterStatistics;
+};
+
+#endif // TRACKINGREPLAYENGINE_H